@@ -64,6 +64,34 @@ function handleConfiguration() {
         }
     });
 
+    $("#deep_sleep").submit((event) => {
+        event.preventDefault();
+        if ($("#deep_sleep")[0].checkValidity()) {
+            setDeepSleep().then(() => clearMessage());
+        }
+    });
+
+    $("#source").submit((event) => {
+        event.preventDefault();
+        if ($("#source")[0].checkValidity()) {
+            setSource().then(() => clearMessage());
+        }
+    });
+
+    $("#archive").submit((event) => {
+        event.preventDefault();
+        if ($("#archive")[0].checkValidity()) {
+            setArchive().then(() => clearMessage());
+        }
+    });
+
+    $("#uplink").submit((event) => {
+        event.preventDefault();
+        if ($("#uplink")[0].checkValidity()) {
+            setUplink().then(() => clearMessage());
+        }
+    });
+
     $("#access_point").submit((event) => {
         event.preventDefault();
         if ($("#access_point")[0].checkValidity()) {
@@ -128,7 +156,8 @@ function setAtmosphere() {
 function setWindSpeed() {
     var cfg = {
         wind_speed: {
-            radius: parseFloat($("#wind_speed_radius").prop("value"))
+            radius: parseFloat($("#wind_speed_radius").prop("value")),
+            cadence: parseInt($("#wind_speed_cadence").prop("value"), 10)
         }
     };
     return setConfiguration(cfg);
@@ -170,6 +199,54 @@ function setRainIntensity() {
     return setConfiguration(cfg);
 }
 
+function setDeepSleep() {
+    var cfg = {
+        deep_sleep: {
+            enabled: $("#deep_sleep_enabled").prop("checked"),
+            interval: parseInt($("#deep_sleep_interval").prop("value"), 10),
+            window: parseInt($("#deep_sleep_window").prop("value"), 10),
+            awake: parseInt($("#deep_sleep_awake").prop("value"), 10),
+            online: parseInt($("#deep_sleep_online").prop("value"), 10)
+        }
+    };
+    return setConfiguration(cfg);
+}
+
+function setSource() {
+    var cfg = {
+        source: {
+            type: $("#source_type").prop("value"),
+            file: $("#source_file").prop("value"),
+            speed: parseInt($("#source_speed").prop("value"), 10)
+        }
+    };
+    return setConfiguration(cfg);
+}
+
+function setArchive() {
+    var cfg = {
+        archive: {
+            enabled: $("#archive_enabled").prop("checked"),
+            retention: parseInt($("#archive_retention").prop("value"), 10)
+        }
+    };
+    return setConfiguration(cfg);
+}
+
+function setUplink() {
+    var cfg = {
+        uplink: {
+            enabled: $("#uplink_enabled").prop("checked"),
+            protocol: $("#uplink_protocol").prop("value"),
+            url: $("#uplink_url").prop("value"),
+            topic: $("#uplink_topic").prop("value"),
+            batch: parseInt($("#uplink_batch").prop("value"), 10),
+            interval: parseInt($("#uplink_interval").prop("value"), 10)
+        }
+    };
+    return setConfiguration(cfg);
+}
+
 function setAccessPoint() {
     var cfg = {
         access_point: {
@@ -269,6 +346,27 @@ function getConfiguration() {
             $("#pressure_factor").prop("value", cfg.pressure.factor.toFixed(3));
 
             $("#wind_speed_radius").prop("value", cfg.wind_speed.radius.toFixed(2));
+            $("#wind_speed_cadence").prop("value", cfg.wind_speed.cadence);
+
+            $("#deep_sleep_enabled").prop("checked", cfg.deep_sleep.enabled);
+            $("#deep_sleep_interval").prop("value", cfg.deep_sleep.interval);
+            $("#deep_sleep_window").prop("value", cfg.deep_sleep.window);
+            $("#deep_sleep_awake").prop("value", cfg.deep_sleep.awake);
+            $("#deep_sleep_online").prop("value", cfg.deep_sleep.online);
+
+            $("#source_type").prop("value", cfg.source.type);
+            $("#source_file").prop("value", cfg.source.file);
+            $("#source_speed").prop("value", cfg.source.speed);
+
+            $("#archive_enabled").prop("checked", cfg.archive.enabled);
+            $("#archive_retention").prop("value", cfg.archive.retention);
+
+            $("#uplink_enabled").prop("checked", cfg.uplink.enabled);
+            $("#uplink_protocol").prop("value", cfg.uplink.protocol);
+            $("#uplink_url").prop("value", cfg.uplink.url);
+            $("#uplink_topic").prop("value", cfg.uplink.topic);
+            $("#uplink_batch").prop("value", cfg.uplink.batch);
+            $("#uplink_interval").prop("value", cfg.uplink.interval);
 
             {
                 var template = $($.parseHTML($("#wind_direction_template").html()));
@@ -36,6 +36,7 @@ function handleDownload() {
     const params = new URLSearchParams({
         start: `${$("#filter_start_date").val()} ${$("#filter_start_time").val()}`,
         end: `${$("#filter_end_date").val()} ${$("#filter_end_time").val()}`,
+        resolution: $("#filter_resolution").val(),
     })
     window.location = `/data.csv?${params}`;
 }
@@ -84,6 +85,7 @@ async function loadCSV() {
         const params = new URLSearchParams({
 			start: `${$("#filter_start_date").val()} ${$("#filter_start_time").val()}`,
 			end: `${$("#filter_end_date").val()} ${$("#filter_end_time").val()}`,
+			resolution: $("#filter_resolution").val(),
 		});
 		
 		const response = await fetch(`http://${window.location.host || "192.168.1.200"}/data.csv?${params}`);
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <Arduino.h>
+
+namespace Analog
+{
+    auto init() -> void;
+    auto windDirection() -> uint16_t;
+    auto rainIntensity() -> uint16_t;
+} // namespace Analog
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <Arduino.h>
+#include <chrono>
+
+namespace Atmosphere
+{
+    auto init() -> bool;
+    auto process() -> void;
+    auto trigger() -> bool;
+    auto collect() -> bool;
+    auto conversion() -> std::chrono::milliseconds;
+
+    auto temperature() -> float;
+    auto humidity() -> float;
+    auto pressure() -> float;
+} // namespace Atmosphere
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.hpp>
+#include <functional>
+#include <future>
+
+namespace Boot
+{
+    auto step( const char* name, const std::function<void()>& func ) -> void;
+    auto background( const char* name, std::function<void()> func ) -> std::future<void>;
+    auto mark( const char* name ) -> void;
+    auto report() -> void;
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void;
+} // namespace Boot
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <Arduino.h>
+#include <functional>
+
+namespace Bus
+{
+    auto init() -> void;
+    auto process() -> void;
+    auto submit( std::function<void()> job ) -> void;
+    auto write( uint8_t address, uint8_t reg, uint8_t value ) -> bool;
+    auto read( uint8_t address, uint8_t reg, uint8_t* data, std::size_t length ) -> bool;
+    auto error() -> void;
+    auto errors() -> uint32_t;
+} // namespace Bus
\ No newline at end of file
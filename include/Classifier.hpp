@@ -0,0 +1,42 @@
+#pragma once
+
+#include <Arduino.h>
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Configuration.hpp"
+
+namespace Classifier
+{
+    static constexpr auto RESOLUTION = std::size_t{4096};
+
+    // Índice = leitura do ADC, valor = classe + 1 (0 = fora de qualquer faixa)
+    using Table = std::array<uint8_t, RESOLUTION>;
+
+    template<typename Threshoulds>
+    constexpr auto compile( const Threshoulds& threshoulds ) -> Table
+    {
+        auto table = Table{};
+        for ( const auto& [value, threshould] : threshoulds )
+        {
+            const auto last = std::min<std::size_t>( threshould.second, RESOLUTION - 1 );
+            for ( auto n = std::size_t{threshould.first}; n <= last; n++ )
+            {
+                if ( table[n] == 0 )
+                {
+                    table[n] = static_cast<uint8_t>( value ) + 1;
+                }
+            }
+        }
+        return table;
+    }
+
+    auto load( const Configuration& cfg ) -> void;
+    auto validate( const Configuration& cfg ) -> std::vector<std::string>;
+
+    auto windDirection( uint16_t value ) -> std::optional<::WindDirection>;
+    auto rainIntensity( uint16_t value ) -> std::optional<::RainIntensity>;
+} // namespace Classifier
\ No newline at end of file
@@ -3,8 +3,10 @@
 #include <Arduino.h>
 
 #include <ArduinoJson.hpp>
+#include <algorithm>
 #include <array>
-#include <map>
+#include <memory>
+#include <string_view>
 
 enum class WindDirection 
 {
@@ -24,6 +26,52 @@ enum class RainIntensity {
     RAINY = 2,
 };
 
+enum class SensorSource {
+    HARDWARE  = 0,
+    SYNTHETIC = 1,
+    REPLAY    = 2,
+};
+
+enum class UplinkProtocol {
+    HTTP = 0,
+    MQTT = 1,
+};
+
+// Texto com capacidade fixa (N inclui o terminador), trunca o que não couber
+template<std::size_t N>
+class FixedString
+{
+    public:
+        constexpr FixedString() = default;
+        constexpr FixedString( const char* text ) { assign( text ); }
+        constexpr FixedString( std::string_view text ) { assign( text ); }
+
+        constexpr auto operator=( const char* text ) -> FixedString& { assign( text ); return *this; }
+        constexpr auto operator=( std::string_view text ) -> FixedString& { assign( text ); return *this; }
+
+        constexpr auto assign( std::string_view text ) -> void
+        {
+            length = std::min( text.size(), N - 1 );
+            for ( auto n = std::size_t{0}; n < N; n++ )
+            {
+                buffer[n] = n < length ? text[n] : '\0';
+            }
+        }
+
+        constexpr auto data() const -> const char* { return buffer.data(); }
+        constexpr auto c_str() const -> const char* { return buffer.data(); }
+        constexpr auto size() const -> std::size_t { return length; }
+        constexpr auto empty() const -> bool { return length == 0; }
+        constexpr operator std::string_view() const { return { buffer.data(), length }; }
+
+        friend constexpr auto operator==( const FixedString& a, const FixedString& b ) -> bool { return std::string_view{a} == std::string_view{b}; }
+        friend constexpr auto operator!=( const FixedString& a, const FixedString& b ) -> bool { return not ( a == b ); }
+
+    private:
+        std::array<char, N> buffer{};
+        std::size_t length{0};
+};
+
 struct Configuration
 {
     struct Station
@@ -34,8 +82,8 @@ struct Configuration
         std::array<uint8_t, 4> netmask;
         std::array<uint8_t, 4> gateway;
         uint16_t port;
-        std::string user;
-        std::string password;
+        FixedString<33> user;
+        FixedString<65> password;
     };
 
     struct AccessPoint
@@ -46,8 +94,8 @@ struct Configuration
         std::array<uint8_t, 4> netmask;
         std::array<uint8_t, 4> gateway;
         uint16_t port;
-        std::string user;
-        std::string password;
+        FixedString<33> user;
+        FixedString<65> password;
         uint16_t duration;
     };
 
@@ -69,16 +117,88 @@ struct Configuration
     struct WindSpeed
     {
         float radius;
+        uint16_t cadence;
     };
 
     struct WindDirection
     {
-        std::map<::WindDirection, std::pair<uint16_t, uint16_t>> threshoulds;
+        // Na ordem do enum, como o JSON e o formulário sempre apresentaram
+        using Threshoulds = std::array<std::pair<::WindDirection, std::pair<uint16_t, uint16_t>>, 8>;
+
+        static constexpr Threshoulds defaults
+        {{
+            {::WindDirection::NORTH,     {3094, 3420}},
+            {::WindDirection::SOUTH,     {518, 572}},
+            {::WindDirection::EAST,      {2508, 2772}},
+            {::WindDirection::WEST,      {1078, 1192}},
+            {::WindDirection::NORTHEAST, {3809, 4095}},
+            {::WindDirection::SOUTHEAST, {1222, 1351}},
+            {::WindDirection::SOUTHWEST, {47, 52}},
+            {::WindDirection::NORTHWEST, {1966, 2173}},
+        }};
+
+        Threshoulds threshoulds;
     };
 
     struct RainIntensity
     {
-        std::map<::RainIntensity, std::pair<uint16_t, uint16_t>> threshoulds;
+        using Threshoulds = std::array<std::pair<::RainIntensity, std::pair<uint16_t, uint16_t>>, 3>;
+
+        static constexpr Threshoulds defaults
+        {{
+            {::RainIntensity::DRY,   {   0, 1000}},
+            {::RainIntensity::HUMID, {1001, 2000}},
+            {::RainIntensity::RAINY, {2001, 4095}},
+        }};
+
+        Threshoulds threshoulds;
+    };
+
+    struct DeepSleep
+    {
+        static constexpr auto MAX_INTERVAL = uint16_t{3600};
+        static constexpr auto MAX_WINDOW = uint16_t{43200};
+        static constexpr auto MIN_AWAKE = uint16_t{10};
+        static constexpr auto MAX_AWAKE = uint16_t{3600};
+
+        bool enabled;
+        uint16_t interval;
+        uint16_t window;
+        uint16_t awake;
+        uint16_t online;
+
+        // Período zero divide por zero no Sleep a cada despertar, a janela é um múltiplo inteiro do período
+        constexpr auto limit() -> void
+        {
+            interval = std::clamp<uint16_t>( interval, 1, MAX_INTERVAL );
+            window = std::clamp<uint16_t>( window, interval, MAX_WINDOW );
+            window -= window % interval;
+            awake = std::clamp<uint16_t>( awake, MIN_AWAKE, MAX_AWAKE );
+            online = std::min<uint16_t>( online, MAX_AWAKE );
+        }
+    };
+
+    struct Source
+    {
+        SensorSource type;
+        FixedString<65> file;
+        uint16_t speed;
+    };
+
+    struct Archive
+    {
+        bool enabled;
+        uint16_t retention;
+    };
+
+    struct Uplink
+    {
+        bool enabled;
+        UplinkProtocol protocol;
+        FixedString<97> url;
+        FixedString<65> topic;
+        uint16_t batch;
+        uint16_t interval;
     };
 
     Station station;
@@ -89,13 +209,26 @@ struct Configuration
     WindSpeed windSpeed;
     WindDirection windDirection;
     RainIntensity rainIntensity;
+    DeepSleep deepSleep;
+    Source source;
+    Archive archive;
+    Uplink uplink;
+
+    // Leitores usam a versão vigente inteira, alterações publicam uma nova
+    class Snapshot
+    {
+        public:
+            auto get() const -> std::shared_ptr<const Configuration>;
+            auto operator->() const -> std::shared_ptr<const Configuration>;
+    };
 
     static auto init() -> void;
-    static auto load( Configuration* cfg ) -> void;
+    static auto load() -> void;
     static auto save( const Configuration& cfg ) -> void;
+    static auto publish( const Configuration& cfg ) -> void;
 
     auto serialize( ArduinoJson::JsonVariant& json ) const -> void;
     auto deserialize( const ArduinoJson::JsonVariant& json ) -> void;
 };
 
-extern Configuration cfg;
\ No newline at end of file
+extern const Configuration::Snapshot cfg;
\ No newline at end of file
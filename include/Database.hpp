@@ -6,19 +6,34 @@
 #include <chrono>
 #include <sqlite3.h>
 #include <optional>
+#include <array>
+#include <cstdio>
+#include <memory>
+#include <vector>
 
 #include "Configuration.hpp"
 #include "Infos.hpp"
 
 namespace Database
 {
+    enum class Resolution
+    {
+        AGGREGATE,
+        RAW,
+    };
+
     class Filter
     {
         private:
             sqlite3_stmt* res = nullptr;
             uint32_t count = 0;
+            uint32_t limit = 0;
+            std::time_t cursor = 0;
+            std::time_t end = 0;
+            std::time_t split = 0;
+            Resolution resolution = Resolution::AGGREGATE;
         public:
-            Filter( std::chrono::system_clock::time_point start, std::chrono::system_clock::time_point end, uint32_t limit );
+            Filter( std::chrono::system_clock::time_point start, std::chrono::system_clock::time_point end, uint32_t limit, Resolution resolution = Resolution::AGGREGATE );
             Filter( Filter& ) = delete;
             Filter( Filter&& );
             ~Filter();
@@ -26,6 +41,69 @@ namespace Database
             auto next() -> std::optional<Infos::SensorData>;
     };
 
+    class Accumulator
+    {
+        private:
+            uint32_t count = 0;
+            float temperature = 0.0f;
+            float humidity = 0.0f;
+            float pressure = 0.0f;
+            float windSpeed = 0.0f;
+            float windGust = 0.0f;
+            float windX = 0.0f;
+            float windY = 0.0f;
+            float unitX = 0.0f;
+            float unitY = 0.0f;
+            std::array<uint16_t, 8> directions = {};
+        public:
+            auto add( const Infos::SensorData& sample ) -> void;
+            auto result( const Infos::SensorData& current ) const -> Infos::SensorData;
+            auto size() const -> uint32_t;
+    };
+
     auto init() -> void;
     auto process() -> void;
+    auto insert( const Infos::SensorData& sensorData ) -> void;
+    auto archive( const std::vector<Infos::SensorData>& samples ) -> void;
+    auto aggregate( const Infos::SensorData& current, const std::vector<Infos::SensorData>& samples ) -> Infos::SensorData;
+    auto cleanup() -> void;
+    auto erase( std::time_t start, std::time_t end ) -> void;
+    auto newest() -> std::time_t;
+
+    // Cópia consistente do banco feita aos poucos no loop, entre as inserções
+    namespace Backup
+    {
+        enum class State
+        {
+            IDLE,
+            PENDING,
+            RUNNING,
+            DONE,
+            FAILED,
+        };
+
+        auto request() -> void;
+        auto state() -> State;
+        auto open() -> std::shared_ptr<FILE>;
+        auto serialize( ArduinoJson::JsonVariant& json ) -> void;
+    } // namespace Backup
+
+    // Último registro confirmado pelo sistema central, sobrevive a quedas e reinícios
+    // Marcado pela coluna SEQUENCE (INTEGER PRIMARY KEY AUTOINCREMENT): crescente na ordem de inserção,
+    // nunca reaproveitada e mantida pelo VACUUM e pela cópia de segurança; registros atrasados também saem
+    namespace Uplink
+    {
+        struct Mark
+        {
+            int64_t sequence;
+            std::time_t dateTime;
+        };
+
+        auto mark() -> Mark;
+        auto advance( const Mark& mark ) -> void;
+        auto pending( const Mark& mark ) -> uint32_t;
+        auto regressed( const Mark& mark ) -> bool;
+        auto resync( const Mark& mark ) -> Mark;
+        auto collect( const Mark& mark, uint16_t limit, const std::function<bool( int64_t, const Infos::SensorData& )>& sink ) -> void;
+    } // namespace Uplink
 } // namespace Database
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Arduino.h>
+#include <array>
+#include <cstdint>
+#include <mbedtls/sha256.h>
+
+// Atualização diferencial: a imagem nova é refeita a partir da partição em execução mais o patch
+namespace Delta
+{
+    using Digest = std::array<uint8_t, 32>;
+
+    static constexpr std::array<uint8_t, 4> MAGIC{ 'W', 'D', 'P', '1' };
+
+    // Patch sequencial no estilo bsdiff: cabeçalho e depois entradas (diff, extra, seek) até completar o tamanho
+    class Patcher
+    {
+        public:
+            using Source = bool ( * )( uint32_t offset, uint8_t* data, std::size_t length );
+            using Sink = bool ( * )( const uint8_t* data, std::size_t length );
+
+        private:
+            enum class State
+            {
+                HEADER,
+                CONTROL,
+                DIFF,
+                EXTRA,
+                DONE,
+                FAILED,
+            };
+
+            // MAGIC, tamanho final, digest da origem e digest do resultado
+            static constexpr auto HEADER_SIZE = MAGIC.size() + sizeof( uint32_t ) + 2 * sizeof( Digest );
+            static constexpr auto CHUNK = std::size_t{256};
+
+            Source source;
+            Sink sink;
+            Digest running;
+            State state = State::HEADER;
+            const char* reason = nullptr;
+            std::array<uint8_t, HEADER_SIZE> header = {};
+            std::size_t filled = 0;
+            uint32_t size = 0;
+            Digest target = {};
+            std::array<uint64_t, 3> control = {};
+            std::size_t field = 0;
+            uint8_t shift = 0;
+            uint32_t diff = 0;
+            uint32_t extra = 0;
+            int64_t seek = 0;
+            int64_t position = 0;
+            uint32_t produced = 0;
+            std::array<uint8_t, CHUNK> scratch = {};
+            mbedtls_sha256_context sha = {};
+
+            auto fail( const char* reason ) -> void;
+            auto emit( const uint8_t* data, std::size_t length ) -> bool;
+            auto parse() -> void;
+            auto next() -> void;
+            auto verify() -> void;
+        public:
+            Patcher( const Digest& running, Source source, Sink sink );
+            ~Patcher();
+
+            auto write( const uint8_t* data, std::size_t length ) -> bool;
+            auto done() const -> bool;
+            auto error() const -> const char*;
+            auto written() const -> uint32_t;
+    };
+} // namespace Delta
\ No newline at end of file
@@ -1,30 +1,44 @@
 #pragma once
 
-#include <cstdint>
-
-extern const uint8_t configuration_html_start[] asm( "_binary_html_configuration_html_start" );
-extern const uint8_t configuration_html_end[] asm( "_binary_html_configuration_html_end" );
-
-extern const uint8_t configuration_js_start[] asm( "_binary_html_configuration_js_start" );
-extern const uint8_t configuration_js_end[] asm( "_binary_html_configuration_js_end" );
-
-extern const uint8_t data_html_start[] asm( "_binary_html_data_html_start" );
-extern const uint8_t data_html_end[] asm( "_binary_html_data_html_end" );
-
-extern const uint8_t data_js_start[] asm( "_binary_html_data_js_start" );
-extern const uint8_t data_js_end[] asm( "_binary_html_data_js_end" );
+// Gerado por tools/assets.py a partir de html/, não editar
 
-extern const uint8_t jquery_min_js_gz_start[] asm( "_binary_html_jquery_min_js_gz_start" );
-extern const uint8_t jquery_min_js_gz_end[] asm( "_binary_html_jquery_min_js_gz_end" );
-
-extern const uint8_t chart_min_js_gz_start[] asm("_binary_html_chart_min_js_gz_start");
-extern const uint8_t chart_min_js_gz_end[] asm("_binary_html_chart_min_js_gz_end");
-
-extern const uint8_t infos_html_start[] asm( "_binary_html_infos_html_start" );
-extern const uint8_t infos_html_end[] asm( "_binary_html_infos_html_end" );
-
-extern const uint8_t infos_js_start[] asm( "_binary_html_infos_js_start" );
-extern const uint8_t infos_js_end[] asm( "_binary_html_infos_js_end" );
+#include <array>
+#include <cstdint>
 
-extern const uint8_t style_css_start[] asm( "_binary_html_style_css_start" );
-extern const uint8_t style_css_end[] asm( "_binary_html_style_css_end" );
\ No newline at end of file
+extern const uint8_t configuration_html_gz_start[] asm( "_binary_html_dist_configuration_html_gz_start" );
+extern const uint8_t configuration_html_gz_end[] asm( "_binary_html_dist_configuration_html_gz_end" );
+
+extern const uint8_t data_html_gz_start[] asm( "_binary_html_dist_data_html_gz_start" );
+extern const uint8_t data_html_gz_end[] asm( "_binary_html_dist_data_html_gz_end" );
+
+extern const uint8_t infos_html_gz_start[] asm( "_binary_html_dist_infos_html_gz_start" );
+extern const uint8_t infos_html_gz_end[] asm( "_binary_html_dist_infos_html_gz_end" );
+
+extern const uint8_t chart_min_js_gz_start[] asm( "_binary_html_dist_chart_min_js_gz_start" );
+extern const uint8_t chart_min_js_gz_end[] asm( "_binary_html_dist_chart_min_js_gz_end" );
+
+extern const uint8_t jquery_min_js_gz_start[] asm( "_binary_html_dist_jquery_min_js_gz_start" );
+extern const uint8_t jquery_min_js_gz_end[] asm( "_binary_html_dist_jquery_min_js_gz_end" );
+
+namespace Files
+{
+    // Todos os arquivos vão comprimidos, servidos com Content-Encoding: gzip
+    struct Asset
+    {
+        const char* path;
+        const char* route;
+        const char* type;
+        const uint8_t* start;
+        const uint8_t* end;
+    };
+
+    inline constexpr auto ASSETS = std::array<Asset, 6>
+    {{
+        {"/", "GET /", "text/html", infos_html_gz_start, infos_html_gz_end},
+        {"/configuration.html", "GET /configuration.html", "text/html", configuration_html_gz_start, configuration_html_gz_end},
+        {"/data.html", "GET /data.html", "text/html", data_html_gz_start, data_html_gz_end},
+        {"/infos.html", "GET /infos.html", "text/html", infos_html_gz_start, infos_html_gz_end},
+        {"/chart.min.js", "GET /chart.min.js", "application/javascript", chart_min_js_gz_start, chart_min_js_gz_end},
+        {"/jquery.min.js", "GET /jquery.min.js", "application/javascript", jquery_min_js_gz_start, jquery_min_js_gz_end},
+    }};
+} // namespace Files
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <Arduino.h>
+#include <FastCRC.h>
+#include <array>
+#include <vector>
+
+// Janela do LZ77 em bits, cada fluxo ocupa 6 * 2^GZIP_WINDOW_BITS + 6 KiB
+#ifndef GZIP_WINDOW_BITS
+#define GZIP_WINDOW_BITS 12
+#endif
+
+static_assert( GZIP_WINDOW_BITS >= 9 and GZIP_WINDOW_BITS <= 15 );
+
+namespace Gzip
+{
+    // Compressão gzip incremental, a saída é lida aos pedaços conforme o cliente consome
+    class Deflater
+    {
+        private:
+            struct Token
+            {
+                uint16_t length;
+                uint16_t distance;
+            };
+
+            template<std::size_t N>
+            struct Tree
+            {
+                std::array<uint16_t, N> frequency;
+                std::array<uint16_t, N> code;
+                std::array<uint8_t, N> length;
+
+                auto build( uint8_t limit ) -> void;
+            };
+
+            static constexpr auto WINDOW = uint32_t{1} << GZIP_WINDOW_BITS;
+            static constexpr auto HASH_BITS = 10u;
+
+            // Tudo de tamanho fixo para o objeto caber num pool, só a saída cresce
+            std::array<uint8_t, 2 * WINDOW> ring;
+            std::array<uint16_t, WINDOW> chain;
+            std::array<uint32_t, 1u << HASH_BITS> head;
+            std::array<Token, WINDOW / 2> tokens;
+            std::size_t pending = 0;
+            std::vector<uint8_t> output;
+            Tree<286> literals = {};
+            Tree<30> distances = {};
+            Tree<19> lengths = {};
+            std::size_t offset = 0;
+            uint32_t position = 0;
+            uint32_t size = 0;
+            uint32_t bits = 0;
+            uint8_t count = 0;
+            uint32_t checksum = 0;
+            FastCRC32 crc = {};
+            bool finished = false;
+
+            auto at( uint32_t index ) const -> uint8_t;
+            auto hash( uint32_t index ) const -> uint32_t;
+            auto insert( uint32_t index ) -> void;
+            auto match( uint32_t* distance ) const -> uint32_t;
+            auto compress( bool final ) -> void;
+            auto block( bool final ) -> void;
+            auto put( uint32_t value, uint8_t length ) -> void;
+            auto code( uint32_t value, uint8_t length ) -> void;
+        public:
+            Deflater();
+
+            auto write( const uint8_t* data, std::size_t length ) -> void;
+            auto finish() -> void;
+            auto read( uint8_t* buffer, std::size_t maxLen ) -> std::size_t;
+            auto done() const -> bool;
+    };
+
+    // Descompressão gzip incremental com memória fixa, a entrada chega em pedaços de qualquer tamanho
+    class Inflater
+    {
+        public:
+            using Sink = bool ( * )( const uint8_t* data, std::size_t length );
+
+        private:
+            enum class State
+            {
+                HEADER,
+                BLOCK,
+                CODES,
+                STORED,
+                TRAILER,
+                DONE,
+                FAILED,
+            };
+
+            enum class Step
+            {
+                OK,
+                MORE,
+                ERROR,
+            };
+
+            struct Huffman
+            {
+                std::array<uint16_t, 16> count;
+                std::array<uint16_t, 288> symbol;
+
+                auto build( const uint8_t* lengths, std::size_t size ) -> int;
+            };
+
+            static constexpr auto WINDOW = std::size_t{1} << 15;
+            static constexpr auto STAGING = std::size_t{2048};
+
+            // Cada passo só é confirmado inteiro, faltando entrada volta ao início dele
+            std::array<uint8_t, STAGING> input;
+            std::size_t head = 0;
+            std::size_t tail = 0;
+            uint32_t bits = 0;
+            uint8_t count = 0;
+            std::array<uint8_t, WINDOW> window;
+            std::size_t position = 0;
+            std::size_t pending = 0;
+            Huffman literals = {};
+            Huffman distances = {};
+            uint32_t stored = 0;
+            uint32_t size = 0;
+            uint32_t checksum = 0;
+            FastCRC32 crc = {};
+            bool last = false;
+            State state = State::HEADER;
+            Sink sink;
+
+            auto need( uint8_t length ) -> bool;
+            auto take( uint8_t length ) -> uint32_t;
+            auto decode( const Huffman& huffman ) -> int;
+            auto emit( uint8_t value ) -> void;
+            auto flush() -> bool;
+            auto inflate() -> Step;
+            auto header() -> Step;
+            auto block() -> Step;
+            auto codes() -> Step;
+            auto copy() -> Step;
+            auto trailer() -> Step;
+        public:
+            explicit Inflater( Sink sink );
+
+            auto write( const uint8_t* data, std::size_t length ) -> bool;
+            auto done() const -> bool;
+            auto decompressed() const -> uint32_t;
+    };
+} // namespace Gzip
\ No newline at end of file
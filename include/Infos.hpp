@@ -2,6 +2,9 @@
 
 #include <Arduino.h>
 #include <ArduinoJson.hpp>
+#include <chrono>
+#include <ctime>
+#include <optional>
 
 #include "Configuration.hpp"
 
@@ -14,8 +17,13 @@ namespace Infos
         float humidity;
         float pressure;
         float windSpeed;
+        float windGust;
         WindDirection windDirection;
         RainIntensity rainIntensity;
+        float windVector;
+        float windSteadiness;
+
+        static constexpr char HEADER[] = "datahora;temp;umid;pressao;vento;direcao;chuva;rajada;vetor;constancia\r\n";
 
         static auto get() -> SensorData;
         auto serialize ( ArduinoJson::JsonVariant& json ) const -> void;
@@ -24,4 +32,7 @@ namespace Infos
 
     auto init() -> void;
     auto process() -> void;
+    auto acquire( std::chrono::milliseconds gate ) -> SensorData;
+    auto gust() -> float;
+    auto clock() -> std::optional<std::time_t>;
 }
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Conexão da estação dirigida pelos eventos do Wi-Fi, reconectando direto no último ponto de acesso
+namespace Link
+{
+    enum class State : uint8_t
+    {
+        IDLE,
+        CONNECTING,
+        CONNECTED,
+        BACKOFF,
+    };
+
+    enum class Event : uint8_t
+    {
+        START,
+        STOP,
+        ASSOCIATED,
+        GOT_IP,
+        LOST,
+        TIMEOUT,
+        RETRY,
+    };
+
+    // Tabela pura, sem hardware, para poder ser verificada no host
+    inline constexpr auto TRANSITIONS = std::array<std::array<State, 7>, 4>
+    {{
+        //  START               STOP          ASSOCIATED           GOT_IP              LOST                TIMEOUT             RETRY
+        {{ State::CONNECTING, State::IDLE, State::IDLE,       State::IDLE,      State::IDLE,       State::IDLE,       State::IDLE       }}, // IDLE
+        {{ State::CONNECTING, State::IDLE, State::CONNECTING, State::CONNECTED, State::BACKOFF,    State::BACKOFF,    State::CONNECTING }}, // CONNECTING
+        {{ State::CONNECTING, State::IDLE, State::CONNECTED,  State::CONNECTED, State::CONNECTING, State::CONNECTED,  State::CONNECTED  }}, // CONNECTED
+        {{ State::CONNECTING, State::IDLE, State::BACKOFF,    State::CONNECTED, State::BACKOFF,    State::BACKOFF,    State::CONNECTING }}, // BACKOFF
+    }};
+
+    constexpr auto next( State state, Event event ) -> State
+    {
+        return TRANSITIONS[static_cast<std::size_t>( state )][static_cast<std::size_t>( event )];
+    }
+
+    auto init() -> void;
+    auto start() -> void;
+    auto stop() -> void;
+    auto process() -> void;
+    auto state() -> State;
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void;
+} // namespace Link
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.hpp>
+#include <chrono>
+
+namespace Metrics
+{
+    using Route = std::size_t;
+
+    struct Totals
+    {
+        uint32_t requests;
+        uint32_t active;
+        uint32_t peak;
+        uint32_t delivered;
+        uint32_t dropped;
+    };
+
+    auto route( const char* name ) -> Route;
+    auto begin( Route route ) -> void;
+    auto end( Route route, std::chrono::microseconds latency ) -> void;
+    auto websocket( std::size_t clients, uint32_t delivered, uint32_t dropped ) -> void;
+    auto totals() -> Totals;
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void;
+
+    // A latência vai até o fim da resposta, inclusive das enviadas em partes
+    template<typename Request>
+    auto track( Route route, Request* request ) -> void
+    {
+        const auto start = std::chrono::steady_clock::now();
+        Metrics::begin( route );
+        request->onDisconnect( [route, start]
+        {
+            Metrics::end( route, std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ) );
+        } );
+    }
+} // namespace Metrics
\ No newline at end of file
@@ -48,4 +48,5 @@ namespace Peripherals
     };
 
     auto init() -> void;
+    auto mountCard() -> bool;
 }; // namespace Peripherals
\ No newline at end of file
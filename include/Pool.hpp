@@ -0,0 +1,270 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.hpp>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <esp_log.h>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Pool
+{
+    struct Stats
+    {
+        const char* name;
+        std::size_t size;
+        std::size_t used;
+        std::size_t peak;
+        std::size_t bytes;
+        uint32_t acquired;
+        uint32_t exhausted;
+    };
+
+    // Pools expõem uma cópia das estatísticas tirada sob o mesmo lock que as escreve
+    class Counted
+    {
+        public:
+            virtual auto snapshot() -> Stats = 0;
+    };
+
+    auto record( Counted* pool ) -> void;
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void;
+
+    template<typename T>
+    class Owner
+    {
+        public:
+            virtual auto retain( T* object ) -> void = 0;
+            virtual auto release( T* object ) -> void = 0;
+    };
+
+    // Referência contada que devolve o objeto ao pool, copiável para caber em std::function
+    template<typename T>
+    class Ptr
+    {
+        private:
+            T* object = nullptr;
+            Owner<T>* owner = nullptr;
+        public:
+            Ptr() = default;
+            Ptr( T* object, Owner<T>* owner ) : object{ object }, owner{ owner } {}
+            Ptr( const Ptr& other ) : object{ other.object }, owner{ other.owner }
+            {
+                if ( this->object != nullptr )
+                {
+                    this->owner->retain( this->object );
+                }
+            }
+            Ptr( Ptr&& other ) : object{ std::exchange( other.object, nullptr ) }, owner{ other.owner } {}
+            ~Ptr()
+            {
+                if ( this->object != nullptr )
+                {
+                    this->owner->release( this->object );
+                }
+            }
+
+            auto operator=( Ptr other ) -> Ptr&
+            {
+                std::swap( this->object, other.object );
+                std::swap( this->owner, other.owner );
+                return *this;
+            }
+
+            auto operator->() const -> T* { return this->object; }
+            auto operator*() const -> T& { return *this->object; }
+            auto get() const -> T* { return this->object; }
+            explicit operator bool() const { return this->object != nullptr; }
+    };
+
+    // N objetos reservados de uma vez no heap, no primeiro uso, e devolvidos quando o último sai; cheio devolve um Ptr vazio
+    template<typename T, std::size_t N>
+    class Fixed : public Owner<T>, public Counted
+    {
+        private:
+            using Slot = std::aligned_storage_t<sizeof( T ), alignof( T )>;
+
+            std::unique_ptr<Slot[]> slots = {};
+            std::array<std::atomic<uint16_t>, N> references = {};
+            std::array<bool, N> busy = {};
+            std::mutex slotsMutex = {};
+            Stats stats;
+
+            auto index( T* object ) const -> std::size_t
+            {
+                return ( reinterpret_cast<const uint8_t*>( object ) - reinterpret_cast<const uint8_t*>( this->slots.get() ) ) / sizeof( Slot );
+            }
+        public:
+            explicit Fixed( const char* name ) : stats{ name, N, 0, 0, 0, 0, 0 }
+            {
+                Pool::record( this );
+            }
+
+            auto snapshot() -> Stats override
+            {
+                const auto lock = std::lock_guard<std::mutex>{this->slotsMutex};
+                return this->stats;
+            }
+
+            template<typename... Args>
+            auto acquire( Args&&... args ) -> Ptr<T>
+            {
+                auto slot = N;
+                {
+                    const auto lock = std::lock_guard<std::mutex>{this->slotsMutex};
+
+                    // Pools de rotas nunca usadas não ocupam memória
+                    if ( not this->slots )
+                    {
+                        this->slots.reset( new ( std::nothrow ) Slot[N] );
+                        if ( not this->slots )
+                        {
+                            log_e( "%s: no memory for %u slots", this->stats.name, static_cast<unsigned>( N ) );
+                        }
+                        else
+                        {
+                            this->stats.bytes = sizeof( Slot ) * N;
+                        }
+                    }
+
+                    for ( auto i = 0u; i < N and slot == N and this->slots; ++i )
+                    {
+                        if ( not this->busy[i] )
+                        {
+                            this->busy[i] = true;
+                            this->references[i] = 1;
+                            slot = i;
+                        }
+                    }
+
+                    if ( slot == N )
+                    {
+                        this->stats.exhausted += 1;
+                        return {};
+                    }
+
+                    this->stats.acquired += 1;
+                    this->stats.used += 1;
+                    this->stats.peak = std::max( this->stats.peak, this->stats.used );
+                }
+
+                return Ptr<T>{ new ( &this->slots[slot] ) T( std::forward<Args>( args )... ), this };
+            }
+
+            auto retain( T* object ) -> void override
+            {
+                this->references[this->index( object )] += 1;
+            }
+
+            auto release( T* object ) -> void override
+            {
+                const auto slot = this->index( object );
+                if ( this->references[slot].fetch_sub( 1 ) > 1 )
+                {
+                    return;
+                }
+
+                object->~T();
+
+                const auto lock = std::lock_guard<std::mutex>{this->slotsMutex};
+                this->busy[slot] = false;
+                this->stats.used -= 1;
+
+                // Ocioso não segura heap: um deflater são ~28 KiB que só a exportação gzip usa
+                if ( this->stats.used == 0 )
+                {
+                    this->slots.reset();
+                    this->stats.bytes = 0;
+                }
+            }
+    };
+
+    // Região de alocação sequencial para um pedido, liberada inteira no fim
+    template<std::size_t SIZE>
+    class Arena
+    {
+        private:
+            // Cada bloco leva o tamanho à frente, o reallocate precisa saber se cresce
+            static constexpr auto ALIGN = alignof( std::max_align_t );
+            static constexpr auto HEADER = ( sizeof( std::size_t ) + ALIGN - 1 ) & ~( ALIGN - 1 );
+
+            alignas( std::max_align_t ) std::array<uint8_t, SIZE> buffer;
+            std::size_t used = 0;
+            std::size_t last = 0;
+
+            auto header( void* pointer ) -> uint8_t*
+            {
+                return static_cast<uint8_t*>( pointer ) - HEADER;
+            }
+        public:
+            Arena() {}
+
+            auto allocate( std::size_t size ) -> void*
+            {
+                const auto start = ( ( this->used + ALIGN - 1 ) & ~( ALIGN - 1 ) ) + HEADER;
+                if ( start > SIZE or size > SIZE - start )
+                {
+                    return nullptr;
+                }
+                std::memcpy( this->buffer.data() + start - HEADER, &size, sizeof( size ) );
+                this->used = start + size;
+                this->last = start;
+                return this->buffer.data() + start;
+            }
+
+            // Diminuir sempre cabe; crescer só o último bloco e só até o fim da região
+            auto reallocate( void* pointer, std::size_t size ) -> void*
+            {
+                if ( pointer == nullptr )
+                {
+                    return this->allocate( size );
+                }
+
+                const auto start = static_cast<std::size_t>( static_cast<uint8_t*>( pointer ) - this->buffer.data() );
+                auto current = std::size_t{0};
+                std::memcpy( &current, this->header( pointer ), sizeof( current ) );
+
+                if ( start == this->last )
+                {
+                    if ( size > SIZE - start )
+                    {
+                        return nullptr;
+                    }
+                    this->used = start + size;
+                }
+                else if ( size > current )
+                {
+                    return nullptr;
+                }
+
+                std::memcpy( this->header( pointer ), &size, sizeof( size ) );
+                return pointer;
+            }
+    };
+
+    // Alocador do ArduinoJson sobre uma arena, liberar não faz nada
+    template<typename A>
+    struct Allocator
+    {
+        A* arena = nullptr;
+
+        auto allocate( std::size_t size ) -> void*
+        {
+            return this->arena->allocate( size );
+        }
+
+        auto deallocate( void* ) -> void
+        {
+        }
+
+        auto reallocate( void* pointer, std::size_t size ) -> void*
+        {
+            return this->arena->reallocate( pointer, size );
+        }
+    };
+} // namespace Pool
\ No newline at end of file
@@ -2,15 +2,117 @@
 
 #include <Arduino.h>
 
-#include <RtcUtility.h>
-#include <RtcDateTime.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <functional>
+#include <optional>
 #include <string>
-#include <chrono>
 
 namespace RealTime
 {
+    // Deriva do DS3231 só é estimada com base longa, a leitura tem resolução de 1 s
+    static constexpr auto DRIFT_BASELINE = std::chrono::hours{24};
+    static constexpr auto DRIFT_MINIMUM = std::chrono::seconds{2};
+    static constexpr auto TRIM_THRESHOLD = std::chrono::seconds{1};
+    static constexpr auto AGING_PPM = 0.1f;
+
+    struct Trim
+    {
+        // Regravar o DS3231 com a hora de referência
+        bool write;
+        // Deriva em ppm, positiva adiantando, quando já há base para medir
+        std::optional<float> drift;
+    };
+
+    // Regravar o DS3231 por um erro pequeno não zera a base: a correção entra na conta e a deriva acumula até ser mensurável.
+    // Cada leitura erra até meio segundo, então a deriva é a reta de mínimos quadrados de todas as leituras desde a base
+    class Drift
+    {
+        private:
+            using Hours = std::chrono::duration<double, std::ratio<3600>>;
+            using Seconds = std::chrono::duration<double>;
+
+            // Leituras antes de confiar na reta para saber quanto o DS3231 foi corrigido
+            static constexpr auto FIT_MINIMUM = 4.0;
+
+            std::chrono::steady_clock::time_point baseline = {};
+            double corrected = 0.0;
+            double n = 0.0;
+            double sx = 0.0;
+            double sy = 0.0;
+            double sxx = 0.0;
+            double sxy = 0.0;
+            bool valid = false;
+
+            auto slope() const -> double
+            {
+                const auto denominator = this->n * this->sxx - this->sx * this->sx;
+                return denominator > 0.0 ? ( this->n * this->sxy - this->sx * this->sy ) / denominator : 0.0;
+            }
+
+            // Deriva acumulada estimada em x horas, em segundos
+            auto fit( double x ) const -> double
+            {
+                return ( this->sy - this->slope() * this->sx ) / this->n + this->slope() * x;
+            }
+        public:
+            auto reset( std::chrono::steady_clock::time_point now, std::chrono::steady_clock::duration remaining = {} ) -> void
+            {
+                *this = Drift{};
+                this->baseline = now;
+                this->corrected = -Seconds{ remaining }.count();
+                this->valid = true;
+            }
+
+            // offset = DS3231 menos a referência, medido em now
+            auto update( std::chrono::steady_clock::duration offset, std::chrono::steady_clock::time_point now ) -> Trim
+            {
+                if ( not this->valid )
+                {
+                    this->reset( now );
+                    return { true, {} };
+                }
+
+                const auto x = Hours{ now - this->baseline }.count();
+                const auto y = Seconds{ offset }.count() + this->corrected;
+                this->n += 1.0;
+                this->sx += x;
+                this->sy += y;
+                this->sxx += x * x;
+                this->sxy += x * y;
+
+                const auto drift = this->n >= FIT_MINIMUM ? this->fit( x ) : y;
+                // O quanto o DS3231 está de fato adiantado agora, melhor que a última leitura sozinha
+                const auto current = drift - this->corrected;
+
+                auto trim = Trim{ std::chrono::abs( offset ) >= TRIM_THRESHOLD, {} };
+
+                if ( now - this->baseline >= DRIFT_BASELINE and std::abs( drift ) >= Seconds{ DRIFT_MINIMUM }.count() )
+                {
+                    trim.drift = static_cast<float>( this->slope() / 3600.0 * 1e6 );
+
+                    // Aging novo, base nova a partir do que sobrar no DS3231
+                    this->reset( now, trim.write ? std::chrono::steady_clock::duration{} : std::chrono::duration_cast<std::chrono::steady_clock::duration>( Seconds{current} ) );
+                }
+                else if ( trim.write )
+                {
+                    this->corrected += current;
+                }
+
+                return trim;
+            }
+    };
+
+    // Cada unidade de aging atrasa o oscilador em ~0,1 ppm
+    inline auto aging( int8_t current, float drift ) -> int8_t
+    {
+        return static_cast<int8_t>( std::clamp<int>( current + static_cast<int>( std::lround( drift / AGING_PPM ) ), -128, 127 ) );
+    }
+
     auto init() -> void;
     auto process() -> void;
+    auto sync() -> void;
     auto adjustDateTime( const std::chrono::system_clock::time_point& timePoint ) -> void;
 } // namespace RealTime
\ No newline at end of file
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Arduino.h>
+#include <algorithm>
+#include <array>
+#include <ctime>
+#include <utility>
+
+namespace Sleep
+{
+    // Amostras em ordem, agrupadas pela janela de cada uma: uma gravação que falha não junta janelas num registro só
+    template<typename T, std::size_t N>
+    class Batch
+    {
+        private:
+            std::array<T, N> items = {};
+            std::size_t count = 0;
+        public:
+            auto data() const -> const T*
+            {
+                return this->items.data();
+            }
+
+            auto size() const -> std::size_t
+            {
+                return this->count;
+            }
+
+            auto full() const -> bool
+            {
+                return this->count == N;
+            }
+
+            // Janela da amostra mais antiga e quantas amostras seguidas são dela
+            template<typename Window>
+            auto front( Window window ) const -> std::pair<std::time_t, std::size_t>
+            {
+                if ( this->count == 0 )
+                {
+                    return {0, 0};
+                }
+
+                const auto start = window( this->items[0] );
+                auto size = std::size_t{1};
+                while ( size < this->count and window( this->items[size] ) == start )
+                {
+                    size += 1;
+                }
+                return {start, size};
+            }
+
+            // Grava as janelas anteriores a current, da mais antiga para a mais nova, e para na primeira falha
+            template<typename Window, typename Flush>
+            auto drain( std::time_t current, Window window, Flush flush ) -> bool
+            {
+                while ( this->count > 0 )
+                {
+                    const auto [start, size] = this->front( window );
+                    if ( start == current )
+                    {
+                        return true;
+                    }
+                    if ( not flush( start, this->items.data(), size ) )
+                    {
+                        return false;
+                    }
+                    this->drop( size );
+                }
+                return true;
+            }
+
+            // Grava as janelas encerradas e guarda a amostra; cheio, a janela mais antiga sai. Devolve as amostras perdidas
+            template<typename Window, typename Flush>
+            auto push( const T& item, Window window, Flush flush ) -> std::size_t
+            {
+                this->drain( window( item ), window, flush );
+
+                auto discarded = std::size_t{0};
+                if ( this->full() )
+                {
+                    const auto [start, size] = this->front( window );
+                    if ( not flush( start, this->items.data(), size ) )
+                    {
+                        discarded = size;
+                    }
+                    this->drop( size );
+                }
+
+                this->items[this->count++] = item;
+                return discarded;
+            }
+
+            auto drop( std::size_t size ) -> void
+            {
+                size = std::min( size, this->count );
+                std::move( this->items.begin() + size, this->items.begin() + this->count, this->items.begin() );
+                this->count -= size;
+            }
+    };
+
+    auto init() -> void;
+    auto process() -> void;
+} // namespace Sleep
\ No newline at end of file
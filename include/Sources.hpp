@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Arduino.h>
+#include <chrono>
+#include <ctime>
+#include <optional>
+
+#include "Configuration.hpp"
+#include "Infos.hpp"
+
+namespace Sources
+{
+    class Source
+    {
+        public:
+            virtual ~Source() = default;
+
+            virtual auto init() -> void = 0;
+            virtual auto process() -> void = 0;
+            virtual auto acquire( std::chrono::milliseconds gate ) -> Infos::SensorData = 0;
+            virtual auto read() -> Infos::SensorData = 0;
+
+            // Maior média de 3 s desde a chamada anterior, compõe a rajada do registro
+            virtual auto gust() -> float
+            {
+                return this->read().windGust;
+            }
+
+            // Relógio próprio da fonte, vazio quando ela segue o do sistema
+            virtual auto clock() -> std::optional<std::time_t>
+            {
+                return {};
+            }
+    };
+
+    auto hardware() -> Source&;
+    auto synthetic() -> Source&;
+    auto replay() -> Source&;
+    auto select( SensorSource type ) -> Source&;
+} // namespace Sources
\ No newline at end of file
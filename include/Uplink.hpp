@@ -0,0 +1,11 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.hpp>
+
+// Envia os registros novos ao sistema central em lotes, retomando de onde parou
+namespace Uplink
+{
+    auto init() -> void;
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void;
+} // namespace Uplink
\ No newline at end of file
@@ -1,28 +1,120 @@
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace Utils
 {
     auto periodic( std::chrono::milliseconds interval, void( *func )() ) -> void;
     auto bound( std::chrono::milliseconds interval, void( *func )() ) -> void;
+    auto reschedule() -> void;
+
+    // Tabelas enum <-> nome resolvidas em tempo de compilação, sem alocação
+    template<typename Enum, std::size_t N>
+    using Names = std::array<std::pair<Enum, std::string_view>, N>;
+
+    template<typename Enum, std::size_t N>
+    constexpr auto nameOf( const Names<Enum, N>& names, Enum value ) -> std::string_view
+    {
+        for ( const auto& [key, name] : names )
+        {
+            if ( key == value )
+            {
+                return name;
+            }
+        }
+        return std::string_view{""};
+    }
+
+    template<typename Enum, std::size_t N>
+    constexpr auto valueOf( const Names<Enum, N>& names, std::string_view name ) -> std::optional<Enum>
+    {
+        for ( const auto& [key, text] : names )
+        {
+            if ( text == name )
+            {
+                return key;
+            }
+        }
+        return std::nullopt;
+    }
 
     namespace WindDirection 
     {
-        auto getName(::WindDirection dir) -> std::string;
-        auto getValue(const std::string& name) -> ::WindDirection;
+        inline constexpr auto names = Names<::WindDirection, 8>
+        {{
+            {::WindDirection::NORTH,     "Norte"},
+            {::WindDirection::SOUTH,     "Sul"},
+            {::WindDirection::EAST,      "Leste"},
+            {::WindDirection::WEST,      "Oeste"},
+            {::WindDirection::NORTHEAST, "Nordeste"},
+            {::WindDirection::SOUTHEAST, "Sudeste"},
+            {::WindDirection::SOUTHWEST, "Sudoeste"},
+            {::WindDirection::NORTHWEST, "Noroeste"},
+        }};
+
+        constexpr auto getName(::WindDirection dir) -> std::string_view { return nameOf( names, dir ); }
+        constexpr auto getValue(std::string_view name) -> std::optional<::WindDirection> { return valueOf( names, name ); }
+        auto getAngle(::WindDirection dir) -> float;
     }
 
     namespace RainIntensity 
     {
-        auto getName(::RainIntensity dir) -> std::string;
-        auto getValue(const std::string& name) -> ::RainIntensity;
+        inline constexpr auto names = Names<::RainIntensity, 3>
+        {{
+            {::RainIntensity::DRY,   "Seco"},
+            {::RainIntensity::HUMID, "Umido"},
+            {::RainIntensity::RAINY, "Chuva"},
+        }};
+
+        constexpr auto getName(::RainIntensity dir) -> std::string_view { return nameOf( names, dir ); }
+        constexpr auto getValue(std::string_view name) -> std::optional<::RainIntensity> { return valueOf( names, name ); }
+    }
+
+    namespace SensorSource
+    {
+        inline constexpr auto names = Names<::SensorSource, 3>
+        {{
+            {::SensorSource::HARDWARE,  "Real"},
+            {::SensorSource::SYNTHETIC, "Sintetico"},
+            {::SensorSource::REPLAY,    "Reproducao"},
+        }};
+
+        constexpr auto getName(::SensorSource source) -> std::string_view { return nameOf( names, source ); }
+        constexpr auto getValue(std::string_view name) -> ::SensorSource { return valueOf( names, name ).value_or( ::SensorSource::HARDWARE ); }
+    }
+
+    namespace UplinkProtocol
+    {
+        inline constexpr auto names = Names<::UplinkProtocol, 2>
+        {{
+            {::UplinkProtocol::HTTP, "HTTP"},
+            {::UplinkProtocol::MQTT, "MQTT"},
+        }};
+
+        constexpr auto getName(::UplinkProtocol protocol) -> std::string_view { return nameOf( names, protocol ); }
+        constexpr auto getValue(std::string_view name) -> ::UplinkProtocol { return valueOf( names, name ).value_or( ::UplinkProtocol::HTTP ); }
+    }
+
+    namespace Samples
+    {
+        auto median( std::vector<uint16_t>& samples ) -> uint16_t;
+        auto trimmedMean( std::vector<uint16_t>& samples, float trim ) -> uint16_t;
     }
 
     namespace DateTime
     {
+        using Text = std::array<char, 20>;
+
         auto fromString( const std::string& str ) -> std::chrono::system_clock::time_point;
+        auto fromString( const char* str ) -> std::chrono::system_clock::time_point;
         auto toString( const std::chrono::system_clock::time_point& timePoint ) -> std::string;
+        auto toString( const std::chrono::system_clock::time_point& timePoint, Text& text ) -> const char*;
         auto fromStringHttp( const std::string& str ) -> std::chrono::system_clock::time_point;
         auto toStringHttp( const std::chrono::system_clock::time_point& timePoint ) -> std::string;
         auto compiled(const char* compiledDate = __DATE__, const char* compiledTime = __TIME__) -> std::chrono::system_clock::time_point;
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <Arduino.h>
+#include <ArduinoJson.hpp>
+
+namespace Vfs
+{
+    static constexpr auto NAME = "sd";
+
+    auto init() -> void;
+    auto reset() -> void;
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void;
+} // namespace Vfs
\ No newline at end of file
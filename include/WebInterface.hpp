@@ -4,6 +4,32 @@
 
 namespace WebInterface
 {
+    struct Delivery
+    {
+        uint32_t delivered;
+        uint32_t dropped;
+    };
+
     auto init() -> void;
     auto process() -> void;
+
+    // Cada cliente recebe se a fila dele tiver espaço: o lento perde a amostra sem atrasar os outros
+    template<typename Sockets>
+    auto broadcast( Sockets& sockets, const uint32_t* ids, std::size_t count, const char* text, std::size_t length ) -> Delivery
+    {
+        auto delivery = Delivery{};
+        for ( auto i = 0u; i < count; ++i )
+        {
+            if ( sockets.availableForWrite( ids[i] ) )
+            {
+                sockets.text( ids[i], text, length );
+                delivery.delivered += 1;
+            }
+            else
+            {
+                delivery.dropped += 1;
+            }
+        }
+        return delivery;
+    }
 } // namespace WebInterface
\ No newline at end of file
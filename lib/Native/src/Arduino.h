@@ -0,0 +1,67 @@
+#pragma once
+
+// Só o necessário do Arduino-ESP32 para os módulos compilarem no host (env:native)
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+
+#include <esp_log.h>
+#include <esp_system.h>
+
+#define IRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define PROGMEM
+#define F( string ) string
+
+#ifndef pgm_read_byte
+#define pgm_read_byte( address ) ( *reinterpret_cast<const uint8_t*>( address ) )
+#define pgm_read_word( address ) ( *reinterpret_cast<const uint16_t*>( address ) )
+#define pgm_read_dword( address ) ( *reinterpret_cast<const uint32_t*>( address ) )
+#endif
+
+inline auto millis() -> unsigned long
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - start ).count();
+}
+
+inline auto micros() -> unsigned long
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>( std::chrono::steady_clock::now() - start ).count();
+}
+
+inline auto delay( uint32_t ms ) -> void
+{
+    std::this_thread::sleep_for( std::chrono::milliseconds( ms ) );
+}
+
+inline auto yield() -> void
+{
+    std::this_thread::yield();
+}
+
+inline auto esp_random() -> uint32_t
+{
+    thread_local auto engine = std::mt19937{ std::random_device{}() };
+    return engine();
+}
+
+// Sem heap do ESP-IDF para medir, os relatórios mostram zero
+class EspClass
+{
+    public:
+        auto getFreeHeap() -> uint32_t { return 0; }
+        auto getMinFreeHeap() -> uint32_t { return 0; }
+        auto getMaxAllocHeap() -> uint32_t { return 0; }
+};
+
+extern EspClass ESP;
\ No newline at end of file
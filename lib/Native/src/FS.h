@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+// Sistema de arquivos do Arduino sobre um diretório do host
+namespace fs
+{
+    class File
+    {
+        private:
+            std::shared_ptr<FILE> handle;
+        public:
+            File() = default;
+            explicit File( FILE* handle );
+
+            explicit operator bool() const;
+            auto read() -> int;
+            auto read( uint8_t* buffer, std::size_t length ) -> std::size_t;
+            auto readBytes( char* buffer, std::size_t length ) -> std::size_t;
+            auto write( uint8_t value ) -> std::size_t;
+            auto write( const uint8_t* buffer, std::size_t length ) -> std::size_t;
+            auto available() -> int;
+            auto size() const -> std::size_t;
+            auto position() const -> std::size_t;
+            auto seek( std::size_t position ) -> bool;
+            auto flush() -> void;
+            auto close() -> void;
+    };
+
+    class FS
+    {
+        private:
+            std::string root;
+
+            auto resolve( const char* path ) const -> std::string;
+        public:
+            explicit FS( std::string root );
+
+            auto begin( bool formatOnFail = false ) -> bool;
+            auto end() -> void;
+            auto exists( const char* path ) -> bool;
+            auto open( const char* path, const char* mode = FILE_READ ) -> File;
+            auto remove( const char* path ) -> bool;
+            auto rename( const char* from, const char* to ) -> bool;
+            auto mkdir( const char* path ) -> bool;
+            auto totalBytes() -> std::size_t;
+            auto usedBytes() -> std::size_t;
+    };
+} // namespace fs
+
+using fs::File;
+using fs::FS;
\ No newline at end of file
@@ -0,0 +1,21 @@
+#include <Arduino.h>
+
+#include "Boot.hpp"
+#include "Sources.hpp"
+
+// Módulos presos ao hardware ficam fora do env:native, aqui só o que os outros chamam deles
+
+auto Boot::mark( const char* ) -> void
+{
+}
+
+// Sem sensores nem cartão, qualquer fonte lê do gerador sintético
+auto Sources::hardware() -> Source&
+{
+    return Sources::synthetic();
+}
+
+auto Sources::replay() -> Source&
+{
+    return Sources::synthetic();
+}
\ No newline at end of file
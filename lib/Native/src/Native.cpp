@@ -0,0 +1,289 @@
+#include <Arduino.h>
+
+#include <FS.h>
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <WiFi.h>
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <vector>
+
+// Diretório do host onde fica o conteúdo do LittleFS
+#ifndef NATIVE_FS_ROOT
+#define NATIVE_FS_ROOT ".pio/littlefs"
+#endif
+
+EspClass ESP;
+fs::FS LittleFS{ NATIVE_FS_ROOT };
+WiFiClass WiFi;
+
+namespace fs
+{
+    File::File( FILE* handle ) : handle( handle, std::fclose )
+    {
+    }
+
+    File::operator bool() const
+    {
+        return this->handle != nullptr;
+    }
+
+    auto File::read() -> int
+    {
+        return this->handle ? std::fgetc( this->handle.get() ) : -1;
+    }
+
+    auto File::read( uint8_t* buffer, std::size_t length ) -> std::size_t
+    {
+        return this->handle ? std::fread( buffer, 1, length, this->handle.get() ) : 0;
+    }
+
+    auto File::readBytes( char* buffer, std::size_t length ) -> std::size_t
+    {
+        return this->read( reinterpret_cast<uint8_t*>( buffer ), length );
+    }
+
+    auto File::write( uint8_t value ) -> std::size_t
+    {
+        return this->write( &value, 1 );
+    }
+
+    auto File::write( const uint8_t* buffer, std::size_t length ) -> std::size_t
+    {
+        return this->handle ? std::fwrite( buffer, 1, length, this->handle.get() ) : 0;
+    }
+
+    auto File::available() -> int
+    {
+        return static_cast<int>( this->size() - this->position() );
+    }
+
+    auto File::size() const -> std::size_t
+    {
+        if ( not this->handle )
+        {
+            return 0;
+        }
+        const auto position = std::ftell( this->handle.get() );
+        std::fseek( this->handle.get(), 0, SEEK_END );
+        const auto size = std::ftell( this->handle.get() );
+        std::fseek( this->handle.get(), position, SEEK_SET );
+        return static_cast<std::size_t>( size );
+    }
+
+    auto File::position() const -> std::size_t
+    {
+        return this->handle ? static_cast<std::size_t>( std::ftell( this->handle.get() ) ) : 0;
+    }
+
+    auto File::seek( std::size_t position ) -> bool
+    {
+        return this->handle and std::fseek( this->handle.get(), static_cast<long>( position ), SEEK_SET ) == 0;
+    }
+
+    auto File::flush() -> void
+    {
+        if ( this->handle )
+        {
+            std::fflush( this->handle.get() );
+        }
+    }
+
+    auto File::close() -> void
+    {
+        this->handle.reset();
+    }
+
+    FS::FS( std::string root ) : root( std::move( root ) )
+    {
+    }
+
+    auto FS::resolve( const char* path ) const -> std::string
+    {
+        return this->root + path;
+    }
+
+    auto FS::begin( bool ) -> bool
+    {
+        auto error = std::error_code{};
+        std::filesystem::create_directories( this->root, error );
+        return not error;
+    }
+
+    auto FS::end() -> void
+    {
+    }
+
+    auto FS::exists( const char* path ) -> bool
+    {
+        auto error = std::error_code{};
+        return std::filesystem::exists( this->resolve( path ), error );
+    }
+
+    auto FS::open( const char* path, const char* mode ) -> File
+    {
+        const auto name = this->resolve( path );
+        if ( mode[0] != 'r' )
+        {
+            auto error = std::error_code{};
+            std::filesystem::create_directories( std::filesystem::path( name ).parent_path(), error );
+        }
+        const auto binary = std::string{mode} + "b";
+        const auto handle = std::fopen( name.c_str(), binary.c_str() );
+        return handle != nullptr ? File{handle} : File{};
+    }
+
+    auto FS::remove( const char* path ) -> bool
+    {
+        return std::remove( this->resolve( path ).c_str() ) == 0;
+    }
+
+    auto FS::rename( const char* from, const char* to ) -> bool
+    {
+        return std::rename( this->resolve( from ).c_str(), this->resolve( to ).c_str() ) == 0;
+    }
+
+    auto FS::mkdir( const char* path ) -> bool
+    {
+        auto error = std::error_code{};
+        std::filesystem::create_directories( this->resolve( path ), error );
+        return not error;
+    }
+
+    auto FS::totalBytes() -> std::size_t
+    {
+        auto error = std::error_code{};
+        return std::filesystem::space( this->root, error ).capacity;
+    }
+
+    auto FS::usedBytes() -> std::size_t
+    {
+        auto error = std::error_code{};
+        const auto space = std::filesystem::space( this->root, error );
+        return space.capacity - space.available;
+    }
+} // namespace fs
+
+static std::mutex nvsMutex;
+static std::map<std::string, std::vector<uint8_t>> nvs;
+
+auto Preferences::key( const char* key ) const -> std::string
+{
+    return this->name + "/" + key;
+}
+
+auto Preferences::begin( const char* name, bool readOnly, const char* ) -> bool
+{
+    this->name = name;
+    this->readOnly = readOnly;
+    this->opened = true;
+
+    // Como na NVS, um namespace que nunca foi escrito não abre só para leitura
+    const auto lock = std::lock_guard{nvsMutex};
+    const auto prefix = this->name + "/";
+    const auto found = nvs.lower_bound( prefix );
+    return not readOnly or ( found != nvs.end() and found->first.compare( 0, prefix.size(), prefix ) == 0 );
+}
+
+auto Preferences::end() -> void
+{
+    this->opened = false;
+}
+
+auto Preferences::clear() -> bool
+{
+    if ( not this->opened or this->readOnly )
+    {
+        return false;
+    }
+    const auto lock = std::lock_guard{nvsMutex};
+    const auto prefix = this->name + "/";
+    for ( auto it = nvs.lower_bound( prefix ); it != nvs.end() and it->first.compare( 0, prefix.size(), prefix ) == 0; )
+    {
+        it = nvs.erase( it );
+    }
+    return true;
+}
+
+auto Preferences::remove( const char* key ) -> bool
+{
+    if ( not this->opened or this->readOnly )
+    {
+        return false;
+    }
+    const auto lock = std::lock_guard{nvsMutex};
+    return nvs.erase( this->key( key ) ) > 0;
+}
+
+auto Preferences::isKey( const char* key ) -> bool
+{
+    const auto lock = std::lock_guard{nvsMutex};
+    return this->opened and nvs.count( this->key( key ) ) > 0;
+}
+
+auto Preferences::getBytesLength( const char* key ) -> std::size_t
+{
+    const auto lock = std::lock_guard{nvsMutex};
+    const auto found = nvs.find( this->key( key ) );
+    return this->opened and found != nvs.end() ? found->second.size() : 0;
+}
+
+auto Preferences::getBytes( const char* key, void* buffer, std::size_t length ) -> std::size_t
+{
+    const auto lock = std::lock_guard{nvsMutex};
+    const auto found = nvs.find( this->key( key ) );
+    if ( not this->opened or found == nvs.end() or found->second.size() > length )
+    {
+        return 0;
+    }
+    std::memcpy( buffer, found->second.data(), found->second.size() );
+    return found->second.size();
+}
+
+auto Preferences::putBytes( const char* key, const void* value, std::size_t length ) -> std::size_t
+{
+    if ( not this->opened or this->readOnly )
+    {
+        return 0;
+    }
+    const auto lock = std::lock_guard{nvsMutex};
+    const auto bytes = reinterpret_cast<const uint8_t*>( value );
+    nvs[this->key( key )].assign( bytes, bytes + length );
+    return length;
+}
+
+auto WiFiClass::onEvent( WiFiEventFuncCb callback, arduino_event_id_t event ) -> int
+{
+    this->handlers.push_back( { callback, event } );
+    return static_cast<int>( this->handlers.size() );
+}
+
+auto WiFiClass::begin( const char*, const char*, int32_t channel, const uint8_t* bssid, bool ) -> int
+{
+    this->attempt.count++;
+    this->attempt.channel = channel;
+    this->attempt.bssid = {};
+    if ( bssid != nullptr )
+    {
+        std::copy_n( bssid, this->attempt.bssid.size(), this->attempt.bssid.begin() );
+    }
+    return 1;
+}
+
+auto WiFiClass::RSSI() -> int8_t
+{
+    return -60;
+}
+
+auto WiFiClass::emit( arduino_event_id_t event, const arduino_event_info_t& info ) -> void
+{
+    for ( const auto& handler : this->handlers )
+    {
+        if ( handler.event == event or handler.event == ARDUINO_EVENT_MAX )
+        {
+            handler.callback( event, info );
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// NVS em memória, compartilhada por todas as instâncias até o fim do processo
+class Preferences
+{
+    private:
+        std::string name;
+        bool readOnly = true;
+        bool opened = false;
+
+        auto key( const char* key ) const -> std::string;
+    public:
+        auto begin( const char* name, bool readOnly = false, const char* partition = nullptr ) -> bool;
+        auto end() -> void;
+        auto clear() -> bool;
+        auto remove( const char* key ) -> bool;
+        auto isKey( const char* key ) -> bool;
+        auto getBytesLength( const char* key ) -> std::size_t;
+        auto getBytes( const char* key, void* buffer, std::size_t length ) -> std::size_t;
+        auto putBytes( const char* key, const void* value, std::size_t length ) -> std::size_t;
+};
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+#define VSPI 3
+
+class SPIClass
+{
+    public:
+        SPIClass( uint8_t ) {}
+};
\ No newline at end of file
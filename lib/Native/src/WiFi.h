@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+enum arduino_event_id_t
+{
+    ARDUINO_EVENT_WIFI_STA_CONNECTED,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+    ARDUINO_EVENT_WIFI_STA_GOT_IP,
+    ARDUINO_EVENT_WIFI_STA_LOST_IP,
+    ARDUINO_EVENT_MAX,
+};
+
+enum wifi_err_reason_t
+{
+    WIFI_REASON_UNSPECIFIED = 1,
+    WIFI_REASON_ASSOC_LEAVE = 8,
+    WIFI_REASON_BEACON_TIMEOUT = 200,
+    WIFI_REASON_NO_AP_FOUND = 201,
+    WIFI_REASON_AUTH_FAIL = 202,
+};
+
+struct wifi_event_sta_connected_t
+{
+    uint8_t ssid[32];
+    uint8_t ssid_len;
+    uint8_t bssid[6];
+    uint8_t channel;
+};
+
+struct wifi_event_sta_disconnected_t
+{
+    uint8_t ssid[32];
+    uint8_t ssid_len;
+    uint8_t bssid[6];
+    uint8_t reason;
+};
+
+union arduino_event_info_t
+{
+    wifi_event_sta_connected_t wifi_sta_connected;
+    wifi_event_sta_disconnected_t wifi_sta_disconnected;
+};
+
+using WiFiEventFuncCb = void ( * )( arduino_event_id_t event, arduino_event_info_t info );
+
+// Sem rádio: os testes fazem o papel da tarefa do Wi-Fi chamando emit()
+class WiFiClass
+{
+    private:
+        struct Handler
+        {
+            WiFiEventFuncCb callback;
+            arduino_event_id_t event;
+        };
+
+        std::vector<Handler> handlers;
+    public:
+        // Última chamada a begin(), channel 0 quando foi por varredura
+        struct Attempt
+        {
+            uint32_t count = 0;
+            int32_t channel = 0;
+            std::array<uint8_t, 6> bssid = {};
+        } attempt;
+
+        auto onEvent( WiFiEventFuncCb callback, arduino_event_id_t event = ARDUINO_EVENT_MAX ) -> int;
+        auto begin( const char* ssid, const char* password = nullptr, int32_t channel = 0, const uint8_t* bssid = nullptr, bool connect = true ) -> int;
+        auto RSSI() -> int8_t;
+        auto emit( arduino_event_id_t event, const arduino_event_info_t& info ) -> void;
+};
+
+extern WiFiClass WiFi;
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstdio>
+
+// Mesmos níveis do CORE_DEBUG_LEVEL do Arduino-ESP32, no host só erros por padrão
+#ifndef CORE_DEBUG_LEVEL
+#define CORE_DEBUG_LEVEL 1
+#endif
+
+#define NATIVE_LOG( level, letter, format, ... )                                                    \
+    do                                                                                              \
+    {                                                                                               \
+        if ( CORE_DEBUG_LEVEL >= level )                                                            \
+        {                                                                                           \
+            std::fprintf( stderr, "[" letter "][%s] " format "\n", __func__, ##__VA_ARGS__ );       \
+        }                                                                                           \
+    } while ( false )
+
+#define log_e( format, ... ) NATIVE_LOG( 1, "E", format, ##__VA_ARGS__ )
+#define log_w( format, ... ) NATIVE_LOG( 2, "W", format, ##__VA_ARGS__ )
+#define log_i( format, ... ) NATIVE_LOG( 3, "I", format, ##__VA_ARGS__ )
+#define log_d( format, ... ) NATIVE_LOG( 4, "D", format, ##__VA_ARGS__ )
+#define log_v( format, ... ) NATIVE_LOG( 5, "V", format, ##__VA_ARGS__ )
\ No newline at end of file
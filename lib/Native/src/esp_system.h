@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+using esp_err_t = int;
+
+#ifndef ESP_OK
+#define ESP_OK 0
+#endif
+
+enum esp_mac_type_t
+{
+    ESP_MAC_WIFI_STA,
+    ESP_MAC_WIFI_SOFTAP,
+    ESP_MAC_BT,
+    ESP_MAC_ETH,
+};
+
+// MAC fixo por interface, como se lido do eFuse
+inline auto esp_read_mac( uint8_t* mac, esp_mac_type_t type ) -> esp_err_t
+{
+    const uint8_t base[6] = { 0x24, 0x0A, 0xC4, 0x00, 0x00, static_cast<uint8_t>( type ) };
+    std::memcpy( mac, base, sizeof( base ) );
+    return ESP_OK;
+}
\ No newline at end of file
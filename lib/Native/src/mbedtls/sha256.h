@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// SHA-256 do FIPS 180-4 com a mesma interface do mbedTLS 2.x usado pelo ESP-IDF
+struct mbedtls_sha256_context
+{
+    uint32_t state[8];
+    uint64_t length;
+    uint8_t block[64];
+    std::size_t used;
+};
+
+namespace Native::Sha256
+{
+    inline constexpr uint32_t K[64] =
+    {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+
+    inline auto rotate( uint32_t value, int bits ) -> uint32_t
+    {
+        return ( value >> bits ) | ( value << ( 32 - bits ) );
+    }
+
+    inline auto compress( mbedtls_sha256_context* ctx, const uint8_t* block ) -> void
+    {
+        uint32_t w[64];
+        for ( auto i = 0; i < 16; ++i )
+        {
+            w[i] = uint32_t{ block[4 * i] } << 24 | uint32_t{ block[4 * i + 1] } << 16 | uint32_t{ block[4 * i + 2] } << 8 | block[4 * i + 3];
+        }
+        for ( auto i = 16; i < 64; ++i )
+        {
+            const auto s0 = rotate( w[i - 15], 7 ) ^ rotate( w[i - 15], 18 ) ^ ( w[i - 15] >> 3 );
+            const auto s1 = rotate( w[i - 2], 17 ) ^ rotate( w[i - 2], 19 ) ^ ( w[i - 2] >> 10 );
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t v[8];
+        std::memcpy( v, ctx->state, sizeof( v ) );
+        for ( auto i = 0; i < 64; ++i )
+        {
+            const auto s1 = rotate( v[4], 6 ) ^ rotate( v[4], 11 ) ^ rotate( v[4], 25 );
+            const auto t1 = v[7] + s1 + ( ( v[4] & v[5] ) ^ ( ~v[4] & v[6] ) ) + K[i] + w[i];
+            const auto s0 = rotate( v[0], 2 ) ^ rotate( v[0], 13 ) ^ rotate( v[0], 22 );
+            const auto t2 = s0 + ( ( v[0] & v[1] ) ^ ( v[0] & v[2] ) ^ ( v[1] & v[2] ) );
+            std::memmove( v + 1, v, 7 * sizeof( uint32_t ) );
+            v[4] += t1;
+            v[0] = t1 + t2;
+        }
+        for ( auto i = 0; i < 8; ++i )
+        {
+            ctx->state[i] += v[i];
+        }
+    }
+} // namespace Native::Sha256
+
+inline auto mbedtls_sha256_init( mbedtls_sha256_context* ctx ) -> void
+{
+    std::memset( ctx, 0, sizeof( *ctx ) );
+}
+
+inline auto mbedtls_sha256_free( mbedtls_sha256_context* ctx ) -> void
+{
+    std::memset( ctx, 0, sizeof( *ctx ) );
+}
+
+inline auto mbedtls_sha256_starts_ret( mbedtls_sha256_context* ctx, int is224 ) -> int
+{
+    static constexpr uint32_t initial[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    std::memcpy( ctx->state, initial, sizeof( initial ) );
+    ctx->length = 0;
+    ctx->used = 0;
+    return is224 == 0 ? 0 : -1;
+}
+
+inline auto mbedtls_sha256_update_ret( mbedtls_sha256_context* ctx, const unsigned char* input, std::size_t length ) -> int
+{
+    ctx->length += length;
+    while ( length > 0 )
+    {
+        const auto count = std::min( length, sizeof( ctx->block ) - ctx->used );
+        std::memcpy( ctx->block + ctx->used, input, count );
+        ctx->used += count;
+        input += count;
+        length -= count;
+        if ( ctx->used == sizeof( ctx->block ) )
+        {
+            Native::Sha256::compress( ctx, ctx->block );
+            ctx->used = 0;
+        }
+    }
+    return 0;
+}
+
+inline auto mbedtls_sha256_finish_ret( mbedtls_sha256_context* ctx, unsigned char* output ) -> int
+{
+    const auto bits = ctx->length * 8;
+    const uint8_t pad = 0x80;
+    const uint8_t zero = 0;
+    mbedtls_sha256_update_ret( ctx, &pad, 1 );
+    while ( ctx->used != 56 )
+    {
+        mbedtls_sha256_update_ret( ctx, &zero, 1 );
+    }
+    uint8_t tail[8];
+    for ( auto i = 0; i < 8; ++i )
+    {
+        tail[i] = static_cast<uint8_t>( bits >> ( 56 - 8 * i ) );
+    }
+    mbedtls_sha256_update_ret( ctx, tail, sizeof( tail ) );
+    for ( auto i = 0; i < 8; ++i )
+    {
+        output[4 * i] = static_cast<uint8_t>( ctx->state[i] >> 24 );
+        output[4 * i + 1] = static_cast<uint8_t>( ctx->state[i] >> 16 );
+        output[4 * i + 2] = static_cast<uint8_t>( ctx->state[i] >> 8 );
+        output[4 * i + 3] = static_cast<uint8_t>( ctx->state[i] );
+    }
+    return 0;
+}
\ No newline at end of file
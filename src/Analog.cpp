@@ -0,0 +1,135 @@
+#include <Arduino.h>
+
+#include <array>
+#include <atomic>
+#include <driver/adc.h>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <vector>
+
+#include "Analog.hpp"
+#include "Configuration.hpp"
+#include "Peripherals.hpp"
+#include "Utils.hpp"
+
+namespace Analog
+{
+    static constexpr auto SAMPLE_FREQUENCY = 20000u;
+    static constexpr auto FRAME_SIZE = 1024u;
+
+    static TaskHandle_t task = nullptr;
+
+    static std::atomic<uint16_t> windDirectionValue = 0;
+    static std::atomic<uint16_t> rainIntensityValue = 0;
+
+    static auto acquire( void* ) -> void
+    {
+        const auto windDirectionChannel = static_cast<uint8_t>( digitalPinToAnalogChannel( Peripherals::WIND_DIRECTION ) );
+        const auto rainIntensityChannel = static_cast<uint8_t>( digitalPinToAnalogChannel( Peripherals::RAIN_INTENSITY ) );
+
+        auto frame = std::array<uint8_t, FRAME_SIZE>{};
+        auto windDirectionSamples = std::vector<uint16_t>{};
+        auto rainIntensitySamples = std::vector<uint16_t>{};
+        windDirectionSamples.reserve( FRAME_SIZE / SOC_ADC_DIGI_RESULT_BYTES );
+        rainIntensitySamples.reserve( FRAME_SIZE / SOC_ADC_DIGI_RESULT_BYTES );
+
+        while ( true )
+        {
+            auto length = uint32_t{0};
+            const auto rc = adc_digi_read_bytes( frame.data(), frame.size(), &length, ADC_MAX_DELAY );
+            if ( rc != ESP_OK and rc != ESP_ERR_INVALID_STATE )
+            {
+                log_e( "adc read error: %d", rc );
+                continue;
+            }
+
+            windDirectionSamples.clear();
+            rainIntensitySamples.clear();
+
+            for ( auto n = 0u; n + SOC_ADC_DIGI_RESULT_BYTES <= length; n += SOC_ADC_DIGI_RESULT_BYTES )
+            {
+                const auto result = reinterpret_cast<const adc_digi_output_data_t*>( &frame[n] );
+                if ( result->type1.channel == windDirectionChannel )
+                {
+                    windDirectionSamples.push_back( result->type1.data );
+                }
+                else if ( result->type1.channel == rainIntensityChannel )
+                {
+                    rainIntensitySamples.push_back( result->type1.data );
+                }
+            }
+
+            if ( not windDirectionSamples.empty() )
+            {
+                Analog::windDirectionValue = Utils::Samples::median( windDirectionSamples );
+            }
+            if ( not rainIntensitySamples.empty() )
+            {
+                Analog::rainIntensityValue = Utils::Samples::trimmedMean( rainIntensitySamples, 0.25f );
+            }
+        }
+    }
+
+    auto init() -> void
+    {
+        log_d( "begin" );
+
+        if ( task != nullptr )
+        {
+            log_d( "already running" );
+            return;
+        }
+
+        const auto windDirectionChannel = static_cast<uint8_t>( digitalPinToAnalogChannel( Peripherals::WIND_DIRECTION ) );
+        const auto rainIntensityChannel = static_cast<uint8_t>( digitalPinToAnalogChannel( Peripherals::RAIN_INTENSITY ) );
+
+        auto initConfig = adc_digi_init_config_t{
+            .max_store_buf_size = FRAME_SIZE * 4,
+            .conv_num_each_intr = FRAME_SIZE,
+            .adc1_chan_mask = static_cast<uint32_t>( BIT( windDirectionChannel ) | BIT( rainIntensityChannel ) ),
+            .adc2_chan_mask = 0,
+        };
+        if ( adc_digi_initialize( &initConfig ) != ESP_OK )
+        {
+            log_e( "adc init error" );
+            return;
+        }
+
+        auto pattern = std::array<adc_digi_pattern_config_t, 2>{{
+            { .atten = ADC_ATTEN_DB_11, .channel = windDirectionChannel, .unit = 0, .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH },
+            { .atten = ADC_ATTEN_DB_11, .channel = rainIntensityChannel, .unit = 0, .bit_width = SOC_ADC_DIGI_MAX_BITWIDTH },
+        }};
+
+        auto controllerConfig = adc_digi_configuration_t{
+            .conv_limit_en = true,
+            .conv_limit_num = 250,
+            .pattern_num = pattern.size(),
+            .adc_pattern = pattern.data(),
+            .sample_freq_hz = SAMPLE_FREQUENCY,
+            .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+            .format = ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+        };
+        if ( adc_digi_controller_configure( &controllerConfig ) != ESP_OK )
+        {
+            log_e( "adc config error" );
+            return;
+        }
+
+        adc_digi_start();
+
+        xTaskCreatePinnedToCore( Analog::acquire, "analog", 4096, nullptr, 1, &task, 0 );
+
+        log_d( "end" );
+    }
+
+    auto windDirection() -> uint16_t
+    {
+        return Analog::windDirectionValue;
+    }
+
+    auto rainIntensity() -> uint16_t
+    {
+        return Analog::rainIntensityValue;
+    }
+} // namespace Analog
\ No newline at end of file
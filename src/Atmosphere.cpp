@@ -0,0 +1,234 @@
+#include <Arduino.h>
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <esp_log.h>
+
+#include "Atmosphere.hpp"
+#include "Bus.hpp"
+#include "Peripherals.hpp"
+
+namespace Atmosphere
+{
+    enum Registers : uint8_t
+    {
+        CALIBRATION_TP = 0x88,
+        CALIBRATION_H1 = 0xA1,
+        CHIP_ID = 0xD0,
+        CALIBRATION_H2 = 0xE1,
+        CTRL_HUM = 0xF2,
+        CTRL_MEAS = 0xF4,
+        CONFIG = 0xF5,
+        DATA = 0xF7,
+    };
+
+    static constexpr uint8_t ADDRESS = Peripherals::BME280::I2C_ADDRESS;
+    static constexpr uint8_t CHIP = 0x60;
+    static constexpr uint8_t MODE_FORCED = 0x01;
+
+    // Oversampling: 1 = x1, 2 = x2, 3 = x4, 4 = x8, 5 = x16
+    static constexpr uint8_t OSR_TEMPERATURE = 2;
+    static constexpr uint8_t OSR_PRESSURE = 4;
+    static constexpr uint8_t OSR_HUMIDITY = 2;
+
+    struct Calibration
+    {
+        uint16_t t1;
+        int16_t t2, t3;
+        uint16_t p1;
+        int16_t p2, p3, p4, p5, p6, p7, p8, p9;
+        uint8_t h1;
+        int16_t h2;
+        uint8_t h3;
+        int16_t h4, h5;
+        int8_t h6;
+    };
+
+    enum class State
+    {
+        UNINITIALIZED,
+        IDLE,
+        CONVERTING,
+    };
+
+    static Calibration calibration = {};
+    static State state = State::UNINITIALIZED;
+    static std::chrono::steady_clock::time_point timer = {};
+
+    static float temperatureValue = NAN;
+    static float humidityValue = NAN;
+    static float pressureValue = NAN;
+
+    static auto compensate( int32_t adcT, int32_t adcP, int32_t adcH ) -> void
+    {
+        const auto& c = calibration;
+
+        int32_t var1 = ( ( ( ( adcT >> 3 ) - ( static_cast<int32_t>( c.t1 ) << 1 ) ) ) * c.t2 ) >> 11;
+        int32_t var2 = ( ( ( ( ( adcT >> 4 ) - c.t1 ) * ( ( adcT >> 4 ) - c.t1 ) ) >> 12 ) * c.t3 ) >> 14;
+        const int32_t tFine = var1 + var2;
+        temperatureValue = ( ( tFine * 5 + 128 ) >> 8 ) / 100.0f;
+
+        int64_t p1 = static_cast<int64_t>( tFine ) - 128000;
+        int64_t p2 = p1 * p1 * c.p6;
+        p2 = p2 + ( ( p1 * c.p5 ) << 17 );
+        p2 = p2 + ( static_cast<int64_t>( c.p4 ) << 35 );
+        p1 = ( ( p1 * p1 * c.p3 ) >> 8 ) + ( ( p1 * c.p2 ) << 12 );
+        p1 = ( ( ( static_cast<int64_t>( 1 ) << 47 ) + p1 ) ) * c.p1 >> 33;
+        if ( p1 != 0 )
+        {
+            int64_t p = 1048576 - adcP;
+            p = ( ( ( p << 31 ) - p2 ) * 3125 ) / p1;
+            p2 = ( static_cast<int64_t>( c.p9 ) * ( p >> 13 ) * ( p >> 13 ) ) >> 25;
+            p1 = ( static_cast<int64_t>( c.p8 ) * p ) >> 19;
+            p = ( ( p + p1 + p2 ) >> 8 ) + ( static_cast<int64_t>( c.p7 ) << 4 );
+            pressureValue = p / 256.0f / 100.0f;
+        }
+
+        int32_t h = tFine - 76800;
+        h = ( ( ( ( ( adcH << 14 ) - ( static_cast<int32_t>( c.h4 ) << 20 ) - ( c.h5 * h ) ) + 16384 ) >> 15 )
+              * ( ( ( ( ( ( ( h * c.h6 ) >> 10 ) * ( ( ( h * static_cast<int32_t>( c.h3 ) ) >> 11 ) + 32768 ) ) >> 10 ) + 2097152 ) * c.h2 + 8192 ) >> 14 ) );
+        h = h - ( ( ( ( ( h >> 15 ) * ( h >> 15 ) ) >> 7 ) * static_cast<int32_t>( c.h1 ) ) >> 4 );
+        h = std::min( std::max( h, 0 ), 419430400 );
+        humidityValue = ( h >> 12 ) / 1024.0f;
+    }
+
+    auto init() -> bool
+    {
+        log_d( "begin" );
+
+        state = State::UNINITIALIZED;
+
+        auto chip = uint8_t{0};
+        if ( not Bus::read( ADDRESS, CHIP_ID, &chip, 1 ) or chip != CHIP )
+        {
+            log_e( "bme error, chip = 0x%02X", chip );
+            return false;
+        }
+
+        auto tp = std::array<uint8_t, 24>{};
+        auto h1 = uint8_t{0};
+        auto h2 = std::array<uint8_t, 7>{};
+        if ( not Bus::read( ADDRESS, CALIBRATION_TP, tp.data(), tp.size() )
+                or not Bus::read( ADDRESS, CALIBRATION_H1, &h1, 1 )
+                or not Bus::read( ADDRESS, CALIBRATION_H2, h2.data(), h2.size() ) )
+        {
+            log_e( "bme calibration error" );
+            return false;
+        }
+
+        const auto u16 = [&]( std::size_t n ) { return static_cast<uint16_t>( tp[n] | ( tp[n + 1] << 8 ) ); };
+        calibration = Calibration{
+            .t1 = u16( 0 ),
+            .t2 = static_cast<int16_t>( u16( 2 ) ),
+            .t3 = static_cast<int16_t>( u16( 4 ) ),
+            .p1 = u16( 6 ),
+            .p2 = static_cast<int16_t>( u16( 8 ) ),
+            .p3 = static_cast<int16_t>( u16( 10 ) ),
+            .p4 = static_cast<int16_t>( u16( 12 ) ),
+            .p5 = static_cast<int16_t>( u16( 14 ) ),
+            .p6 = static_cast<int16_t>( u16( 16 ) ),
+            .p7 = static_cast<int16_t>( u16( 18 ) ),
+            .p8 = static_cast<int16_t>( u16( 20 ) ),
+            .p9 = static_cast<int16_t>( u16( 22 ) ),
+            .h1 = h1,
+            .h2 = static_cast<int16_t>( h2[0] | ( h2[1] << 8 ) ),
+            .h3 = h2[2],
+            .h4 = static_cast<int16_t>( static_cast<int8_t>( h2[3] ) * 16 | ( h2[4] & 0x0F ) ),
+            .h5 = static_cast<int16_t>( static_cast<int8_t>( h2[5] ) * 16 | ( h2[4] >> 4 ) ),
+            .h6 = static_cast<int8_t>( h2[6] ),
+        };
+
+        if ( not Bus::write( ADDRESS, CONFIG, 0x00 ) )
+        {
+            return false;
+        }
+
+        state = State::IDLE;
+
+        log_d( "end" );
+        return true;
+    }
+
+    auto conversion() -> std::chrono::milliseconds
+    {
+        // Tempo máximo de medição (datasheet BME280, seção 9.1)
+        const auto osr = []( uint8_t code ) { return 1u << ( code - 1 ); };
+        const auto micros = 1250u + 2300u * osr( OSR_TEMPERATURE ) + ( 2300u * osr( OSR_PRESSURE ) + 575u ) + ( 2300u * osr( OSR_HUMIDITY ) + 575u );
+        return std::chrono::milliseconds{( micros + 999u ) / 1000u};
+    }
+
+    auto trigger() -> bool
+    {
+        if ( not Bus::write( ADDRESS, CTRL_HUM, OSR_HUMIDITY )
+                or not Bus::write( ADDRESS, CTRL_MEAS, ( OSR_TEMPERATURE << 5 ) | ( OSR_PRESSURE << 2 ) | MODE_FORCED ) )
+        {
+            return false;
+        }
+
+        state = State::CONVERTING;
+        timer = std::chrono::steady_clock::now() + Atmosphere::conversion();
+        return true;
+    }
+
+    auto collect() -> bool
+    {
+        auto data = std::array<uint8_t, 8>{};
+        if ( not Bus::read( ADDRESS, DATA, data.data(), data.size() ) )
+        {
+            return false;
+        }
+
+        const auto adcP = static_cast<int32_t>( ( data[0] << 12 ) | ( data[1] << 4 ) | ( data[2] >> 4 ) );
+        const auto adcT = static_cast<int32_t>( ( data[3] << 12 ) | ( data[4] << 4 ) | ( data[5] >> 4 ) );
+        const auto adcH = static_cast<int32_t>( ( data[6] << 8 ) | data[7] );
+
+        Atmosphere::compensate( adcT, adcP, adcH );
+
+        state = State::IDLE;
+        timer = std::chrono::steady_clock::now() + std::chrono::seconds{1};
+        return true;
+    }
+
+    auto process() -> void
+    {
+        const auto now = std::chrono::steady_clock::now();
+
+        if ( state == State::UNINITIALIZED )
+        {
+            if ( now >= timer and not Atmosphere::init() )
+            {
+                timer = now + std::chrono::seconds{10};
+            }
+        }
+        else if ( state == State::IDLE )
+        {
+            if ( now >= timer and not Atmosphere::trigger() )
+            {
+                state = State::UNINITIALIZED;
+            }
+        }
+        else if ( state == State::CONVERTING )
+        {
+            if ( now >= timer and not Atmosphere::collect() )
+            {
+                state = State::UNINITIALIZED;
+            }
+        }
+    }
+
+    auto temperature() -> float
+    {
+        return temperatureValue;
+    }
+
+    auto humidity() -> float
+    {
+        return humidityValue;
+    }
+
+    auto pressure() -> float
+    {
+        return pressureValue;
+    }
+} // namespace Atmosphere
\ No newline at end of file
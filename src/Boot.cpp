@@ -0,0 +1,115 @@
+#include <Arduino.h>
+
+#include <array>
+#include <cstring>
+#include <esp_log.h>
+#include <esp_pthread.h>
+#include <esp_timer.h>
+#include <mutex>
+
+#include "Boot.hpp"
+
+namespace Boot
+{
+    static constexpr auto STACK_SIZE = std::size_t{8192};
+
+    // Tempos em µs desde o início da aplicação, marcos têm duração 0
+    struct Entry
+    {
+        const char* name;
+        int64_t start;
+        int64_t duration;
+        bool background;
+    };
+
+    static std::mutex entriesMutex = {};
+    static std::array<Entry, 24> entries = {};
+    static std::size_t count = 0;
+
+    static auto record( const Entry& entry ) -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{entriesMutex};
+
+        if ( count < entries.size() )
+        {
+            entries[count++] = entry;
+        }
+    }
+
+    static auto run( const char* name, const std::function<void()>& func, bool background ) -> void
+    {
+        const auto start = esp_timer_get_time();
+        func();
+        const auto end = esp_timer_get_time();
+
+        Boot::record( Entry{ .name = name, .start = start, .duration = end - start, .background = background } );
+        log_d( "%s: %lld ms", name, ( end - start ) / 1000 );
+    }
+
+    auto step( const char* name, const std::function<void()>& func ) -> void
+    {
+        Boot::run( name, func, false );
+    }
+
+    auto background( const char* name, std::function<void()> func ) -> std::future<void>
+    {
+        const auto defaults = esp_pthread_get_default_config();
+
+        auto config = defaults;
+        config.stack_size = STACK_SIZE;
+        config.thread_name = name;
+        esp_pthread_set_cfg( &config );
+
+        auto future = std::async( std::launch::async, [name, func = std::move( func )]
+        {
+            Boot::run( name, func, true );
+        } );
+
+        esp_pthread_set_cfg( &defaults );
+        return future;
+    }
+
+    auto mark( const char* name ) -> void
+    {
+        {
+            const auto lock = std::lock_guard<std::mutex>{entriesMutex};
+
+            for ( auto i = 0u; i < count; ++i )
+            {
+                if ( std::strcmp( entries[i].name, name ) == 0 )
+                {
+                    return;
+                }
+            }
+        }
+
+        Boot::record( Entry{ .name = name, .start = esp_timer_get_time(), .duration = 0, .background = false } );
+        log_i( "%s at %lld ms", name, esp_timer_get_time() / 1000 );
+    }
+
+    auto report() -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{entriesMutex};
+
+        for ( auto i = 0u; i < count; ++i )
+        {
+            const auto& entry = entries[i];
+            log_i( "%-16s %6lld ms %6lld ms%s", entry.name, entry.start / 1000, entry.duration / 1000, entry.background ? " (background)" : "" );
+        }
+    }
+
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{entriesMutex};
+
+        for ( auto i = 0u; i < count; ++i )
+        {
+            const auto& entry = entries[i];
+            auto item = json.add();
+            item["name"] = entry.name;
+            item["start_ms"] = entry.start / 1000.0f;
+            item["duration_ms"] = entry.duration / 1000.0f;
+            item["background"] = entry.background;
+        }
+    }
+} // namespace Boot
\ No newline at end of file
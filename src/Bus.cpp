@@ -0,0 +1,93 @@
+#include <Arduino.h>
+
+#include <Wire.h>
+#include <atomic>
+#include <deque>
+#include <esp_log.h>
+#include <functional>
+#include <mutex>
+
+#include "Bus.hpp"
+#include "Peripherals.hpp"
+
+namespace Bus
+{
+    static constexpr auto FREQUENCY = 400000u;
+
+    static std::mutex jobsMutex = {};
+    static std::deque<std::function<void()>> jobs = {};
+    static std::atomic<uint32_t> errorCount = 0;
+
+    auto init() -> void
+    {
+        log_d( "begin" );
+
+        if ( not Wire.begin( Peripherals::BME280::SDA, Peripherals::BME280::SCL, FREQUENCY ) )
+        {
+            log_e( "bus init error" );
+        }
+
+        log_d( "end" );
+    }
+
+    auto process() -> void
+    {
+        auto job = std::function<void()>{};
+        {
+            const auto lock = std::lock_guard<std::mutex>{jobsMutex};
+            if ( jobs.empty() )
+            {
+                return;
+            }
+            job = std::move( jobs.front() );
+            jobs.pop_front();
+        }
+        job();
+    }
+
+    auto submit( std::function<void()> job ) -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{jobsMutex};
+        jobs.emplace_back( std::move( job ) );
+    }
+
+    auto write( uint8_t address, uint8_t reg, uint8_t value ) -> bool
+    {
+        Wire.beginTransmission( address );
+        Wire.write( reg );
+        Wire.write( value );
+        if ( Wire.endTransmission() != 0 )
+        {
+            Bus::error();
+            return false;
+        }
+        return true;
+    }
+
+    auto read( uint8_t address, uint8_t reg, uint8_t* data, std::size_t length ) -> bool
+    {
+        Wire.beginTransmission( address );
+        Wire.write( reg );
+        if ( Wire.endTransmission( false ) != 0 or Wire.requestFrom( address, static_cast<uint8_t>( length ) ) != length )
+        {
+            Bus::error();
+            return false;
+        }
+        for ( auto n = 0u; n < length; n++ )
+        {
+            data[n] = Wire.read();
+        }
+        return true;
+    }
+
+    auto error() -> void
+    {
+        errorCount += 1;
+        log_e( "bus errors = %u", errorCount.load() );
+    }
+
+    auto errors() -> uint32_t
+    {
+        return errorCount;
+    }
+} // namespace Bus
\ No newline at end of file
@@ -0,0 +1,126 @@
+#include <Arduino.h>
+
+#include <algorithm>
+#include <array>
+#include <esp_log.h>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "Classifier.hpp"
+#include "Configuration.hpp"
+
+namespace Classifier
+{
+    static constexpr auto defaultWindDirection = Classifier::compile( Configuration::WindDirection::defaults );
+    static constexpr auto defaultRainIntensity = Classifier::compile( Configuration::RainIntensity::defaults );
+
+    struct Tables
+    {
+        Table windDirection;
+        Table rainIntensity;
+    };
+
+    // Trocadas por inteiro, quem está classificando continua com a versão anterior
+    static std::shared_ptr<const Tables> tables = std::make_shared<const Tables>( Tables{ defaultWindDirection, defaultRainIntensity } );
+
+    template<typename Range>
+    static auto valid( const Range& threshould ) -> bool
+    {
+        return threshould.first <= threshould.second and threshould.second < RESOLUTION;
+    }
+
+    // Roda na tarefa do servidor web, de pilha curta: compara as faixas entre si em vez de marcar cada leitura
+    template<typename Threshoulds>
+    static auto inspect( const char* name, const Threshoulds& threshoulds, std::vector<std::string>& warnings ) -> void
+    {
+        // A cobertura só muda no início de uma faixa ou logo depois do fim dela
+        auto edges = std::array<std::size_t, 2 * std::tuple_size_v<Threshoulds> + 2>{};
+        auto count = std::size_t{0};
+        edges[count++] = 0;
+        edges[count++] = RESOLUTION;
+        for ( const auto& [value, threshould] : threshoulds )
+        {
+            if ( not Classifier::valid( threshould ) )
+            {
+                warnings.emplace_back( std::string{name} + ": invalid range " + std::to_string( threshould.first ) + "-" + std::to_string( threshould.second ) );
+                continue;
+            }
+            edges[count++] = threshould.first;
+            edges[count++] = threshould.second + 1u;
+        }
+        std::sort( edges.begin(), edges.begin() + count );
+        count = std::unique( edges.begin(), edges.begin() + count ) - edges.begin();
+
+        const auto coverage = [&threshoulds]( std::size_t n )
+        {
+            auto covered = 0;
+            for ( const auto& [value, threshould] : threshoulds )
+            {
+                covered += Classifier::valid( threshould ) and threshould.first <= n and n <= threshould.second ? 1 : 0;
+            }
+            return std::min( covered, 2 );
+        };
+
+        auto i = std::size_t{0};
+        while ( i + 1 < count )
+        {
+            const auto covered = coverage( edges[i] );
+            auto last = i + 1;
+            while ( last + 1 < count and coverage( edges[last] ) == covered )
+            {
+                last += 1;
+            }
+            if ( covered != 1 )
+            {
+                warnings.emplace_back( std::string{name} + ( covered == 0 ? ": gap " : ": overlap " ) + std::to_string( edges[i] ) + "-" + std::to_string( edges[last] - 1 ) );
+            }
+            i = last;
+        }
+    }
+
+    auto load( const Configuration& cfg ) -> void
+    {
+        auto compiled = std::make_shared<Tables>();
+        compiled->windDirection = Classifier::compile( cfg.windDirection.threshoulds );
+        compiled->rainIntensity = Classifier::compile( cfg.rainIntensity.threshoulds );
+
+        std::atomic_store( &tables, std::shared_ptr<const Tables>{ std::move( compiled ) } );
+    }
+
+    auto validate( const Configuration& cfg ) -> std::vector<std::string>
+    {
+        auto warnings = std::vector<std::string>{};
+
+        Classifier::inspect( "wind_direction", cfg.windDirection.threshoulds, warnings );
+        Classifier::inspect( "rain_intensity", cfg.rainIntensity.threshoulds, warnings );
+
+        for ( const auto& warning : warnings )
+        {
+            log_w( "%s", warning.c_str() );
+        }
+
+        return warnings;
+    }
+
+    auto windDirection( uint16_t value ) -> std::optional<::WindDirection>
+    {
+        const auto entry = std::atomic_load( &tables )->windDirection[std::min<std::size_t>( value, RESOLUTION - 1 )];
+        if ( entry == 0 )
+        {
+            return {};
+        }
+        return static_cast<::WindDirection>( entry - 1 );
+    }
+
+    auto rainIntensity( uint16_t value ) -> std::optional<::RainIntensity>
+    {
+        const auto entry = std::atomic_load( &tables )->rainIntensity[std::min<std::size_t>( value, RESOLUTION - 1 )];
+        if ( entry == 0 )
+        {
+            return {};
+        }
+        return static_cast<::RainIntensity>( entry - 1 );
+    }
+} // namespace Classifier
\ No newline at end of file
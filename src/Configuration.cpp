@@ -1,14 +1,20 @@
 #include <Arduino.h>
 
 #include <ArduinoJson.hpp>
+#include <algorithm>
 #include <LittleFS.h>
 #include <FastCRC.h>
-#include <WiFi.h>
+#include <Preferences.h>
+#include <esp_system.h>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <esp_log.h>
+#include <mutex>
 #include <string>
+#include <type_traits>
 
+#include "Classifier.hpp"
 #include "Configuration.hpp"
 #include "Peripherals.hpp"
 #include "Utils.hpp"
@@ -47,30 +53,42 @@ static const Configuration defaultCfg
     },
     .windSpeed = {
         .radius = 0.15,
+        .cadence = 250,
     },
     .windDirection = {
-        .threshoulds = {
-            {
-                {WindDirection::SOUTHWEST, {47, 52}},
-                {WindDirection::SOUTH,     {518, 572}},
-                {WindDirection::WEST,      {1078, 1192}},
-                {WindDirection::SOUTHEAST, {1222, 1351}},
-                {WindDirection::NORTHWEST, {1966, 2173}},
-                {WindDirection::EAST,      {2508, 2772}},
-                {WindDirection::NORTH,     {3094, 3420}},
-                {WindDirection::NORTHEAST, {3809, 4095}},
-            }
-        }
+        .threshoulds = Configuration::WindDirection::defaults
     },
     .rainIntensity = {
-        .threshoulds = {
-            {RainIntensity::DRY,   {   0, 1000}},
-            {RainIntensity::HUMID, {1001, 2000}},
-            {RainIntensity::RAINY, {2001, 4095}},
-        }
+        .threshoulds = Configuration::RainIntensity::defaults
+    },
+    .deepSleep = {
+        .enabled = false,
+        .interval = 10,
+        .window = 900,
+        .awake = 300,
+        .online = 0,
+    },
+    .source = {
+        .type = SensorSource::HARDWARE,
+        .file = "/sd/data.csv",
+        .speed = 1,
+    },
+    .archive = {
+        .enabled = false,
+        .retention = 7,
+    },
+    .uplink = {
+        .enabled = false,
+        .protocol = UplinkProtocol::HTTP,
+        .url = "http://192.168.1.100:8080/upload",
+        .topic = "weather/station",
+        .batch = 32,
+        .interval = 3600,
     }
 };
 
+static std::shared_ptr<const Configuration> current = std::make_shared<const Configuration>( defaultCfg );
+
 static std::array<uint8_t, 6> stationMAC{};
 static std::array<uint8_t, 6> accessPointMAC{};
 
@@ -78,14 +96,14 @@ auto Configuration::init() -> void
 {
     log_d( "begin" );
 
-    WiFi.mode( WIFI_MODE_APSTA );
-    WiFi.macAddress( stationMAC.data() );
-    WiFi.softAPmacAddress( accessPointMAC.data() );
-    WiFi.mode( WIFI_MODE_NULL );
+    // Lidos direto do eFuse, sem ligar o rádio
+    esp_read_mac( stationMAC.data(), ESP_MAC_WIFI_STA );
+    esp_read_mac( accessPointMAC.data(), ESP_MAC_WIFI_SOFTAP );
 
     log_d( "end" );
 }
 
+// Textos entram por referência, sem cópia: o documento não pode durar mais que esta configuração
 auto Configuration::serialize( ArduinoJson::JsonVariant& json ) const -> void
 {
     {
@@ -107,8 +125,8 @@ auto Configuration::serialize( ArduinoJson::JsonVariant& json ) const -> void
             json["access_point"]["gateway"].add( n );
         }
         json["access_point"]["port"] = this->accessPoint.port;
-        json["access_point"]["user"] = this->accessPoint.user;
-        json["access_point"]["password"] = this->accessPoint.password;
+        json["access_point"]["user"] = this->accessPoint.user.c_str();
+        json["access_point"]["password"] = this->accessPoint.password.c_str();
         json["access_point"]["duration"] = this->accessPoint.duration;
     }
     {
@@ -130,8 +148,8 @@ auto Configuration::serialize( ArduinoJson::JsonVariant& json ) const -> void
             json["station"]["gateway"].add( n );
         }
         json["station"]["port"] = this->station.port;
-        json["station"]["user"] = this->station.user;
-        json["station"]["password"] = this->station.password;
+        json["station"]["user"] = this->station.user.c_str();
+        json["station"]["password"] = this->station.password.c_str();
     }
     {
         json["temperature"]["factor"] = this->temperature.factor;
@@ -144,21 +162,46 @@ auto Configuration::serialize( ArduinoJson::JsonVariant& json ) const -> void
     }
     {
         json["wind_speed"]["radius"] = this->windSpeed.radius;
+        json["wind_speed"]["cadence"] = this->windSpeed.cadence;
     }
     {
         for(auto& [direction, threshould] : this->windDirection.threshoulds) 
         {
-            json["wind_direction"]["threshoulds"][Utils::WindDirection::getName(direction)]["min"] = threshould.first;
-            json["wind_direction"]["threshoulds"][Utils::WindDirection::getName(direction)]["max"] = threshould.second;
+            json["wind_direction"]["threshoulds"][Utils::WindDirection::getName(direction).data()]["min"] = threshould.first;
+            json["wind_direction"]["threshoulds"][Utils::WindDirection::getName(direction).data()]["max"] = threshould.second;
         }
     }
     {
         for(auto& [intensity, threshould] : this->rainIntensity.threshoulds) 
         {
-            json["rain_intensity"]["threshoulds"][Utils::RainIntensity::getName(intensity)]["min"] = threshould.first;
-            json["rain_intensity"]["threshoulds"][Utils::RainIntensity::getName(intensity)]["max"] = threshould.second;
+            json["rain_intensity"]["threshoulds"][Utils::RainIntensity::getName(intensity).data()]["min"] = threshould.first;
+            json["rain_intensity"]["threshoulds"][Utils::RainIntensity::getName(intensity).data()]["max"] = threshould.second;
         }
     }
+    {
+        json["deep_sleep"]["enabled"] = this->deepSleep.enabled;
+        json["deep_sleep"]["interval"] = this->deepSleep.interval;
+        json["deep_sleep"]["window"] = this->deepSleep.window;
+        json["deep_sleep"]["awake"] = this->deepSleep.awake;
+        json["deep_sleep"]["online"] = this->deepSleep.online;
+    }
+    {
+        json["source"]["type"] = Utils::SensorSource::getName(this->source.type).data();
+        json["source"]["file"] = this->source.file.c_str();
+        json["source"]["speed"] = this->source.speed;
+    }
+    {
+        json["archive"]["enabled"] = this->archive.enabled;
+        json["archive"]["retention"] = this->archive.retention;
+    }
+    {
+        json["uplink"]["enabled"] = this->uplink.enabled;
+        json["uplink"]["protocol"] = Utils::UplinkProtocol::getName(this->uplink.protocol).data();
+        json["uplink"]["url"] = this->uplink.url.c_str();
+        json["uplink"]["topic"] = this->uplink.topic.c_str();
+        json["uplink"]["batch"] = this->uplink.batch;
+        json["uplink"]["interval"] = this->uplink.interval;
+    }
 }
 
 auto Configuration::deserialize( const ArduinoJson::JsonVariant& json ) -> void
@@ -232,14 +275,15 @@ auto Configuration::deserialize( const ArduinoJson::JsonVariant& json ) -> void
     if(json.containsKey("wind_speed"))
     {
         this->windSpeed.radius = json["wind_speed"]["radius"] | 1.0;
+        this->windSpeed.cadence = json["wind_speed"]["cadence"] | 250;
     }
 
     if(json.containsKey("wind_direction"))
     {
         for(auto& [direction, threshould] : this->windDirection.threshoulds) 
         {
-            threshould.first = json["wind_direction"]["threshoulds"][Utils::WindDirection::getName(direction)]["min"] | 0;
-            threshould.second = json["wind_direction"]["threshoulds"][Utils::WindDirection::getName(direction)]["max"] | 0;
+            threshould.first = json["wind_direction"]["threshoulds"][Utils::WindDirection::getName(direction).data()]["min"] | 0;
+            threshould.second = json["wind_direction"]["threshoulds"][Utils::WindDirection::getName(direction).data()]["max"] | 0;
         }
     }
 
@@ -247,72 +291,457 @@ auto Configuration::deserialize( const ArduinoJson::JsonVariant& json ) -> void
     {
         for(auto& [intensity, threshould] : this->rainIntensity.threshoulds) 
         {
-            threshould.first = json["rain_intensity"]["threshoulds"][Utils::RainIntensity::getName(intensity)]["min"] | 0;
-            threshould.second = json["rain_intensity"]["threshoulds"][Utils::RainIntensity::getName(intensity)]["max"] | 0;
+            threshould.first = json["rain_intensity"]["threshoulds"][Utils::RainIntensity::getName(intensity).data()]["min"] | 0;
+            threshould.second = json["rain_intensity"]["threshoulds"][Utils::RainIntensity::getName(intensity).data()]["max"] | 0;
         }
     }
+
+    if(json.containsKey("deep_sleep"))
+    {
+        this->deepSleep.enabled = json["deep_sleep"]["enabled"] | false;
+        this->deepSleep.interval = json["deep_sleep"]["interval"] | 10;
+        this->deepSleep.window = json["deep_sleep"]["window"] | 900;
+        this->deepSleep.awake = json["deep_sleep"]["awake"] | 300;
+        this->deepSleep.online = json["deep_sleep"]["online"] | 0;
+        this->deepSleep.limit();
+    }
+
+    if(json.containsKey("source"))
+    {
+        this->source.type = Utils::SensorSource::getValue(json["source"]["type"] | "Real");
+        this->source.file = json["source"]["file"] | "/sd/data.csv";
+        this->source.speed = std::clamp<uint16_t>(json["source"]["speed"] | 1, 1, 1000);
+    }
+
+    if(json.containsKey("archive"))
+    {
+        this->archive.enabled = json["archive"]["enabled"] | false;
+        this->archive.retention = std::clamp<uint16_t>(json["archive"]["retention"] | 7, 1, 365);
+    }
+
+    if(json.containsKey("uplink"))
+    {
+        this->uplink.enabled = json["uplink"]["enabled"] | false;
+        this->uplink.protocol = Utils::UplinkProtocol::getValue(json["uplink"]["protocol"] | "HTTP");
+        this->uplink.url = json["uplink"]["url"] | "http://192.168.1.100:8080/upload";
+        this->uplink.topic = json["uplink"]["topic"] | "weather/station";
+        this->uplink.batch = std::clamp<uint16_t>(json["uplink"]["batch"] | 32, 1, 64);
+        this->uplink.interval = std::clamp<uint16_t>(json["uplink"]["interval"] | 3600, 60, 43200);
+    }
 }
 
-auto Configuration::load( Configuration* cfg ) -> void
+// Registro binário gravado na NVS, o JSON fica só para importar e exportar
+namespace Record
 {
-    log_d( "begin" );
+    static constexpr auto NAMESPACE = "configuration";
+    static constexpr auto KEY = "record";
+    static constexpr auto VERSION = uint16_t{3};
 
-    *cfg = defaultCfg;
+    struct __attribute__((packed)) Network
+    {
+        bool enabled;
+        std::array<uint8_t, 4> ip;
+        std::array<uint8_t, 4> netmask;
+        std::array<uint8_t, 4> gateway;
+        uint16_t port;
+        std::array<char, 33> user;
+        std::array<char, 65> password;
+    };
+
+    struct __attribute__((packed)) Range
+    {
+        uint16_t min;
+        uint16_t max;
+    };
 
-    if ( not LittleFS.exists( "/configuration.json" ) )
+    struct __attribute__((packed)) Data
+    {
+        uint16_t version;
+        uint16_t length;
+        Network station;
+        Network accessPoint;
+        uint16_t duration;
+        float temperature;
+        float humidity;
+        float pressure;
+        float radius;
+        uint16_t cadence;
+        std::array<Range, 8> windDirection;
+        std::array<Range, 3> rainIntensity;
+        bool deepSleep;
+        uint16_t interval;
+        uint16_t window;
+        uint16_t awake;
+        uint16_t online;
+        uint8_t source;
+        std::array<char, 65> file;
+        uint16_t speed;
+        bool archive;
+        uint16_t retention;
+        bool uplink;
+        uint8_t protocol;
+        std::array<char, 97> url;
+        std::array<char, 65> topic;
+        uint16_t batch;
+        uint16_t period;
+        uint32_t crc;
+    };
+
+    template<std::size_t N>
+    static auto copy( std::array<char, N>& to, const FixedString<N>& from ) -> void
     {
-        log_d( "file not found" );
+        to = {};
+        std::strncpy( to.data(), from.c_str(), N - 1 );
     }
-    else
+
+    template<std::size_t N>
+    static auto copy( FixedString<N>& to, const std::array<char, N>& from ) -> void
+    {
+        to.assign( { from.data(), strnlen( from.data(), N ) } );
+    }
+
+    static_assert( std::is_trivially_copyable_v<Data> );
+
+    static auto crc( const Data& data ) -> uint32_t
+    {
+        auto fastCRC = FastCRC32{};
+        return fastCRC.crc32( reinterpret_cast<const uint8_t*>( &data ), offsetof( Data, crc ) );
+    }
+
+    // Registros em memória estática: o save roda na tarefa do async_tcp, de pilha curta
+    static std::mutex bufferMutex = {};
+    static Data buffer = {};
+    static Data stored = {};
+
+    static auto pack( const Configuration& cfg, Data* record ) -> void
     {
-        auto file{LittleFS.open( "/configuration.json", FILE_READ )};
-        if ( not file )
+        auto& data = *record;
+        data = Data{};
+
+        data.version = VERSION;
+        data.length = sizeof( Data );
+
+        data.station.enabled = cfg.station.enabled;
+        data.station.ip = cfg.station.ip;
+        data.station.netmask = cfg.station.netmask;
+        data.station.gateway = cfg.station.gateway;
+        data.station.port = cfg.station.port;
+        Record::copy( data.station.user, cfg.station.user );
+        Record::copy( data.station.password, cfg.station.password );
+
+        data.accessPoint.enabled = cfg.accessPoint.enabled;
+        data.accessPoint.ip = cfg.accessPoint.ip;
+        data.accessPoint.netmask = cfg.accessPoint.netmask;
+        data.accessPoint.gateway = cfg.accessPoint.gateway;
+        data.accessPoint.port = cfg.accessPoint.port;
+        Record::copy( data.accessPoint.user, cfg.accessPoint.user );
+        Record::copy( data.accessPoint.password, cfg.accessPoint.password );
+        data.duration = cfg.accessPoint.duration;
+
+        data.temperature = cfg.temperature.factor;
+        data.humidity = cfg.humidity.factor;
+        data.pressure = cfg.pressure.factor;
+        data.radius = cfg.windSpeed.radius;
+        data.cadence = cfg.windSpeed.cadence;
+
+        for ( const auto& [direction, threshould] : cfg.windDirection.threshoulds )
         {
-            log_e( "file error" );
+            data.windDirection.at( static_cast<std::size_t>( direction ) - 1 ) = Range{ threshould.first, threshould.second };
         }
-        else
+        for ( const auto& [intensity, threshould] : cfg.rainIntensity.threshoulds )
         {
-            auto doc{ArduinoJson::DynamicJsonDocument{3072}};
-            auto err{ArduinoJson::deserializeJson( doc, file )};
-            file.close();
-
-            if ( err != ArduinoJson::DeserializationError::Ok )
-            {
-                log_d( "json error = %s", err.c_str() );
-            }
-            else
-            {
-                auto json{doc.as<ArduinoJson::JsonVariant>()};
-                cfg->deserialize( json );
-            }
+            data.rainIntensity.at( static_cast<std::size_t>( intensity ) ) = Range{ threshould.first, threshould.second };
         }
+
+        data.deepSleep = cfg.deepSleep.enabled;
+        data.interval = cfg.deepSleep.interval;
+        data.window = cfg.deepSleep.window;
+        data.awake = cfg.deepSleep.awake;
+        data.online = cfg.deepSleep.online;
+
+        data.source = static_cast<uint8_t>( cfg.source.type );
+        Record::copy( data.file, cfg.source.file );
+        data.speed = cfg.source.speed;
+
+        data.archive = cfg.archive.enabled;
+        data.retention = cfg.archive.retention;
+
+        data.uplink = cfg.uplink.enabled;
+        data.protocol = static_cast<uint8_t>( cfg.uplink.protocol );
+        Record::copy( data.url, cfg.uplink.url );
+        Record::copy( data.topic, cfg.uplink.topic );
+        data.batch = cfg.uplink.batch;
+        data.period = cfg.uplink.interval;
+
+        data.crc = Record::crc( data );
     }
 
-    Configuration::save( *cfg );
+    static auto unpack( const Data& data, Configuration* cfg ) -> void
+    {
+        cfg->station.enabled = data.station.enabled;
+        cfg->station.mac = stationMAC;
+        cfg->station.ip = data.station.ip;
+        cfg->station.netmask = data.station.netmask;
+        cfg->station.gateway = data.station.gateway;
+        cfg->station.port = data.station.port;
+        Record::copy( cfg->station.user, data.station.user );
+        Record::copy( cfg->station.password, data.station.password );
+
+        cfg->accessPoint.enabled = data.accessPoint.enabled;
+        cfg->accessPoint.mac = accessPointMAC;
+        cfg->accessPoint.ip = data.accessPoint.ip;
+        cfg->accessPoint.netmask = data.accessPoint.netmask;
+        cfg->accessPoint.gateway = data.accessPoint.gateway;
+        cfg->accessPoint.port = data.accessPoint.port;
+        Record::copy( cfg->accessPoint.user, data.accessPoint.user );
+        Record::copy( cfg->accessPoint.password, data.accessPoint.password );
+        cfg->accessPoint.duration = data.duration;
+
+        cfg->temperature.factor = data.temperature;
+        cfg->humidity.factor = data.humidity;
+        cfg->pressure.factor = data.pressure;
+        cfg->windSpeed.radius = data.radius;
+        cfg->windSpeed.cadence = data.cadence;
+
+        for ( auto& [direction, threshould] : cfg->windDirection.threshoulds )
+        {
+            const auto& range = data.windDirection.at( static_cast<std::size_t>( direction ) - 1 );
+            threshould = { range.min, range.max };
+        }
+        for ( auto& [intensity, threshould] : cfg->rainIntensity.threshoulds )
+        {
+            const auto& range = data.rainIntensity.at( static_cast<std::size_t>( intensity ) );
+            threshould = { range.min, range.max };
+        }
 
-    log_d( "end" );
-}
+        cfg->deepSleep.enabled = data.deepSleep;
+        cfg->deepSleep.interval = data.interval;
+        cfg->deepSleep.window = data.window;
+        cfg->deepSleep.awake = data.awake;
+        cfg->deepSleep.online = data.online;
+        cfg->deepSleep.limit();
+
+        cfg->source.type = static_cast<SensorSource>( data.source );
+        Record::copy( cfg->source.file, data.file );
+        cfg->source.speed = data.speed;
+
+        cfg->archive.enabled = data.archive;
+        cfg->archive.retention = data.retention;
+
+        cfg->uplink.enabled = data.uplink;
+        cfg->uplink.protocol = static_cast<UplinkProtocol>( data.protocol );
+        Record::copy( cfg->uplink.url, data.url );
+        Record::copy( cfg->uplink.topic, data.topic );
+        cfg->uplink.batch = data.batch;
+        cfg->uplink.interval = data.period;
+    }
 
-auto Configuration::save( const Configuration& cfg ) -> void
+    // Chamado com o bufferMutex; o gravado é comparado inteiro, o crc só confere a integridade
+    static auto store( const Data& data ) -> bool
+    {
+        auto preferences = Preferences{};
+        if ( not preferences.begin( NAMESPACE, false ) )
+        {
+            log_e( "nvs open error" );
+            return false;
+        }
+
+        const auto present = preferences.getBytesLength( KEY ) == sizeof( Data ) and preferences.getBytes( KEY, &stored, sizeof( Data ) ) == sizeof( Data );
+        if ( present and std::memcmp( &stored, &data, sizeof( Data ) ) == 0 )
+        {
+            preferences.end();
+            log_d( "record unchanged" );
+            return true;
+        }
+
+        const auto length = preferences.putBytes( KEY, &data, sizeof( Data ) );
+        preferences.end();
+
+        if ( length != sizeof( Data ) )
+        {
+            log_e( "nvs write error" );
+            return false;
+        }
+
+        log_d( "record written, crc = %08X", data.crc );
+        return true;
+    }
+
+    // Campos novos entram sempre antes do crc, então um registro antigo é o início do atual
+    static auto upgrade( Data* data, std::size_t length ) -> bool
+    {
+        const auto body = length - sizeof( uint32_t );
+        const auto version = data->version;
+
+        if ( length < offsetof( Data, station ) + sizeof( uint32_t ) or version >= VERSION or data->length != length )
+        {
+            return false;
+        }
+
+        auto fastCRC = FastCRC32{};
+        auto crc = uint32_t{};
+        std::memcpy( &crc, reinterpret_cast<const uint8_t*>( data ) + body, sizeof( crc ) );
+        if ( crc != fastCRC.crc32( reinterpret_cast<const uint8_t*>( data ), body ) )
+        {
+            log_e( "record crc error" );
+            return false;
+        }
+
+        const auto lock = std::lock_guard<std::mutex>{bufferMutex};
+
+        // Campos que o registro antigo não tinha vêm do padrão
+        Record::pack( defaultCfg, &buffer );
+        std::memcpy( reinterpret_cast<uint8_t*>( data ) + body, reinterpret_cast<const uint8_t*>( &buffer ) + body, sizeof( Data ) - body );
+        data->version = VERSION;
+        data->length = sizeof( Data );
+        data->crc = Record::crc( *data );
+
+        // Gravado já convertido, os próximos boots leem a versão atual
+        if ( not Record::store( *data ) )
+        {
+            log_e( "upgraded record not saved" );
+        }
+
+        log_d( "record upgraded from version %u", version );
+        return true;
+    }
+
+    static auto valid( const Data& data ) -> bool
+    {
+        return data.version == VERSION and data.length == sizeof( Data ) and data.crc == Record::crc( data );
+    }
+
+    static auto read( Data* data ) -> bool
+    {
+        auto preferences = Preferences{};
+        if ( not preferences.begin( NAMESPACE, true ) )
+        {
+            log_d( "nvs namespace not found" );
+            return false;
+        }
+
+        const auto length = preferences.getBytes( KEY, data, sizeof( Data ) );
+        preferences.end();
+
+        if ( length > 0 and length < sizeof( Data ) )
+        {
+            return Record::upgrade( data, length );
+        }
+
+        if ( length != sizeof( Data ) or data->version != VERSION or data->length != sizeof( Data ) )
+        {
+            log_d( "record missing or outdated, length = %u", length );
+            return false;
+        }
+
+        if ( not Record::valid( *data ) )
+        {
+            log_e( "record crc error" );
+            return false;
+        }
+
+        return true;
+    }
+
+    static auto write( const Configuration& cfg ) -> bool
+    {
+        const auto lock = std::lock_guard<std::mutex>{bufferMutex};
+
+        Record::pack( cfg, &buffer );
+        return Record::store( buffer );
+    }
+} // namespace Record
+
+// Um /configuration.json enviado é importado uma vez para a NVS e removido, com erro fica como .bad para ser conferido
+static auto import( Configuration* cfg ) -> bool
 {
-    log_d( "begin" );
+    if ( not LittleFS.exists( "/configuration.json" ) )
+    {
+        return false;
+    }
 
-    auto file{LittleFS.open( "/configuration.json", FILE_WRITE )};
+    auto file{LittleFS.open( "/configuration.json", FILE_READ )};
     if ( not file )
     {
         log_e( "file error" );
-        std::abort();
+        return false;
     }
 
     auto doc{ArduinoJson::DynamicJsonDocument{3072}};
+    auto err{ArduinoJson::deserializeJson( doc, file )};
+    file.close();
+
+    if ( err != ArduinoJson::DeserializationError::Ok )
+    {
+        log_e( "json error = %s", err.c_str() );
+        LittleFS.remove( "/configuration.json.bad" );
+        if ( not LittleFS.rename( "/configuration.json", "/configuration.json.bad" ) )
+        {
+            log_e( "rename error" );
+        }
+        return false;
+    }
+
+    LittleFS.remove( "/configuration.json" );
+
     auto json{doc.as<ArduinoJson::JsonVariant>()};
+    cfg->deserialize( json );
 
-    cfg.serialize( json );
+    log_d( "file imported" );
+    return true;
+}
 
-    ArduinoJson::serializeJsonPretty( doc, file );
-    file.close();
+auto Configuration::load() -> void
+{
+    log_d( "begin" );
+
+    auto loaded{defaultCfg};
+    auto data = Record::Data{};
+
+    if ( import( &loaded ) )
+    {
+        Configuration::save( loaded );
+    }
+    else if ( Record::read( &data ) )
+    {
+        Record::unpack( data, &loaded );
+    }
+    else
+    {
+        Configuration::save( loaded );
+    }
+
+    Configuration::publish( loaded );
 
     log_d( "end" );
 }
 
-Configuration cfg{};
\ No newline at end of file
+auto Configuration::save( const Configuration& cfg ) -> void
+{
+    log_d( "begin" );
+
+    if ( not Record::write( cfg ) )
+    {
+        log_e( "save error" );
+    }
+
+    log_d( "end" );
+}
+
+auto Configuration::publish( const Configuration& cfg ) -> void
+{
+    std::atomic_store( &current, std::make_shared<const Configuration>( cfg ) );
+    Classifier::load( cfg );
+}
+
+auto Configuration::Snapshot::get() const -> std::shared_ptr<const Configuration>
+{
+    return std::atomic_load( &current );
+}
+
+auto Configuration::Snapshot::operator->() const -> std::shared_ptr<const Configuration>
+{
+    return std::atomic_load( &current );
+}
+
+const Configuration::Snapshot cfg{};
\ No newline at end of file
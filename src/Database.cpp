@@ -8,28 +8,114 @@
 #include <thread>
 #include <array>
 #include <numeric>
+#include <cmath>
 #include <LittleFS.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <deque>
+#include <limits>
+#include <mutex>
 
+#include "Boot.hpp"
 #include "Configuration.hpp"
 #include "Database.hpp"
 #include "Peripherals.hpp"
 #include "Utils.hpp"
 #include "Infos.hpp"
 #include "RealTime.hpp"
+#include "Vfs.hpp"
+
+// Ponto de montagem do cartão, no env:native um diretório do host
+#ifndef DATABASE_ROOT
+#define DATABASE_ROOT "/sd"
+#endif
 
 namespace Database
 {
     static sqlite3* db = nullptr;
-    static std::vector<Infos::SensorData> rolling = {};
-    static std::size_t index = 0u;
+    static constexpr auto SAMPLE_PERIOD = std::time_t{10};
+    static constexpr auto RECORD_PERIOD = std::time_t{15 * 60};
+    // Passos recuperados por passada do loop quando o relógio da fonte corre à frente
+    static constexpr auto CATCH_UP = 16u;
+
+    static Accumulator window = {};
+    static std::time_t paced = 0;
+    static std::vector<Infos::SensorData> samples = {};
+
+    // Registros mais recentes em ordem, tudo a partir de covered está aqui
+    namespace Hot
+    {
+        static constexpr auto CAPACITY = std::size_t{208};
+        static constexpr auto MARGIN = std::time_t{3600};
+
+        static std::mutex recordsMutex = {};
+        static std::deque<Infos::SensorData> records = {};
+        static std::time_t covered = std::numeric_limits<std::time_t>::max();
+
+        static auto less( const Infos::SensorData& sensorData, std::time_t dateTime ) -> bool
+        {
+            return sensorData.dateTime < dateTime;
+        }
+
+        static auto insert( const Infos::SensorData& sensorData ) -> void
+        {
+            const auto lock = std::lock_guard<std::mutex>{recordsMutex};
+
+            if ( sensorData.dateTime < covered )
+            {
+                return;
+            }
+
+            records.insert( std::lower_bound( records.begin(), records.end(), sensorData.dateTime, Hot::less ), sensorData );
+
+            if ( records.size() > CAPACITY )
+            {
+                records.pop_front();
+                covered = records.front().dateTime;
+            }
+        }
+
+        static auto erase( std::time_t start, std::time_t end ) -> void
+        {
+            const auto lock = std::lock_guard<std::mutex>{recordsMutex};
+
+            records.erase( std::lower_bound( records.begin(), records.end(), start, Hot::less ), std::upper_bound( records.begin(), records.end(), end, []( std::time_t dateTime, const auto& sensorData ){ return dateTime < sensorData.dateTime; } ) );
+        }
+
+        // Margem para uma consulta longa não perder registros descartados enquanto lê o cartão
+        static auto split() -> std::time_t
+        {
+            const auto lock = std::lock_guard<std::mutex>{recordsMutex};
+
+            if ( covered == std::numeric_limits<std::time_t>::min() or covered == std::numeric_limits<std::time_t>::max() )
+            {
+                return covered;
+            }
+            return covered + MARGIN;
+        }
+
+        static auto next( std::time_t from, std::time_t end ) -> std::optional<Infos::SensorData>
+        {
+            const auto lock = std::lock_guard<std::mutex>{recordsMutex};
+
+            const auto it = std::lower_bound( records.begin(), records.end(), from, Hot::less );
+            if ( it == records.end() or it->dateTime > end )
+            {
+                return {};
+            }
+            return *it;
+        }
+    } // namespace Hot
 
     static auto initializeDatabase() -> void
     {
         log_d( "begin" );
 
         sqlite3_initialize();
+        Vfs::init();
 
-        const auto rc = sqlite3_open( "/sd/sensors_data.db", &db );
+        const auto rc = sqlite3_open_v2( DATABASE_ROOT "/sensors_data.db", &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, Vfs::NAME );
         if ( rc != SQLITE_OK )
         {
             log_e( "database open error: %s\n", sqlite3_errmsg( db ) );
@@ -39,19 +125,122 @@ namespace Database
         log_d( "end" );
     }
 
+    // Tabela antiga tinha DATE_TIME como chave e nenhuma sequência própria: refeita uma vez, na ordem de inserção
+    static auto sequence() -> void
+    {
+        const auto check = "SELECT COUNT(*) FROM pragma_table_info('SENSORS_DATA') WHERE name = 'SEQUENCE'";
+
+        sqlite3_stmt* res;
+        if ( sqlite3_prepare_v2( db, check, strlen( check ), &res, nullptr ) != SQLITE_OK )
+        {
+            log_e( "sequence check error: %s", sqlite3_errmsg( db ) );
+            return;
+        }
+        const auto present = sqlite3_step( res ) == SQLITE_ROW and sqlite3_column_int( res, 0 ) > 0;
+        sqlite3_finalize( res );
+
+        if ( present )
+        {
+            return;
+        }
+
+        log_d( "sequence migration begin" );
+
+        // Ainda com o journal padrão: uma queda no meio desfaz tudo. A marca do uplink passa do ROWID para a nova sequência
+        const auto command = " BEGIN TRANSACTION;                                                   "
+                             " CREATE TABLE SENSORS_DATA_SEQUENCE (                                 "
+                             "     SEQUENCE        INTEGER PRIMARY KEY AUTOINCREMENT,               "
+                             "     DATE_TIME       DATETIME UNIQUE NOT NULL,                        "
+                             "     TEMPERATURE     NUMERIC,                                         "
+                             "     HUMIDITY        NUMERIC,                                         "
+                             "     PRESSURE        NUMERIC,                                         "
+                             "     WIND_SPEED      NUMERIC,                                         "
+                             "     WIND_DIRECTION  INTEGER,                                         "
+                             "     RAIN_INTENSITY  INTEGER,                                         "
+                             "     WIND_GUST       NUMERIC,                                         "
+                             "     WIND_VECTOR     NUMERIC,                                         "
+                             "     WIND_STEADINESS NUMERIC                                          "
+                             " );                                                                   "
+                             " INSERT INTO SENSORS_DATA_SEQUENCE (                                  "
+                             "     DATE_TIME, TEMPERATURE, HUMIDITY, PRESSURE, WIND_SPEED,          "
+                             "     WIND_DIRECTION, RAIN_INTENSITY, WIND_GUST, WIND_VECTOR,          "
+                             "     WIND_STEADINESS                                                  "
+                             " )                                                                    "
+                             " SELECT                                                               "
+                             "     DATE_TIME, TEMPERATURE, HUMIDITY, PRESSURE, WIND_SPEED,          "
+                             "     WIND_DIRECTION, RAIN_INTENSITY, WIND_GUST, WIND_VECTOR,          "
+                             "     WIND_STEADINESS                                                  "
+                             " FROM SENSORS_DATA ORDER BY ROWID;                                    "
+                             " UPDATE UPLINK_STATE SET SEQUENCE = (                                 "
+                             "     SELECT COUNT(*) FROM SENSORS_DATA                                "
+                             "     WHERE SENSORS_DATA.ROWID <= UPLINK_STATE.SEQUENCE                "
+                             " ) WHERE SEQUENCE IS NOT NULL;                                        "
+                             " DROP TABLE SENSORS_DATA;                                             "
+                             " ALTER TABLE SENSORS_DATA_SEQUENCE RENAME TO SENSORS_DATA;            "
+                             " COMMIT TRANSACTION;                                                  ";
+
+        if ( sqlite3_exec( db, command, nullptr, nullptr, nullptr ) != SQLITE_OK )
+        {
+            log_e( "sequence migration error: %s", sqlite3_errmsg( db ) );
+            sqlite3_exec( db, " ROLLBACK TRANSACTION ", nullptr, nullptr, nullptr );
+            return;
+        }
+
+        log_d( "sequence migration end" );
+    }
+
     static auto createTable() -> void
     {
         log_d( "begin" );
         {
             const auto command = " CREATE TABLE IF NOT EXISTS                    "
                                  "     SENSORS_DATA (                            "
+                                 "         SEQUENCE        INTEGER PRIMARY KEY   "
+                                 "                         AUTOINCREMENT,        "
+                                 "         DATE_TIME       DATETIME UNIQUE       "
+                                 "                         NOT NULL,             "
+                                 "         TEMPERATURE     NUMERIC,              "
+                                 "         HUMIDITY        NUMERIC,              "
+                                 "         PRESSURE        NUMERIC,              "
+                                 "         WIND_SPEED      NUMERIC,              "
+                                 "         WIND_DIRECTION  INTEGER,              "
+                                 "         RAIN_INTENSITY  INTEGER,              "
+                                 "         WIND_GUST       NUMERIC,              "
+                                 "         WIND_VECTOR     NUMERIC,              "
+                                 "         WIND_STEADINESS NUMERIC               "
+                                 "     )                                         ";
+
+            const auto rc = sqlite3_exec( db, command, nullptr, nullptr, nullptr );
+            if ( rc != SQLITE_OK )
+            {
+                log_e( "table create error: %s\n", sqlite3_errmsg( db ) );
+            }
+        }
+        {
+            const auto command = " CREATE TABLE IF NOT EXISTS                    "
+                                 "     SAMPLES_DATA (                            "
                                  "         DATE_TIME       DATETIME PRIMARY KEY, "
                                  "         TEMPERATURE     NUMERIC,              "
                                  "         HUMIDITY        NUMERIC,              "
                                  "         PRESSURE        NUMERIC,              "
                                  "         WIND_SPEED      NUMERIC,              "
                                  "         WIND_DIRECTION  INTEGER,              "
-                                 "         RAIN_INTENSITY  INTEGER               "
+                                 "         RAIN_INTENSITY  INTEGER,              "
+                                 "         WIND_GUST       NUMERIC               "
+                                 "     )                                         ";
+
+            const auto rc = sqlite3_exec( db, command, nullptr, nullptr, nullptr );
+            if ( rc != SQLITE_OK )
+            {
+                log_e( "table create error: %s\n", sqlite3_errmsg( db ) );
+            }
+        }
+        {
+            const auto command = " CREATE TABLE IF NOT EXISTS                    "
+                                 "     UPLINK_STATE (                            "
+                                 "         ID              INTEGER PRIMARY KEY,  "
+                                 "         MARK            DATETIME,             "
+                                 "         SEQUENCE        INTEGER               "
                                  "     )                                         ";
 
             const auto rc = sqlite3_exec( db, command, nullptr, nullptr, nullptr );
@@ -60,6 +249,20 @@ namespace Database
                 log_e( "table create error: %s\n", sqlite3_errmsg( db ) );
             }
         }
+        for ( const auto command : {
+                  " ALTER TABLE SENSORS_DATA ADD COLUMN WIND_GUST NUMERIC ",
+                  " ALTER TABLE SENSORS_DATA ADD COLUMN WIND_VECTOR NUMERIC ",
+                  " ALTER TABLE SENSORS_DATA ADD COLUMN WIND_STEADINESS NUMERIC ",
+                  " ALTER TABLE SAMPLES_DATA ADD COLUMN WIND_GUST NUMERIC ",
+                  " ALTER TABLE UPLINK_STATE ADD COLUMN SEQUENCE INTEGER " } )
+        {
+            const auto rc = sqlite3_exec( db, command, nullptr, nullptr, nullptr );
+            if ( rc != SQLITE_OK )
+            {
+                log_d( "table alter skipped: %s\n", sqlite3_errmsg( db ) );
+            }
+        }
+        Database::sequence();
         {
             const auto command = " PRAGMA journal_mode = OFF ";
 
@@ -72,15 +275,98 @@ namespace Database
         log_d( "end" );
     }
 
-    static auto cleanup() -> void 
+    static auto row( sqlite3_stmt* res ) -> Infos::SensorData
+    {
+        return Infos::SensorData{
+            .dateTime = static_cast<std::time_t>(sqlite3_column_int64( res, 0 )),
+            .temperature = static_cast<float>(sqlite3_column_double( res, 1 )),
+            .humidity = static_cast<float>(sqlite3_column_double( res, 2 )),
+            .pressure = static_cast<float>(sqlite3_column_double( res, 3 )),
+            .windSpeed = static_cast<float>(sqlite3_column_double( res, 4 )),
+            .windGust = static_cast<float>(sqlite3_column_double( res, 7 )),
+            .windDirection = static_cast<WindDirection>(sqlite3_column_int( res, 5 )),
+            .rainIntensity = static_cast<RainIntensity>(sqlite3_column_int( res, 6 )),
+            .windVector = static_cast<float>(sqlite3_column_double( res, 8 )),
+            .windSteadiness = static_cast<float>(sqlite3_column_double( res, 9 )),
+        };
+    }
+
+    // Carrega os registros mais novos, independente do relógio já estar certo no boot
+    static auto preload() -> void
+    {
+        log_d( "begin" );
+
+        const auto query = " SELECT                 "
+                           "     DATE_TIME,         "
+                           "     TEMPERATURE,       "
+                           "     HUMIDITY,          "
+                           "     PRESSURE,          "
+                           "     WIND_SPEED,        "
+                           "     WIND_DIRECTION,    "
+                           "     RAIN_INTENSITY,    "
+                           "     WIND_GUST,         "
+                           "     WIND_VECTOR,       "
+                           "     WIND_STEADINESS    "
+                           " FROM                   "
+                           "     SENSORS_DATA       "
+                           " ORDER BY               "
+                           "     DATE_TIME DESC     "
+                           " LIMIT ?                ";
+
+        sqlite3_stmt* res;
+        if ( sqlite3_prepare_v2( db, query, strlen( query ), &res, nullptr ) != SQLITE_OK )
+        {
+            log_e( "preload prepare error: %s", sqlite3_errmsg( db ) );
+            return;
+        }
+
+        sqlite3_bind_int( res, 1, Hot::CAPACITY );
+
+        auto records = std::deque<Infos::SensorData>{};
+        while ( sqlite3_step( res ) == SQLITE_ROW )
+        {
+            records.push_front( Database::row( res ) );
+        }
+        sqlite3_finalize( res );
+
+        const auto full = records.size() == Hot::CAPACITY;
+        const auto lock = std::lock_guard<std::mutex>{Hot::recordsMutex};
+        Hot::records = std::move( records );
+        Hot::covered = full ? Hot::records.front().dateTime : std::numeric_limits<std::time_t>::min();
+
+        log_d( "end, records = %u", Hot::records.size() );
+    }
+
+    auto cleanup() -> void 
     {
         log_d("cleanup");
 
+        // Corte calculado uma vez, o mesmo vale para o cartão e para a memória
+        const auto cutoffQuery = "SELECT CAST(strftime('%s','now','-6 months') AS INTEGER)";
+
+        sqlite3_stmt* cutoffRes;
+        if ( sqlite3_prepare_v2( db, cutoffQuery, strlen( cutoffQuery ), &cutoffRes, nullptr ) != SQLITE_OK )
+        {
+            log_d("cleanup prepare error: %s", sqlite3_errmsg( db ));
+            return;
+        }
+        const auto cutoff = sqlite3_step( cutoffRes ) == SQLITE_ROW ? static_cast<std::time_t>( sqlite3_column_int64( cutoffRes, 0 ) ) : std::time_t{0};
+        sqlite3_finalize( cutoffRes );
+
         const auto query = "DELETE FROM SENSORS_DATA "
-                           "WHERE DATE_TIME < strftime('%s','now','-6 months')";
+                           "WHERE DATE_TIME < ?";
+
+        sqlite3_stmt* deleteRes;
+        if ( sqlite3_prepare_v2( db, query, strlen( query ), &deleteRes, nullptr ) != SQLITE_OK )
+        {
+            log_d("cleanup prepare error: %s", sqlite3_errmsg( db ));
+            return;
+        }
 
-        const auto rc = sqlite3_exec(db, query, nullptr, nullptr, nullptr);
-        if (rc != SQLITE_OK)
+        sqlite3_bind_int64( deleteRes, 1, cutoff );
+        const auto rc = sqlite3_step( deleteRes );
+        sqlite3_finalize( deleteRes );
+        if (rc != SQLITE_DONE)
         {
             log_d("cleanup error: %s", sqlite3_errmsg( db ));
             return;
@@ -88,9 +374,80 @@ namespace Database
 
         const auto deleted_rows = sqlite3_changes(db);
         log_d("deleted rows = %d", deleted_rows);
+
+        // Registros removidos não podem continuar saindo da memória
+        Hot::erase( std::numeric_limits<std::time_t>::min(), cutoff - 1 );
+
+        const auto samplesQuery = "DELETE FROM SAMPLES_DATA "
+                                  "WHERE DATE_TIME < strftime('%s','now') - ? * 86400";
+
+        sqlite3_stmt* res;
+        if ( sqlite3_prepare_v2( db, samplesQuery, strlen( samplesQuery ), &res, nullptr ) != SQLITE_OK )
+        {
+            log_d("cleanup prepare error: %s", sqlite3_errmsg( db ));
+            return;
+        }
+
+        sqlite3_bind_int( res, 1, cfg->archive.retention );
+        if ( sqlite3_step( res ) != SQLITE_DONE )
+        {
+            log_d("cleanup error: %s", sqlite3_errmsg( db ));
+        }
+        sqlite3_finalize( res );
+
+        log_d("deleted samples = %d", sqlite3_changes(db));
+    }
+
+    // Hora do registro mais recente, 0 com o banco vazio ou fechado
+    auto newest() -> std::time_t
+    {
+        if ( db == nullptr )
+        {
+            return 0;
+        }
+
+        const auto query = "SELECT MAX(DATE_TIME) FROM SENSORS_DATA";
+
+        sqlite3_stmt* res;
+        if ( sqlite3_prepare_v2( db, query, strlen( query ), &res, nullptr ) != SQLITE_OK )
+        {
+            log_e( "newest prepare error: %s", sqlite3_errmsg( db ) );
+            return 0;
+        }
+
+        const auto newest = sqlite3_step( res ) == SQLITE_ROW ? static_cast<std::time_t>( sqlite3_column_int64( res, 0 ) ) : std::time_t{0};
+        sqlite3_finalize( res );
+        return newest;
     }
 
-    static auto insert( const Infos::SensorData& sensorData ) -> void
+    auto erase( std::time_t start, std::time_t end ) -> void
+    {
+        log_d("erase");
+
+        const auto query = "DELETE FROM SENSORS_DATA "
+                           "WHERE DATE_TIME >= ? AND DATE_TIME <= ?";
+
+        sqlite3_stmt* res;
+        const auto rc = sqlite3_prepare_v2( db, query, strlen( query ), &res, nullptr );
+        if ( rc != SQLITE_OK )
+        {
+            log_e( "erase prepare error: %s", sqlite3_errmsg( db ) );
+            return;
+        }
+
+        sqlite3_bind_int64( res, 1, start );
+        sqlite3_bind_int64( res, 2, end );
+        if ( sqlite3_step( res ) != SQLITE_DONE )
+        {
+            log_e( "erase error: %s", sqlite3_errmsg( db ) );
+        }
+        Hot::erase( start, end );
+        sqlite3_finalize( res );
+
+        log_d("deleted rows = %d", sqlite3_changes(db));
+    }
+
+    auto insert( const Infos::SensorData& sensorData ) -> void
     {
         log_d("insert");
 
@@ -101,10 +458,13 @@ namespace Database
                            "     PRESSURE,              "
                            "     WIND_SPEED,            "
                            "     WIND_DIRECTION,        "
-                           "     RAIN_INTENSITY         "
+                           "     RAIN_INTENSITY,        "
+                           "     WIND_GUST,             "
+                           "     WIND_VECTOR,           "
+                           "     WIND_STEADINESS        "
                            " )                          "
                            " VALUES                     "
-                           "     (?,?,?,?,?,?,?)        ";
+                           "     (?,?,?,?,?,?,?,?,?,?)  ";
 
         sqlite3_stmt* res;
         const auto rc = sqlite3_prepare_v2( db, query, strlen( query ), &res, nullptr );
@@ -121,37 +481,201 @@ namespace Database
         sqlite3_bind_double( res, 5, sensorData.windSpeed );
         sqlite3_bind_int( res, 6, static_cast<int>(sensorData.windDirection));
         sqlite3_bind_int( res, 7, static_cast<int>(sensorData.rainIntensity));
+        sqlite3_bind_double( res, 8, sensorData.windGust );
+        sqlite3_bind_double( res, 9, sensorData.windVector );
+        sqlite3_bind_double( res, 10, sensorData.windSteadiness );
         if ( sqlite3_step( res ) != SQLITE_DONE )
         {
             log_e( "insert error: %s", sqlite3_errmsg( db ) );
         }
+        else
+        {
+            Hot::insert( sensorData );
+            Boot::mark( "first sample" );
+        }
         sqlite3_finalize( res );
     }
 
-    static auto generate() -> void
+    // Uma transação por janela, o cartão é sincronizado uma vez para todas as amostras
+    auto archive( const std::vector<Infos::SensorData>& samples ) -> void
+    {
+        log_d("archive, samples = %u", samples.size());
+
+        if ( samples.empty() )
+        {
+            return;
+        }
+
+        const auto query = " INSERT OR REPLACE INTO SAMPLES_DATA ( "
+                           "     DATE_TIME,                        "
+                           "     TEMPERATURE,                      "
+                           "     HUMIDITY,                         "
+                           "     PRESSURE,                         "
+                           "     WIND_SPEED,                       "
+                           "     WIND_DIRECTION,                   "
+                           "     RAIN_INTENSITY,                   "
+                           "     WIND_GUST                         "
+                           " )                                     "
+                           " VALUES                                "
+                           "     (?,?,?,?,?,?,?,?)                 ";
+
+        sqlite3_stmt* res;
+        if ( sqlite3_prepare_v2( db, query, strlen( query ), &res, nullptr ) != SQLITE_OK )
+        {
+            log_e( "archive prepare error: %s", sqlite3_errmsg( db ) );
+            return;
+        }
+
+        if ( sqlite3_exec( db, " BEGIN TRANSACTION ", nullptr, nullptr, nullptr ) != SQLITE_OK )
+        {
+            log_e( "archive begin error: %s", sqlite3_errmsg( db ) );
+            sqlite3_finalize( res );
+            return;
+        }
+        for ( const auto& sample : samples )
+        {
+            sqlite3_bind_int64( res, 1, sample.dateTime );
+            sqlite3_bind_double( res, 2, sample.temperature );
+            sqlite3_bind_double( res, 3, sample.humidity );
+            sqlite3_bind_double( res, 4, sample.pressure );
+            sqlite3_bind_double( res, 5, sample.windSpeed );
+            sqlite3_bind_int( res, 6, static_cast<int>(sample.windDirection));
+            sqlite3_bind_int( res, 7, static_cast<int>(sample.rainIntensity));
+            sqlite3_bind_double( res, 8, sample.windGust );
+            if ( sqlite3_step( res ) != SQLITE_DONE )
+            {
+                log_e( "archive error: %s", sqlite3_errmsg( db ) );
+            }
+            sqlite3_reset( res );
+        }
+        if ( sqlite3_exec( db, " COMMIT TRANSACTION ", nullptr, nullptr, nullptr ) != SQLITE_OK )
+        {
+            log_e( "archive commit error: %s", sqlite3_errmsg( db ) );
+        }
+        sqlite3_finalize( res );
+    }
+
+    auto Accumulator::add( const Infos::SensorData& sample ) -> void
+    {
+        const auto angle = Utils::WindDirection::getAngle( sample.windDirection ) * static_cast<float>( M_PI ) / 180.0f;
+        const auto x = std::sin( angle );
+        const auto y = std::cos( angle );
+
+        this->count += 1;
+        this->temperature += sample.temperature;
+        this->humidity += sample.humidity;
+        this->pressure += sample.pressure;
+        this->windSpeed += sample.windSpeed;
+        this->windGust = std::max( this->windGust, sample.windGust );
+        this->windX += sample.windSpeed * x;
+        this->windY += sample.windSpeed * y;
+        this->unitX += x;
+        this->unitY += y;
+        this->directions.at( static_cast<std::size_t>( sample.windDirection ) - 1 ) += 1;
+    }
+
+    auto Accumulator::result( const Infos::SensorData& current ) const -> Infos::SensorData
     {
-        const auto current = Infos::SensorData::get();
-        const auto average = Infos::SensorData{
+        if ( this->count == 0 )
+        {
+            return current;
+        }
+
+        const auto n = static_cast<float>( this->count );
+        const auto prevailing = std::distance( this->directions.begin(), std::max_element( this->directions.begin(), this->directions.end() ) );
+
+        // Com vento calmo o vetor ponderado é nulo, usa só as direções
+        const auto calm = this->windSpeed <= 0.0f;
+        const auto x = calm ? this->unitX : this->windX;
+        const auto y = calm ? this->unitY : this->windY;
+        const auto vector = std::fmod( std::atan2( x, y ) * 180.0f / static_cast<float>( M_PI ) + 360.0f, 360.0f );
+        const auto steadiness = std::hypot( x, y ) / ( calm ? n : this->windSpeed );
+
+        return Infos::SensorData{
             .dateTime = current.dateTime,
-            .temperature = std::accumulate(rolling.begin(), rolling.end(), 0.0f, [](auto v, const auto& s){ return v + s.temperature; }) / rolling.size(),
-            .humidity = std::accumulate(rolling.begin(), rolling.end(), 0.0f, [](auto v, const auto& s){ return v + s.humidity; }) / rolling.size(),
-            .pressure = std::accumulate(rolling.begin(), rolling.end(), 0.0f, [](auto v, const auto& s){ return v + s.pressure; }) / rolling.size(),
-            .windSpeed = std::accumulate(rolling.begin(), rolling.end(), 0.0f, [](auto v, const auto& s){ return v + s.windSpeed; }) / rolling.size(),
-            .windDirection = current.windDirection,
+            .temperature = this->temperature / n,
+            .humidity = this->humidity / n,
+            .pressure = this->pressure / n,
+            .windSpeed = this->windSpeed / n,
+            .windGust = this->windGust,
+            .windDirection = static_cast<WindDirection>( prevailing + 1 ),
             .rainIntensity = current.rainIntensity,
+            .windVector = vector,
+            .windSteadiness = steadiness,
         };
+    }
+
+    auto Accumulator::size() const -> uint32_t
+    {
+        return this->count;
+    }
+
+    auto aggregate( const Infos::SensorData& current, const std::vector<Infos::SensorData>& samples ) -> Infos::SensorData
+    {
+        auto accumulator = Accumulator{};
+        for ( const auto& sample : samples )
+        {
+            accumulator.add( sample );
+        }
+        return accumulator.result( current );
+    }
+
+    static auto generate( std::time_t dateTime ) -> void
+    {
+        if ( window.size() == 0 )
+        {
+            return;
+        }
+
+        auto current = Infos::SensorData::get();
+        current.dateTime = dateTime;
+
+        Database::insert( window.result( current ) );
+        Database::archive( samples );
+        window = {};
+        samples.clear();
+    }
+
+    static auto sample( std::time_t dateTime ) -> void
+    {
+        auto sensorData = Infos::SensorData::get();
+        sensorData.dateTime = dateTime;
+        // Rajada do intervalo desde a amostra anterior, o registro fica com a maior do período
+        sensorData.windGust = Infos::gust();
+
+        window.add( sensorData );
+        if ( cfg->archive.enabled )
+        {
+            samples.push_back( sensorData );
+        }
+    }
 
-        insert( average );
+    static auto generate() -> void
+    {
+        Database::generate( std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() ) );
     }
 
     static auto sample() -> void
     {
-        if(rolling.size() < 90){
-            rolling.emplace_back(Infos::SensorData::get());
+        Database::sample( std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() ) );
+    }
+
+    // Fonte com relógio próprio (replay): amostras e registros em passos fixos dele e com a hora dele
+    static auto pace( std::time_t now ) -> void
+    {
+        if ( paced == 0 )
+        {
+            paced = now - now % SAMPLE_PERIOD + SAMPLE_PERIOD;
         }
-        else {
-            rolling[index] = Infos::SensorData::get();
-            index = (index + 1) % 90;
+
+        for ( auto steps = 0u; paced <= now and steps < CATCH_UP; ++steps )
+        {
+            Database::sample( paced );
+            if ( paced % RECORD_PERIOD == 0 )
+            {
+                Database::generate( paced );
+            }
+            paced += SAMPLE_PERIOD;
         }
     }
 
@@ -160,25 +684,363 @@ namespace Database
     {
         log_d( "begin" );
 
-        rolling.reserve(90);
-        index = 0;
+        if ( db != nullptr )
+        {
+            log_d( "already open" );
+            return;
+        }
+
+        window = {};
+        samples.clear();
+        samples.reserve( 90 );
 
         initializeDatabase();
         createTable();
+        preload();
 
         log_d( "end" );
     }
 
+    namespace Backup
+    {
+        static constexpr auto FILE_NAME = DATABASE_ROOT "/snapshot.db";
+        static constexpr auto PAGES = 16;
+
+        static std::mutex backupMutex = {};
+        static std::atomic<State> current = State::IDLE;
+        static sqlite3* target = nullptr;
+        static sqlite3_backup* backup = nullptr;
+        static int pageSize = 0;
+        static int pages = 0;
+        static int remaining = 0;
+        static uint32_t steps = 0;
+        static std::chrono::steady_clock::time_point started = {};
+        static std::chrono::milliseconds elapsed = {};
+        static std::size_t readers = 0;
+
+        static auto close( State state ) -> void
+        {
+            sqlite3_backup_finish( backup );
+            sqlite3_close( target );
+            backup = nullptr;
+            target = nullptr;
+
+            const auto lock = std::lock_guard<std::mutex>{backupMutex};
+            elapsed = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - started );
+            current = state;
+        }
+
+        static auto start() -> void
+        {
+            log_d( "begin" );
+
+            std::remove( FILE_NAME );
+
+            sqlite3_stmt* res;
+            if ( sqlite3_prepare_v2( db, "PRAGMA page_size", -1, &res, nullptr ) == SQLITE_OK )
+            {
+                pageSize = sqlite3_step( res ) == SQLITE_ROW ? sqlite3_column_int( res, 0 ) : 0;
+                sqlite3_finalize( res );
+            }
+
+            started = std::chrono::steady_clock::now();
+            pages = 0;
+            remaining = 0;
+            steps = 0;
+
+            if ( sqlite3_open( FILE_NAME, &target ) != SQLITE_OK or ( backup = sqlite3_backup_init( target, "main", db, "main" ) ) == nullptr )
+            {
+                log_e( "backup init error: %s", sqlite3_errmsg( target ) );
+                Backup::close( State::FAILED );
+                return;
+            }
+
+            current = State::RUNNING;
+            log_d( "end" );
+        }
+
+        // Poucas páginas por vez, a amostragem e o servidor seguem normalmente
+        static auto step() -> void
+        {
+            if ( current == State::PENDING )
+            {
+                Backup::start();
+                return;
+            }
+            if ( current != State::RUNNING )
+            {
+                return;
+            }
+
+            const auto rc = sqlite3_backup_step( backup, PAGES );
+            {
+                const auto lock = std::lock_guard<std::mutex>{backupMutex};
+                pages = sqlite3_backup_pagecount( backup );
+                remaining = sqlite3_backup_remaining( backup );
+                steps += 1;
+            }
+
+            if ( rc == SQLITE_DONE )
+            {
+                Backup::close( State::DONE );
+                log_d( "backup done, pages = %d, elapsed = %lld ms", pages, elapsed.count() );
+            }
+            else if ( rc != SQLITE_OK and rc != SQLITE_BUSY and rc != SQLITE_LOCKED )
+            {
+                log_e( "backup step error: %s", sqlite3_errstr( rc ) );
+                Backup::close( State::FAILED );
+            }
+        }
+
+        // Uma cópia pronta que ainda está sendo lida não é refeita
+        auto request() -> void
+        {
+            const auto lock = std::lock_guard<std::mutex>{backupMutex};
+
+            if ( current == State::PENDING or current == State::RUNNING or ( current == State::DONE and readers > 0 ) )
+            {
+                return;
+            }
+            current = State::PENDING;
+        }
+
+        auto state() -> State
+        {
+            return current;
+        }
+
+        auto open() -> std::shared_ptr<FILE>
+        {
+            const auto lock = std::lock_guard<std::mutex>{backupMutex};
+
+            if ( current != State::DONE )
+            {
+                return {};
+            }
+
+            const auto file = std::fopen( FILE_NAME, "rb" );
+            if ( file == nullptr )
+            {
+                return {};
+            }
+
+            readers += 1;
+            return std::shared_ptr<FILE>( file, []( FILE* file )
+            {
+                std::fclose( file );
+
+                const auto lock = std::lock_guard<std::mutex>{backupMutex};
+                readers -= 1;
+            });
+        }
+
+        auto serialize( ArduinoJson::JsonVariant& json ) -> void
+        {
+            static constexpr auto names = std::array{ "idle", "pending", "running", "done", "failed" };
+
+            const auto lock = std::lock_guard<std::mutex>{backupMutex};
+
+            const auto time = current == State::RUNNING ? std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::steady_clock::now() - started ) : elapsed;
+            const auto bytes = static_cast<uint64_t>( pages - remaining ) * pageSize;
+
+            json["state"] = names.at( static_cast<std::size_t>( current.load() ) );
+            json["page_size"] = pageSize;
+            json["pages"] = pages;
+            json["remaining"] = remaining;
+            json["steps"] = steps;
+            json["bytes"] = bytes;
+            json["elapsed"] = time.count();
+            json["throughput"] = time.count() > 0 ? bytes * 1000 / time.count() : 0;
+            json["readers"] = readers;
+        }
+    } // namespace Backup
+
+    namespace Uplink
+    {
+        // Maior sequência com hora até dateTime, ponto de partida quando a marca não serve
+        static auto since( std::time_t dateTime ) -> int64_t
+        {
+            const auto query = "SELECT IFNULL(MAX(SEQUENCE),0) FROM SENSORS_DATA WHERE DATE_TIME <= ?";
+
+            sqlite3_stmt* res;
+            if ( sqlite3_prepare_v2( db, query, strlen( query ), &res, nullptr ) != SQLITE_OK )
+            {
+                log_e( "since prepare error: %s", sqlite3_errmsg( db ) );
+                return 0;
+            }
+
+            sqlite3_bind_int64( res, 1, dateTime );
+            const auto sequence = sqlite3_step( res ) == SQLITE_ROW ? sqlite3_column_int64( res, 0 ) : int64_t{0};
+            sqlite3_finalize( res );
+            return sequence;
+        }
+
+        auto mark() -> Mark
+        {
+            const auto query = "SELECT MARK, SEQUENCE FROM UPLINK_STATE WHERE ID = 0";
+
+            sqlite3_stmt* res;
+            if ( sqlite3_prepare_v2( db, query, strlen( query ), &res, nullptr ) != SQLITE_OK )
+            {
+                log_e( "mark prepare error: %s", sqlite3_errmsg( db ) );
+                return {};
+            }
+
+            auto mark = Mark{};
+            auto known = false;
+            if ( sqlite3_step( res ) == SQLITE_ROW )
+            {
+                mark.dateTime = static_cast<std::time_t>( sqlite3_column_int64( res, 0 ) );
+                mark.sequence = sqlite3_column_int64( res, 1 );
+                known = sqlite3_column_type( res, 1 ) != SQLITE_NULL;
+            }
+            sqlite3_finalize( res );
+
+            // Estado gravado antes da sequência só tem a hora
+            if ( not known and mark.dateTime != 0 )
+            {
+                mark.sequence = Uplink::since( mark.dateTime );
+                log_d( "mark upgraded, sequence = %lld", static_cast<long long>( mark.sequence ) );
+            }
+            return mark;
+        }
+
+        auto advance( const Mark& mark ) -> void
+        {
+            const auto query = "INSERT OR REPLACE INTO UPLINK_STATE ( ID, MARK, SEQUENCE ) VALUES ( 0, ?, ? )";
+
+            sqlite3_stmt* res;
+            if ( sqlite3_prepare_v2( db, query, strlen( query ), &res, nullptr ) != SQLITE_OK )
+            {
+                log_e( "advance prepare error: %s", sqlite3_errmsg( db ) );
+                return;
+            }
+
+            sqlite3_bind_int64( res, 1, mark.dateTime );
+            sqlite3_bind_int64( res, 2, mark.sequence );
+            if ( sqlite3_step( res ) != SQLITE_DONE )
+            {
+                log_e( "advance error: %s", sqlite3_errmsg( db ) );
+            }
+            sqlite3_finalize( res );
+        }
+
+        auto pending( const Mark& mark ) -> uint32_t
+        {
+            const auto query = "SELECT COUNT(*) FROM SENSORS_DATA WHERE SEQUENCE > ?";
+
+            sqlite3_stmt* res;
+            if ( sqlite3_prepare_v2( db, query, strlen( query ), &res, nullptr ) != SQLITE_OK )
+            {
+                log_e( "pending prepare error: %s", sqlite3_errmsg( db ) );
+                return 0;
+            }
+
+            sqlite3_bind_int64( res, 1, mark.sequence );
+            const auto count = sqlite3_step( res ) == SQLITE_ROW ? static_cast<uint32_t>( sqlite3_column_int( res, 0 ) ) : uint32_t{0};
+            sqlite3_finalize( res );
+            return count;
+        }
+
+        // AUTOINCREMENT nunca reaproveita números, mas um banco restaurado de uma cópia antiga volta atrás
+        auto regressed( const Mark& mark ) -> bool
+        {
+            const auto query = "SELECT IFNULL(MAX(SEQUENCE),0) FROM SENSORS_DATA";
+
+            sqlite3_stmt* res;
+            if ( sqlite3_prepare_v2( db, query, strlen( query ), &res, nullptr ) != SQLITE_OK )
+            {
+                log_e( "regressed prepare error: %s", sqlite3_errmsg( db ) );
+                return false;
+            }
+
+            const auto newest = sqlite3_step( res ) == SQLITE_ROW ? sqlite3_column_int64( res, 0 ) : int64_t{0};
+            sqlite3_finalize( res );
+            return newest < mark.sequence;
+        }
+
+        // Recomeça logo depois do último registro enviado, pela hora: o que veio depois dele sai de novo
+        auto resync( const Mark& mark ) -> Mark
+        {
+            return Mark{ Uplink::since( mark.dateTime ), mark.dateTime };
+        }
+
+        auto collect( const Mark& mark, uint16_t limit, const std::function<bool( int64_t, const Infos::SensorData& )>& sink ) -> void
+        {
+            const auto query = " SELECT                 "
+                               "     DATE_TIME,         "
+                               "     TEMPERATURE,       "
+                               "     HUMIDITY,          "
+                               "     PRESSURE,          "
+                               "     WIND_SPEED,        "
+                               "     WIND_DIRECTION,    "
+                               "     RAIN_INTENSITY,    "
+                               "     WIND_GUST,         "
+                               "     WIND_VECTOR,       "
+                               "     WIND_STEADINESS,   "
+                               "     SEQUENCE           "
+                               " FROM                   "
+                               "     SENSORS_DATA       "
+                               " WHERE                  "
+                               "     SEQUENCE > ?       "
+                               " ORDER BY               "
+                               "     SEQUENCE ASC       "
+                               " LIMIT ?                ";
+
+            sqlite3_stmt* res;
+            if ( sqlite3_prepare_v2( db, query, strlen( query ), &res, nullptr ) != SQLITE_OK )
+            {
+                log_e( "collect prepare error: %s", sqlite3_errmsg( db ) );
+                return;
+            }
+
+            sqlite3_bind_int64( res, 1, mark.sequence );
+            sqlite3_bind_int( res, 2, limit );
+            while ( sqlite3_step( res ) == SQLITE_ROW )
+            {
+                if ( not sink( sqlite3_column_int64( res, 10 ), Database::row( res ) ) )
+                {
+                    break;
+                }
+            }
+            sqlite3_finalize( res );
+        }
+    } // namespace Uplink
+
     auto process() -> void
     {
-        Utils::bound( std::chrono::seconds( 10 ), Database::sample );
-        Utils::bound( std::chrono::minutes( 15 ), Database::generate );
+        if ( not cfg->deepSleep.enabled )
+        {
+            if ( const auto clock = Infos::clock() )
+            {
+                Database::pace( *clock );
+            }
+            else
+            {
+                Utils::bound( std::chrono::seconds( SAMPLE_PERIOD ), Database::sample );
+                Utils::bound( std::chrono::seconds( RECORD_PERIOD ), Database::generate );
+            }
+        }
         Utils::bound( std::chrono::hours( 24 ), Database::cleanup );
+        Utils::periodic( std::chrono::milliseconds( 20 ), Backup::step );
     }
 
-    Filter::Filter( std::chrono::system_clock::time_point start, std::chrono::system_clock::time_point end, uint32_t limit )
+    Filter::Filter( std::chrono::system_clock::time_point start, std::chrono::system_clock::time_point end, uint32_t limit, Resolution resolution )
     {
+        const auto from = start != std::chrono::system_clock::time_point::min() ? std::chrono::system_clock::to_time_t( start ) : std::numeric_limits<std::time_t>::min();
 
+        this->cursor = from;
+        this->end = end != std::chrono::system_clock::time_point::max() ? std::chrono::system_clock::to_time_t( end ) : std::numeric_limits<std::time_t>::max();
+        this->limit = limit;
+        this->resolution = resolution;
+        // Amostras brutas só existem no cartão
+        this->split = resolution == Resolution::AGGREGATE ? Hot::split() : std::numeric_limits<std::time_t>::max();
+
+        // Faixa toda na memória, o cartão nem é consultado
+        if ( from >= this->split )
+        {
+            return;
+        }
 
         const auto query = " SELECT                                       "
                            "     DATE_TIME,                               "
@@ -187,17 +1049,41 @@ namespace Database
                            "     PRESSURE,                                "
                            "     WIND_SPEED,                              "
                            "     WIND_DIRECTION,                          "
-                           "     RAIN_INTENSITY                           "
+                           "     RAIN_INTENSITY,                          "
+                           "     WIND_GUST,                               "
+                           "     WIND_VECTOR,                             "
+                           "     WIND_STEADINESS                          "
                            " FROM                                         "
                            "     SENSORS_DATA                             "
                            " WHERE                                        "
                            "         ( DATE_TIME >= IFNULL(?,DATE_TIME) ) "
-                           "     AND ( DATE_TIME <= IFNULL(?,DATE_TIME) ) "
+                           "     AND ( DATE_TIME <= ? )                   "
                            " ORDER BY                                     "
                            "     DATE_TIME ASC                            "
                            " LIMIT ?                                      ";
 
-        const auto rc = sqlite3_prepare_v2( db, query, strlen( query ), &this->res, nullptr );
+        const auto rawQuery = " SELECT                                       "
+                              "     DATE_TIME,                               "
+                              "     TEMPERATURE,                             "
+                              "     HUMIDITY,                                "
+                              "     PRESSURE,                                "
+                              "     WIND_SPEED,                              "
+                              "     WIND_DIRECTION,                          "
+                              "     RAIN_INTENSITY,                          "
+                              "     IFNULL(WIND_GUST,WIND_SPEED),            "
+                              "     0,                                       "
+                              "     1                                        "
+                              " FROM                                         "
+                              "     SAMPLES_DATA                             "
+                              " WHERE                                        "
+                              "         ( DATE_TIME >= IFNULL(?,DATE_TIME) ) "
+                              "     AND ( DATE_TIME <= ? )                   "
+                              " ORDER BY                                     "
+                              "     DATE_TIME ASC                            "
+                              " LIMIT ?                                      ";
+
+        const auto selected = resolution == Resolution::AGGREGATE ? query : rawQuery;
+        const auto rc = sqlite3_prepare_v2( db, selected, strlen( selected ), &this->res, nullptr );
         if ( rc != SQLITE_OK )
         {
             log_d( "select prepare error: %s", sqlite3_errmsg( db ) );
@@ -206,17 +1092,11 @@ namespace Database
         }
         else
         {
-            //log_d( "select params: start %d / end %d / limit %d", std::chrono::system_clock::to_time_t( start ), std::chrono::system_clock::to_time_t( end ), limit );
-
             if ( start != std::chrono::system_clock::time_point::min() )
             {
-                sqlite3_bind_int64( this->res, 1, std::chrono::system_clock::to_time_t( start ) );
-            }
-            if ( end != std::chrono::system_clock::time_point::max() )
-            {
-                sqlite3_bind_int64( this->res, 2, std::chrono::system_clock::to_time_t( end ) );
+                sqlite3_bind_int64( this->res, 1, from );
             }
-            
+            sqlite3_bind_int64( this->res, 2, std::min( this->end, this->split - 1 ) );
             sqlite3_bind_int( this->res, 3, limit );
         }
     }
@@ -225,9 +1105,15 @@ namespace Database
     {
         this->res = other.res;
         this->count = other.count;
+        this->cursor = other.cursor;
+        this->end = other.end;
+        this->split = other.split;
+        this->limit = other.limit;
+        this->resolution = other.resolution;
 
         other.res = nullptr;
         other.count = 0;
+        other.limit = 0;
     }
 
     Filter::~Filter()
@@ -242,29 +1128,43 @@ namespace Database
 
     auto Filter::next() -> std::optional<Infos::SensorData>
     {
-        if (this->res == nullptr)
+        if ( this->count >= this->limit )
         {
             return {};
         }
 
-        if( sqlite3_step( this->res ) != SQLITE_ROW )
+        // Amostras brutas não existem na memória, sem a consulta não há o que devolver
+        if ( this->res == nullptr and this->resolution == Resolution::RAW )
         {
-            sqlite3_finalize( this->res );
-            this->res = nullptr;
-            this->count = 0;
             return {};
         }
 
-        this->count += 1;
+        if ( this->res != nullptr )
+        {
+            if( sqlite3_step( this->res ) == SQLITE_ROW )
+            {
+                this->count += 1;
 
-        return Infos::SensorData{
-            .dateTime = static_cast<std::time_t>(sqlite3_column_int64( this->res, 0 )),
-            .temperature = static_cast<float>(sqlite3_column_double( this->res, 1 )),
-            .humidity = static_cast<float>(sqlite3_column_double( this->res, 2 )),
-            .pressure = static_cast<float>(sqlite3_column_double( this->res, 3 )),
-            .windSpeed = static_cast<float>(sqlite3_column_double( this->res, 4 )),
-            .windDirection = static_cast<WindDirection>(sqlite3_column_int( this->res, 5 )),
-            .rainIntensity = static_cast<RainIntensity>(sqlite3_column_int( this->res, 6 )),
-        };
+                auto sensorData = Database::row( this->res );
+                if ( this->resolution == Resolution::RAW )
+                {
+                    sensorData.windVector = Utils::WindDirection::getAngle( sensorData.windDirection );
+                }
+                return sensorData;
+            }
+
+            sqlite3_finalize( this->res );
+            this->res = nullptr;
+            this->cursor = this->split;
+        }
+
+        // Continua a partir da memória, mesmo que registros novos tenham chegado no meio
+        const auto sensorData = Hot::next( this->cursor, this->end );
+        if ( sensorData )
+        {
+            this->count += 1;
+            this->cursor = sensorData->dateTime + 1;
+        }
+        return sensorData;
     }
 } // namespace Database
\ No newline at end of file
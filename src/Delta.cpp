@@ -0,0 +1,217 @@
+#include <Arduino.h>
+
+#include <algorithm>
+#include <cstring>
+#include <esp_log.h>
+
+#include "Delta.hpp"
+
+namespace Delta
+{
+    Patcher::Patcher( const Digest& running, Source source, Sink sink ) : source( source ), sink( sink ), running( running )
+    {
+        mbedtls_sha256_init( &this->sha );
+        mbedtls_sha256_starts_ret( &this->sha, 0 );
+    }
+
+    Patcher::~Patcher()
+    {
+        mbedtls_sha256_free( &this->sha );
+    }
+
+    auto Patcher::fail( const char* reason ) -> void
+    {
+        log_e( "%s", reason );
+        this->reason = reason;
+        this->state = State::FAILED;
+    }
+
+    auto Patcher::emit( const uint8_t* data, std::size_t length ) -> bool
+    {
+        mbedtls_sha256_update_ret( &this->sha, data, length );
+        this->produced += length;
+        if ( not this->sink( data, length ) )
+        {
+            this->fail( "write error" );
+            return false;
+        }
+        return true;
+    }
+
+    auto Patcher::parse() -> void
+    {
+        if ( not std::equal( MAGIC.begin(), MAGIC.end(), this->header.begin() ) )
+        {
+            this->fail( "not a patch" );
+            return;
+        }
+
+        auto offset = MAGIC.size();
+        std::memcpy( &this->size, this->header.data() + offset, sizeof( this->size ) );
+        offset += sizeof( this->size );
+
+        // Patch feito para outra versão produziria lixo, nem começa
+        if ( not std::equal( this->running.begin(), this->running.end(), this->header.begin() + offset ) )
+        {
+            this->fail( "patch does not match running firmware" );
+            return;
+        }
+        offset += this->running.size();
+        std::copy_n( this->header.begin() + offset, this->target.size(), this->target.begin() );
+
+        this->state = State::CONTROL;
+        if ( this->size == 0 )
+        {
+            this->verify();
+        }
+    }
+
+    // Depois dos dados de uma entrada aplica o seek e decide se ainda há outra
+    auto Patcher::next() -> void
+    {
+        if ( this->diff > 0 )
+        {
+            this->state = State::DIFF;
+        }
+        else if ( this->extra > 0 )
+        {
+            this->state = State::EXTRA;
+        }
+        else
+        {
+            this->position += this->seek;
+            this->state = State::CONTROL;
+            if ( this->produced == this->size )
+            {
+                this->verify();
+            }
+        }
+    }
+
+    auto Patcher::verify() -> void
+    {
+        auto digest = Digest{};
+        mbedtls_sha256_finish_ret( &this->sha, digest.data() );
+        if ( digest != this->target )
+        {
+            this->fail( "digest mismatch" );
+            return;
+        }
+        this->state = State::DONE;
+    }
+
+    auto Patcher::write( const uint8_t* data, std::size_t length ) -> bool
+    {
+        while ( length > 0 and this->state != State::FAILED )
+        {
+            switch ( this->state )
+            {
+                case State::HEADER:
+                {
+                    const auto count = std::min( length, this->header.size() - this->filled );
+                    std::copy_n( data, count, this->header.begin() + this->filled );
+                    this->filled += count;
+                    data += count;
+                    length -= count;
+                    if ( this->filled == this->header.size() )
+                    {
+                        this->parse();
+                    }
+                    break;
+                }
+                case State::CONTROL:
+                {
+                    // Inteiros LEB128, o seek em zigzag
+                    const auto byte = *data++;
+                    length -= 1;
+                    this->control[this->field] |= uint64_t{ byte & 0x7fu } << this->shift;
+                    if ( byte & 0x80 )
+                    {
+                        this->shift += 7;
+                        if ( this->shift > 63 )
+                        {
+                            this->fail( "bad control" );
+                        }
+                        break;
+                    }
+                    this->shift = 0;
+                    if ( ++this->field < this->control.size() )
+                    {
+                        break;
+                    }
+
+                    const auto [diff, extra, seek] = this->control;
+                    this->control = {};
+                    this->field = 0;
+                    if ( diff + extra > this->size - this->produced )
+                    {
+                        this->fail( "entry exceeds target size" );
+                        break;
+                    }
+                    this->diff = diff;
+                    this->extra = extra;
+                    this->seek = static_cast<int64_t>( seek >> 1 ) ^ -static_cast<int64_t>( seek & 1 );
+                    this->next();
+                    break;
+                }
+                case State::DIFF:
+                {
+                    const auto count = std::min( { length, this->scratch.size(), static_cast<std::size_t>( this->diff ) } );
+                    if ( this->position < 0 or not this->source( this->position, this->scratch.data(), count ) )
+                    {
+                        this->fail( "source read error" );
+                        break;
+                    }
+                    for ( auto i = 0u; i < count; ++i )
+                    {
+                        this->scratch[i] += data[i];
+                    }
+                    if ( not this->emit( this->scratch.data(), count ) )
+                    {
+                        break;
+                    }
+                    this->position += count;
+                    this->diff -= count;
+                    data += count;
+                    length -= count;
+                    this->next();
+                    break;
+                }
+                case State::EXTRA:
+                {
+                    const auto count = std::min( length, static_cast<std::size_t>( this->extra ) );
+                    if ( not this->emit( data, count ) )
+                    {
+                        break;
+                    }
+                    this->extra -= count;
+                    data += count;
+                    length -= count;
+                    this->next();
+                    break;
+                }
+                case State::DONE:
+                    this->fail( "data after end of patch" );
+                    break;
+                default:
+                    break;
+            }
+        }
+        return this->state != State::FAILED;
+    }
+
+    auto Patcher::done() const -> bool
+    {
+        return this->state == State::DONE;
+    }
+
+    auto Patcher::error() const -> const char*
+    {
+        return this->reason != nullptr ? this->reason : this->done() ? "" : "truncated patch";
+    }
+
+    auto Patcher::written() const -> uint32_t
+    {
+        return this->produced;
+    }
+} // namespace Delta
\ No newline at end of file
@@ -0,0 +1,1012 @@
+#include <Arduino.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <esp_log.h>
+#include <functional>
+#include <queue>
+
+#include "Gzip.hpp"
+
+namespace Gzip
+{
+    static constexpr auto MIN_MATCH = 3u;
+    static constexpr auto MAX_MATCH = 258u;
+    static constexpr auto MAX_CHAIN = 8u;
+    static constexpr auto END_OF_BLOCK = 256u;
+
+    static constexpr std::array<uint16_t, 29> LENGTH_BASE{ 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static constexpr std::array<uint8_t, 29> LENGTH_EXTRA{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static constexpr std::array<uint16_t, 30> DISTANCE_BASE{ 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    static constexpr std::array<uint8_t, 30> DISTANCE_EXTRA{ 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    static constexpr std::array<uint8_t, 19> LENGTH_ORDER{ 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    static constexpr std::array<uint8_t, 10> HEADER{ 0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff };
+
+    template<std::size_t N>
+    static auto symbol( const std::array<uint16_t, N>& base, uint32_t value ) -> std::size_t
+    {
+        return std::distance( base.begin(), std::upper_bound( base.begin(), base.end(), value ) ) - 1;
+    }
+
+    // Huffman limitado: se passar do limite as frequências são achatadas e a árvore refeita
+    template<std::size_t N>
+    auto Deflater::Tree<N>::build( uint8_t limit ) -> void
+    {
+        auto weight = std::array<uint32_t, N>{};
+        std::copy( this->frequency.begin(), this->frequency.end(), weight.begin() );
+        this->length = {};
+
+        const auto used = std::count_if( weight.begin(), weight.end(), []( auto w ){ return w > 0; } );
+        if ( used < 2 )
+        {
+            // Um código completo precisa de dois símbolos
+            this->length[0] = 1;
+            this->length[1] = 1;
+            for ( auto i = 0u; i < N; ++i )
+            {
+                if ( weight[i] > 0 and i > 1 )
+                {
+                    this->length[1] = 0;
+                    this->length[i] = 1;
+                }
+            }
+        }
+        else
+        {
+            auto parent = std::vector<int16_t>( 2 * N, -1 );
+            while ( true )
+            {
+                using Node = std::pair<uint32_t, int16_t>;
+                auto queue = std::priority_queue<Node, std::vector<Node>, std::greater<Node>>{};
+                for ( auto i = 0u; i < N; ++i )
+                {
+                    if ( weight[i] > 0 )
+                    {
+                        queue.push( { weight[i], static_cast<int16_t>( i ) } );
+                    }
+                }
+
+                auto next = static_cast<int16_t>( N );
+                while ( queue.size() > 1 )
+                {
+                    const auto a = queue.top();
+                    queue.pop();
+                    const auto b = queue.top();
+                    queue.pop();
+                    parent[a.second] = next;
+                    parent[b.second] = next;
+                    parent[next] = -1;
+                    queue.push( { a.first + b.first, next } );
+                    next += 1;
+                }
+
+                auto deepest = 0u;
+                for ( auto i = 0u; i < N; ++i )
+                {
+                    auto depth = 0u;
+                    for ( auto node = weight[i] > 0 ? static_cast<int16_t>( i ) : -1; node >= 0 and parent[node] >= 0; node = parent[node] )
+                    {
+                        depth += 1;
+                    }
+                    this->length[i] = depth;
+                    deepest = std::max( deepest, depth );
+                }
+
+                if ( deepest <= limit )
+                {
+                    break;
+                }
+                for ( auto& w : weight )
+                {
+                    w = w > 0 ? ( w >> 1 ) | 1 : 0;
+                }
+            }
+        }
+
+        // Códigos canônicos a partir dos comprimentos
+        auto counts = std::array<uint16_t, 16>{};
+        for ( const auto l : this->length )
+        {
+            counts[l] += 1;
+        }
+        counts[0] = 0;
+
+        auto next = std::array<uint16_t, 16>{};
+        for ( auto bits = 1u, code = 0u; bits < next.size(); ++bits )
+        {
+            code = ( code + counts[bits - 1] ) << 1;
+            next[bits] = code;
+        }
+        for ( auto i = 0u; i < N; ++i )
+        {
+            this->code[i] = this->length[i] > 0 ? next[this->length[i]]++ : 0;
+        }
+    }
+
+    Deflater::Deflater()
+    {
+        this->head = {};
+        this->output.reserve( 512 );
+        this->output.insert( this->output.end(), HEADER.begin(), HEADER.end() );
+    }
+
+    auto Deflater::at( uint32_t index ) const -> uint8_t
+    {
+        return this->ring[index & ( this->ring.size() - 1 )];
+    }
+
+    auto Deflater::hash( uint32_t index ) const -> uint32_t
+    {
+        const auto key = ( this->at( index ) << 16 ) | ( this->at( index + 1 ) << 8 ) | this->at( index + 2 );
+        return ( key * 2654435761u ) >> ( 32 - HASH_BITS );
+    }
+
+    auto Deflater::insert( uint32_t index ) -> void
+    {
+        if ( index + MIN_MATCH > this->size )
+        {
+            return;
+        }
+
+        auto& slot = this->head[this->hash( index )];
+        const auto distance = slot == 0 ? 0 : index - ( slot - 1 );
+        this->chain[index & ( WINDOW - 1 )] = distance < WINDOW ? distance : 0;
+        slot = index + 1;
+    }
+
+    auto Deflater::match( uint32_t* distance ) const -> uint32_t
+    {
+        const auto lookahead = std::min( MAX_MATCH, this->size - this->position );
+        if ( lookahead < MIN_MATCH )
+        {
+            return 0;
+        }
+
+        auto best = 0u;
+        const auto slot = this->head[this->hash( this->position )];
+        auto candidate = slot == 0 ? this->position : slot - 1;
+
+        for ( auto depth = 0u; depth < MAX_CHAIN and candidate < this->position and this->position - candidate <= WINDOW; ++depth )
+        {
+            auto length = 0u;
+            while ( length < lookahead and this->at( candidate + length ) == this->at( this->position + length ) )
+            {
+                length += 1;
+            }
+
+            if ( length > best )
+            {
+                best = length;
+                *distance = this->position - candidate;
+                if ( best == lookahead )
+                {
+                    break;
+                }
+            }
+
+            const auto step = this->chain[candidate & ( WINDOW - 1 )];
+            if ( step == 0 or step > candidate )
+            {
+                break;
+            }
+            candidate -= step;
+        }
+
+        return best >= MIN_MATCH ? best : 0;
+    }
+
+    auto Deflater::compress( bool final ) -> void
+    {
+        // Sem o flush final só comprime quando um match máximo cabe à frente
+        while ( final ? this->position < this->size : this->size - this->position >= MAX_MATCH )
+        {
+            auto distance = 0u;
+            const auto length = this->match( &distance );
+
+            if ( length == 0 )
+            {
+                this->tokens[this->pending++] = Token{ this->at( this->position ), 0 };
+                this->insert( this->position );
+                this->position += 1;
+            }
+            else
+            {
+                this->tokens[this->pending++] = Token{ static_cast<uint16_t>( length ), static_cast<uint16_t>( distance ) };
+                for ( auto i = 0u; i < length; ++i )
+                {
+                    this->insert( this->position + i );
+                }
+                this->position += length;
+            }
+
+            if ( this->pending == this->tokens.size() )
+            {
+                this->block( false );
+            }
+        }
+    }
+
+    // Bloco com Huffman dinâmico montado a partir dos tokens acumulados
+    auto Deflater::block( bool final ) -> void
+    {
+        this->literals.frequency = {};
+        this->distances.frequency = {};
+        this->lengths.frequency = {};
+
+        for ( auto i = 0u; i < this->pending; ++i )
+        {
+            const auto& token = this->tokens[i];
+            if ( token.distance == 0 )
+            {
+                this->literals.frequency[token.length] += 1;
+            }
+            else
+            {
+                this->literals.frequency[257 + symbol( LENGTH_BASE, token.length )] += 1;
+                this->distances.frequency[symbol( DISTANCE_BASE, token.distance )] += 1;
+            }
+        }
+        this->literals.frequency[END_OF_BLOCK] = 1;
+
+        this->literals.build( 15 );
+        this->distances.build( 15 );
+
+        auto hlit = this->literals.length.size();
+        while ( hlit > 257 and this->literals.length[hlit - 1] == 0 )
+        {
+            hlit -= 1;
+        }
+        auto hdist = this->distances.length.size();
+        while ( hdist > 1 and this->distances.length[hdist - 1] == 0 )
+        {
+            hdist -= 1;
+        }
+
+        // Comprimentos em sequência, com as repetições do formato (16, 17 e 18)
+        auto all = std::array<uint8_t, 286 + 30>{};
+        std::copy( this->literals.length.begin(), this->literals.length.begin() + hlit, all.begin() );
+        std::copy( this->distances.length.begin(), this->distances.length.begin() + hdist, all.begin() + hlit );
+
+        auto runs = std::vector<Token>{};
+        runs.reserve( hlit + hdist );
+        for ( auto i = 0u; i < hlit + hdist; )
+        {
+            const auto current = all[i];
+            auto run = 1u;
+            while ( i + run < hlit + hdist and all[i + run] == current )
+            {
+                run += 1;
+            }
+
+            if ( current == 0 and run >= 11 )
+            {
+                run = std::min( run, 138u );
+                runs.push_back( Token{ 18, static_cast<uint16_t>( run - 11 ) } );
+            }
+            else if ( current == 0 and run >= 3 )
+            {
+                runs.push_back( Token{ 17, static_cast<uint16_t>( run - 3 ) } );
+            }
+            else if ( current != 0 and run >= 4 )
+            {
+                runs.push_back( Token{ current, 0 } );
+                run = std::min( run - 1, 6u );
+                runs.push_back( Token{ 16, static_cast<uint16_t>( run - 3 ) } );
+                run += 1;
+            }
+            else
+            {
+                run = 1;
+                runs.push_back( Token{ current, 0 } );
+            }
+            i += run;
+        }
+
+        for ( const auto& run : runs )
+        {
+            this->lengths.frequency[run.length] += 1;
+        }
+        this->lengths.build( 7 );
+
+        auto hclen = LENGTH_ORDER.size();
+        while ( hclen > 4 and this->lengths.length[LENGTH_ORDER[hclen - 1]] == 0 )
+        {
+            hclen -= 1;
+        }
+
+        this->put( final ? 1 : 0, 1 );
+        this->put( 2, 2 );
+        this->put( hlit - 257, 5 );
+        this->put( hdist - 1, 5 );
+        this->put( hclen - 4, 4 );
+        for ( auto i = 0u; i < hclen; ++i )
+        {
+            this->put( this->lengths.length[LENGTH_ORDER[i]], 3 );
+        }
+        for ( const auto& run : runs )
+        {
+            this->code( this->lengths.code[run.length], this->lengths.length[run.length] );
+            if ( run.length >= 16 )
+            {
+                this->put( run.distance, run.length == 16 ? 2 : run.length == 17 ? 3 : 7 );
+            }
+        }
+
+        for ( auto i = 0u; i < this->pending; ++i )
+        {
+            const auto& token = this->tokens[i];
+            if ( token.distance == 0 )
+            {
+                this->code( this->literals.code[token.length], this->literals.length[token.length] );
+                continue;
+            }
+
+            const auto l = symbol( LENGTH_BASE, token.length );
+            this->code( this->literals.code[257 + l], this->literals.length[257 + l] );
+            this->put( token.length - LENGTH_BASE[l], LENGTH_EXTRA[l] );
+
+            const auto d = symbol( DISTANCE_BASE, token.distance );
+            this->code( this->distances.code[d], this->distances.length[d] );
+            this->put( token.distance - DISTANCE_BASE[d], DISTANCE_EXTRA[d] );
+        }
+        this->code( this->literals.code[END_OF_BLOCK], this->literals.length[END_OF_BLOCK] );
+
+        this->pending = 0;
+    }
+
+    auto Deflater::put( uint32_t value, uint8_t length ) -> void
+    {
+        this->bits |= value << this->count;
+        this->count += length;
+        while ( this->count >= 8 )
+        {
+            this->output.push_back( static_cast<uint8_t>( this->bits ) );
+            this->bits >>= 8;
+            this->count -= 8;
+        }
+    }
+
+    // Códigos de Huffman vão do bit mais significativo para o menos
+    auto Deflater::code( uint32_t value, uint8_t length ) -> void
+    {
+        auto reversed = 0u;
+        for ( auto i = 0u; i < length; ++i )
+        {
+            reversed = ( reversed << 1 ) | ( ( value >> i ) & 1 );
+        }
+        this->put( reversed, length );
+    }
+
+    auto Deflater::write( const uint8_t* data, std::size_t length ) -> void
+    {
+        while ( length > 0 and not this->finished )
+        {
+            // Não sobrescreve a janela atrás da posição atual
+            const auto history = this->position - std::min( this->position, WINDOW );
+            const auto room = std::min<std::size_t>( this->ring.size() - ( this->size - history ), length );
+            if ( room == 0 )
+            {
+                this->compress( false );
+                continue;
+            }
+
+            for ( auto i = 0u; i < room; ++i )
+            {
+                this->ring[( this->size + i ) & ( this->ring.size() - 1 )] = data[i];
+            }
+            this->checksum = this->size == 0 ? this->crc.crc32( data, room ) : this->crc.crc32_upd( data, room );
+            this->size += room;
+            data += room;
+            length -= room;
+        }
+
+        this->compress( false );
+    }
+
+    auto Deflater::finish() -> void
+    {
+        if ( this->finished )
+        {
+            return;
+        }
+
+        this->compress( true );
+        this->block( true );
+        if ( this->count > 0 )
+        {
+            this->put( 0, 8 - this->count );
+        }
+
+        for ( const auto value : { this->checksum, this->size } )
+        {
+            this->put( value & 0xffff, 16 );
+            this->put( value >> 16, 16 );
+        }
+
+        this->finished = true;
+        log_d( "in = %u", this->size );
+    }
+
+    auto Deflater::read( uint8_t* buffer, std::size_t maxLen ) -> std::size_t
+    {
+        const auto length = std::min( maxLen, this->output.size() - this->offset );
+        std::memcpy( buffer, this->output.data() + this->offset, length );
+        this->offset += length;
+
+        if ( this->offset == this->output.size() )
+        {
+            this->output.clear();
+            this->offset = 0;
+        }
+        return length;
+    }
+
+    auto Deflater::done() const -> bool
+    {
+        return this->finished and this->output.empty();
+    }
+
+    static constexpr auto MORE = -1;
+    static constexpr auto INVALID = -2;
+
+    // Código canônico contado por comprimento; retorna < 0 se houver excesso, > 0 se incompleto
+    auto Inflater::Huffman::build( const uint8_t* lengths, std::size_t size ) -> int
+    {
+        this->count = {};
+        for ( auto i = 0u; i < size; ++i )
+        {
+            this->count[lengths[i]] += 1;
+        }
+        if ( this->count[0] == size )
+        {
+            return 0;
+        }
+
+        auto left = 1;
+        for ( auto length = 1u; length < this->count.size(); ++length )
+        {
+            left = ( left << 1 ) - this->count[length];
+            if ( left < 0 )
+            {
+                return left;
+            }
+        }
+
+        auto offset = std::array<uint16_t, 16>{};
+        for ( auto length = 1u; length + 1 < offset.size(); ++length )
+        {
+            offset[length + 1] = offset[length] + this->count[length];
+        }
+        for ( auto i = 0u; i < size; ++i )
+        {
+            if ( lengths[i] != 0 )
+            {
+                this->symbol[offset[lengths[i]]++] = i;
+            }
+        }
+        return left;
+    }
+
+    Inflater::Inflater( Sink sink ) : sink( sink )
+    {
+    }
+
+    auto Inflater::need( uint8_t length ) -> bool
+    {
+        while ( this->count < length )
+        {
+            if ( this->head == this->tail )
+            {
+                return false;
+            }
+            this->bits |= uint32_t{ this->input[this->head++] } << this->count;
+            this->count += 8;
+        }
+        return true;
+    }
+
+    auto Inflater::take( uint8_t length ) -> uint32_t
+    {
+        const auto value = this->bits & ( ( uint32_t{1} << length ) - 1 );
+        this->bits >>= length;
+        this->count -= length;
+        return value;
+    }
+
+    // Bit a bit pelo código canônico, sem tabela de consulta
+    auto Inflater::decode( const Huffman& huffman ) -> int
+    {
+        auto code = 0;
+        auto first = 0;
+        auto index = 0;
+        for ( auto length = 1u; length < huffman.count.size(); ++length )
+        {
+            if ( not this->need( 1 ) )
+            {
+                return MORE;
+            }
+            code |= this->take( 1 );
+            const auto count = static_cast<int>( huffman.count[length] );
+            if ( code - count < first )
+            {
+                return huffman.symbol[index + ( code - first )];
+            }
+            index += count;
+            first = ( first + count ) << 1;
+            code <<= 1;
+        }
+        return INVALID;
+    }
+
+    auto Inflater::emit( uint8_t value ) -> void
+    {
+        this->window[this->position] = value;
+        this->position = ( this->position + 1 ) & ( WINDOW - 1 );
+        this->pending += 1;
+        this->size += 1;
+    }
+
+    auto Inflater::flush() -> bool
+    {
+        auto start = ( this->position - this->pending ) & ( WINDOW - 1 );
+        while ( this->pending > 0 )
+        {
+            const auto length = std::min( this->pending, WINDOW - start );
+            const auto data = this->window.data() + start;
+            const auto first = this->size - this->pending == 0;
+            this->checksum = first ? this->crc.crc32( data, length ) : this->crc.crc32_upd( data, length );
+            if ( not this->sink( data, length ) )
+            {
+                log_e( "sink error" );
+                this->state = State::FAILED;
+                return false;
+            }
+            this->pending -= length;
+            start = 0;
+        }
+        return true;
+    }
+
+    auto Inflater::header() -> Step
+    {
+        if ( not this->need( 16 ) )
+        {
+            return Step::MORE;
+        }
+        if ( this->take( 8 ) != HEADER[0] or this->take( 8 ) != HEADER[1] )
+        {
+            log_e( "not gzip" );
+            return Step::ERROR;
+        }
+
+        auto fixed = std::array<uint32_t, 8>{};
+        for ( auto& value : fixed )
+        {
+            if ( not this->need( 8 ) )
+            {
+                return Step::MORE;
+            }
+            value = this->take( 8 );
+        }
+        const auto method = fixed[0];
+        const auto flags = fixed[1];
+        if ( method != HEADER[2] or ( flags & 0xe0 ) != 0 )
+        {
+            log_e( "unsupported gzip header" );
+            return Step::ERROR;
+        }
+
+        // FEXTRA, FNAME, FCOMMENT e FHCRC são só pulados
+        if ( flags & 0x04 )
+        {
+            if ( not this->need( 16 ) )
+            {
+                return Step::MORE;
+            }
+            for ( auto extra = this->take( 16 ); extra > 0; --extra )
+            {
+                if ( not this->need( 8 ) )
+                {
+                    return Step::MORE;
+                }
+                this->take( 8 );
+            }
+        }
+        for ( const auto flag : { 0x08, 0x10 } )
+        {
+            if ( flags & flag )
+            {
+                do
+                {
+                    if ( not this->need( 8 ) )
+                    {
+                        return Step::MORE;
+                    }
+                } while ( this->take( 8 ) != 0 );
+            }
+        }
+        if ( flags & 0x02 )
+        {
+            if ( not this->need( 16 ) )
+            {
+                return Step::MORE;
+            }
+            this->take( 16 );
+        }
+
+        this->state = State::BLOCK;
+        return Step::OK;
+    }
+
+    auto Inflater::block() -> Step
+    {
+        if ( not this->need( 3 ) )
+        {
+            return Step::MORE;
+        }
+        const auto last = this->take( 1 ) == 1;
+        const auto type = this->take( 2 );
+
+        if ( type == 0 )
+        {
+            this->take( this->count & 7 );
+            if ( not this->need( 16 ) )
+            {
+                return Step::MORE;
+            }
+            const auto length = this->take( 16 );
+            if ( not this->need( 16 ) )
+            {
+                return Step::MORE;
+            }
+            if ( this->take( 16 ) != ( ~length & 0xffff ) )
+            {
+                log_e( "stored length mismatch" );
+                return Step::ERROR;
+            }
+            this->stored = length;
+            this->last = last;
+            this->state = State::STORED;
+            return Step::OK;
+        }
+
+        auto lengths = std::array<uint8_t, 286 + 30>{};
+        auto literalCount = 288u;
+        auto distanceCount = 30u;
+        if ( type == 1 )
+        {
+            std::fill( lengths.begin(), lengths.begin() + 144, 8 );
+            std::fill( lengths.begin() + 144, lengths.begin() + 256, 9 );
+            std::fill( lengths.begin() + 256, lengths.begin() + 280, 7 );
+            std::fill( lengths.begin() + 280, lengths.begin() + 288, 8 );
+            this->literals.build( lengths.data(), literalCount );
+            std::fill( lengths.begin(), lengths.begin() + distanceCount, 5 );
+            this->distances.build( lengths.data(), distanceCount );
+        }
+        else if ( type == 2 )
+        {
+            if ( not this->need( 14 ) )
+            {
+                return Step::MORE;
+            }
+            literalCount = this->take( 5 ) + 257;
+            distanceCount = this->take( 5 ) + 1;
+            const auto codeCount = this->take( 4 ) + 4;
+            if ( literalCount > 286 or distanceCount > 30 )
+            {
+                log_e( "bad counts" );
+                return Step::ERROR;
+            }
+
+            auto codeLengths = std::array<uint8_t, 19>{};
+            for ( auto i = 0u; i < codeCount; ++i )
+            {
+                if ( not this->need( 3 ) )
+                {
+                    return Step::MORE;
+                }
+                codeLengths[LENGTH_ORDER[i]] = this->take( 3 );
+            }
+            auto lengthCode = Huffman{};
+            if ( lengthCode.build( codeLengths.data(), codeLengths.size() ) != 0 )
+            {
+                log_e( "incomplete code lengths" );
+                return Step::ERROR;
+            }
+
+            auto index = 0u;
+            while ( index < literalCount + distanceCount )
+            {
+                const auto symbol = this->decode( lengthCode );
+                if ( symbol == MORE )
+                {
+                    return Step::MORE;
+                }
+                if ( symbol < 0 )
+                {
+                    return Step::ERROR;
+                }
+                if ( symbol < 16 )
+                {
+                    lengths[index++] = symbol;
+                    continue;
+                }
+
+                auto value = uint8_t{0};
+                auto repeat = 0u;
+                if ( symbol == 16 )
+                {
+                    if ( index == 0 or not this->need( 2 ) )
+                    {
+                        return index == 0 ? Step::ERROR : Step::MORE;
+                    }
+                    value = lengths[index - 1];
+                    repeat = 3 + this->take( 2 );
+                }
+                else if ( symbol == 17 )
+                {
+                    if ( not this->need( 3 ) )
+                    {
+                        return Step::MORE;
+                    }
+                    repeat = 3 + this->take( 3 );
+                }
+                else
+                {
+                    if ( not this->need( 7 ) )
+                    {
+                        return Step::MORE;
+                    }
+                    repeat = 11 + this->take( 7 );
+                }
+                if ( index + repeat > literalCount + distanceCount )
+                {
+                    log_e( "too many lengths" );
+                    return Step::ERROR;
+                }
+                std::fill_n( lengths.begin() + index, repeat, value );
+                index += repeat;
+            }
+
+            if ( lengths[END_OF_BLOCK] == 0 )
+            {
+                log_e( "no end of block" );
+                return Step::ERROR;
+            }
+
+            // Só um código de distância pode ficar incompleto, e apenas se tiver um único símbolo
+            const auto literalLeft = this->literals.build( lengths.data(), literalCount );
+            if ( literalLeft < 0 or ( literalLeft > 0 and literalCount - this->literals.count[0] != 1 ) )
+            {
+                log_e( "bad literal code" );
+                return Step::ERROR;
+            }
+            const auto distanceLeft = this->distances.build( lengths.data() + literalCount, distanceCount );
+            if ( distanceLeft < 0 or ( distanceLeft > 0 and distanceCount - this->distances.count[0] != 1 ) )
+            {
+                log_e( "bad distance code" );
+                return Step::ERROR;
+            }
+        }
+        else
+        {
+            log_e( "bad block type" );
+            return Step::ERROR;
+        }
+
+        this->last = last;
+        this->state = State::CODES;
+        return Step::OK;
+    }
+
+    // Um símbolo por passo, a janela é escrita só depois de todos os bits lidos
+    auto Inflater::codes() -> Step
+    {
+        if ( this->pending + MAX_MATCH > WINDOW and not this->flush() )
+        {
+            return Step::ERROR;
+        }
+
+        const auto symbol = this->decode( this->literals );
+        if ( symbol == MORE )
+        {
+            return Step::MORE;
+        }
+        if ( symbol < 0 )
+        {
+            log_e( "bad literal" );
+            return Step::ERROR;
+        }
+        if ( symbol < static_cast<int>( END_OF_BLOCK ) )
+        {
+            this->emit( symbol );
+            return Step::OK;
+        }
+        if ( symbol == static_cast<int>( END_OF_BLOCK ) )
+        {
+            this->state = this->last ? State::TRAILER : State::BLOCK;
+            return Step::OK;
+        }
+
+        const auto lengthSymbol = static_cast<std::size_t>( symbol ) - 257;
+        if ( lengthSymbol >= LENGTH_BASE.size() )
+        {
+            log_e( "bad length" );
+            return Step::ERROR;
+        }
+        if ( not this->need( LENGTH_EXTRA[lengthSymbol] ) )
+        {
+            return Step::MORE;
+        }
+        const auto length = LENGTH_BASE[lengthSymbol] + this->take( LENGTH_EXTRA[lengthSymbol] );
+
+        const auto distanceSymbol = this->decode( this->distances );
+        if ( distanceSymbol == MORE )
+        {
+            return Step::MORE;
+        }
+        if ( distanceSymbol < 0 or static_cast<std::size_t>( distanceSymbol ) >= DISTANCE_BASE.size() )
+        {
+            log_e( "bad distance" );
+            return Step::ERROR;
+        }
+        if ( not this->need( DISTANCE_EXTRA[distanceSymbol] ) )
+        {
+            return Step::MORE;
+        }
+        const auto distance = DISTANCE_BASE[distanceSymbol] + this->take( DISTANCE_EXTRA[distanceSymbol] );
+        if ( distance > this->size )
+        {
+            log_e( "distance too far back" );
+            return Step::ERROR;
+        }
+
+        for ( auto i = 0u; i < length; ++i )
+        {
+            this->emit( this->window[( this->position - distance ) & ( WINDOW - 1 )] );
+        }
+        return Step::OK;
+    }
+
+    auto Inflater::copy() -> Step
+    {
+        while ( this->stored > 0 )
+        {
+            if ( this->head == this->tail )
+            {
+                return Step::MORE;
+            }
+            if ( this->pending == WINDOW and not this->flush() )
+            {
+                return Step::ERROR;
+            }
+            this->emit( this->input[this->head++] );
+            this->stored -= 1;
+        }
+
+        this->state = this->last ? State::TRAILER : State::BLOCK;
+        return Step::OK;
+    }
+
+    // CRC e tamanho conferidos contra o que foi de fato entregue
+    auto Inflater::trailer() -> Step
+    {
+        this->take( this->count & 7 );
+
+        auto values = std::array<uint32_t, 2>{};
+        for ( auto& value : values )
+        {
+            for ( auto shift = 0u; shift < 32; shift += 16 )
+            {
+                if ( not this->need( 16 ) )
+                {
+                    return Step::MORE;
+                }
+                value |= this->take( 16 ) << shift;
+            }
+        }
+
+        if ( not this->flush() )
+        {
+            return Step::ERROR;
+        }
+        if ( values[0] != this->checksum or values[1] != this->size )
+        {
+            log_e( "trailer mismatch, crc = %08x/%08x, size = %u/%u", values[0], this->checksum, values[1], this->size );
+            return Step::ERROR;
+        }
+
+        this->state = State::DONE;
+        return Step::OK;
+    }
+
+    auto Inflater::inflate() -> Step
+    {
+        while ( true )
+        {
+            const auto head = this->head;
+            const auto bits = this->bits;
+            const auto count = this->count;
+
+            auto step = Step::OK;
+            switch ( this->state )
+            {
+                case State::HEADER:
+                    step = this->header();
+                    break;
+                case State::BLOCK:
+                    step = this->block();
+                    break;
+                case State::CODES:
+                    step = this->codes();
+                    break;
+                case State::STORED:
+                    step = this->copy();
+                    break;
+                case State::TRAILER:
+                    step = this->trailer();
+                    break;
+                default:
+                    return Step::OK;
+            }
+
+            if ( step == Step::MORE )
+            {
+                // Cópia de bloco armazenado avança byte a byte, não precisa voltar
+                if ( this->state != State::STORED )
+                {
+                    this->head = head;
+                    this->bits = bits;
+                    this->count = count;
+                }
+                return step;
+            }
+            if ( step == Step::ERROR )
+            {
+                this->state = State::FAILED;
+                return step;
+            }
+        }
+    }
+
+    auto Inflater::write( const uint8_t* data, std::size_t length ) -> bool
+    {
+        while ( length > 0 and this->state != State::DONE and this->state != State::FAILED )
+        {
+            std::memmove( this->input.data(), this->input.data() + this->head, this->tail - this->head );
+            this->tail -= this->head;
+            this->head = 0;
+
+            const auto room = std::min( length, STAGING - this->tail );
+            std::memcpy( this->input.data() + this->tail, data, room );
+            this->tail += room;
+            data += room;
+            length -= room;
+
+            // Um passo maior que o buffer inteiro nunca vai completar
+            if ( this->inflate() == Step::MORE and this->head == 0 and this->tail == STAGING )
+            {
+                log_e( "step exceeds input buffer" );
+                this->state = State::FAILED;
+            }
+        }
+
+        if ( this->state != State::FAILED and this->state != State::DONE )
+        {
+            this->flush();
+        }
+        return this->state != State::FAILED;
+    }
+
+    auto Inflater::done() const -> bool
+    {
+        return this->state == State::DONE;
+    }
+
+    auto Inflater::decompressed() const -> uint32_t
+    {
+        return this->size;
+    }
+} // namespace Gzip
\ No newline at end of file
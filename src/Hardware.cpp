@@ -0,0 +1,263 @@
+#include <Arduino.h>
+
+#include <array>
+#include <chrono>
+#include <driver/pcnt.h>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+#include "Analog.hpp"
+#include "Atmosphere.hpp"
+#include "Classifier.hpp"
+#include "Configuration.hpp"
+#include "Peripherals.hpp"
+#include "Infos.hpp"
+#include "Sources.hpp"
+#include "Utils.hpp"
+
+namespace Sources::Hardware
+{
+    static std::chrono::steady_clock::time_point updateTimer = {};
+
+    static constexpr auto WIND_SPEED_UNIT = PCNT_UNIT_0;
+    static constexpr auto WIND_SPEED_LIMIT = int16_t{32767};
+    static constexpr auto WIND_SPEED_FILTER = uint16_t{1023};
+
+    static int16_t windSpeedLast = 0;
+    static std::vector<uint16_t> windSpeedPulses = {};
+    static std::size_t windSpeedIndex = 0;
+    static uint32_t windSpeedSum = 0;
+    static std::array<std::pair<int64_t, float>, 60> windGustPeaks = {};
+    static float windGustInterval = 0.0f;
+
+    static float pressure = NAN;
+    static float temperature = NAN;
+    static float humidity = NAN;
+    static float windSpeed = NAN;
+    static float windGust = NAN;
+
+    static std::pair<WindDirection, uint16_t> windDirection = {WindDirection::NORTH, 0};
+    static std::pair<RainIntensity, uint16_t> rainIntensity = {RainIntensity::DRY, 0};
+
+    static auto windSpeedInit() -> void
+    {
+        auto config = pcnt_config_t{
+            .pulse_gpio_num = Peripherals::WIND_SPEED,
+            .ctrl_gpio_num = PCNT_PIN_NOT_USED,
+            .lctrl_mode = PCNT_MODE_KEEP,
+            .hctrl_mode = PCNT_MODE_KEEP,
+            .pos_mode = PCNT_COUNT_DIS,
+            .neg_mode = PCNT_COUNT_INC,
+            .counter_h_lim = WIND_SPEED_LIMIT,
+            .counter_l_lim = 0,
+            .unit = WIND_SPEED_UNIT,
+            .channel = PCNT_CHANNEL_0,
+        };
+
+        if ( pcnt_unit_config( &config ) != ESP_OK )
+        {
+            log_e( "pcnt config error" );
+            return;
+        }
+
+        pcnt_set_filter_value( WIND_SPEED_UNIT, WIND_SPEED_FILTER );
+        pcnt_filter_enable( WIND_SPEED_UNIT );
+
+        pcnt_counter_pause( WIND_SPEED_UNIT );
+        pcnt_counter_clear( WIND_SPEED_UNIT );
+        pcnt_counter_resume( WIND_SPEED_UNIT );
+
+        windSpeedLast = 0;
+    }
+
+    static auto windSpeedPulsesRead() -> uint16_t
+    {
+        auto value = int16_t{0};
+        pcnt_get_counter_value( WIND_SPEED_UNIT, &value );
+
+        const auto pulses = static_cast<uint16_t>( value >= windSpeedLast ? value - windSpeedLast : value + WIND_SPEED_LIMIT - windSpeedLast );
+        windSpeedLast = value;
+
+        return pulses;
+    }
+
+    static auto windSpeedFromPulses( uint32_t pulses, std::chrono::milliseconds interval ) -> float
+    {
+        return pulses * ( 2.0f * static_cast<float>( M_PI ) * cfg->windSpeed.radius ) * 3.6f * 1000.0f / interval.count();
+    }
+
+    static auto windSpeedSample() -> void
+    {
+        const auto cadence = std::chrono::milliseconds{std::max<uint16_t>( cfg->windSpeed.cadence, 1 )};
+        const auto ticks = std::max<std::size_t>( 1, std::chrono::milliseconds{3000} / cadence ); // Média de 3 segundos
+
+        if ( windSpeedPulses.size() != ticks )
+        {
+            windSpeedPulses.assign( ticks, 0 );
+            windSpeedIndex = 0;
+            windSpeedSum = 0;
+        }
+
+        const auto pulses = Hardware::windSpeedPulsesRead();
+        windSpeedSum = windSpeedSum - windSpeedPulses[windSpeedIndex] + pulses;
+        windSpeedPulses[windSpeedIndex] = pulses;
+        windSpeedIndex = ( windSpeedIndex + 1 ) % ticks;
+
+        Hardware::windSpeed = Hardware::windSpeedFromPulses( windSpeedSum, cadence * ticks );
+
+        // Picos a cada 10 segundos, últimos 10 minutos; o relógio monotônico não salta com o SNTP
+        const auto slot = static_cast<int64_t>( std::chrono::steady_clock::now().time_since_epoch() / std::chrono::seconds{10} );
+        auto& peak = windGustPeaks[slot % windGustPeaks.size()];
+        if ( peak.first != slot )
+        {
+            peak = {slot, Hardware::windSpeed};
+        }
+        else
+        {
+            peak.second = std::max( peak.second, Hardware::windSpeed );
+        }
+
+        Hardware::windGustInterval = std::max( Hardware::windGustInterval, Hardware::windSpeed );
+
+        Hardware::windGust = 0.0f;
+        for ( const auto& [time, value] : windGustPeaks )
+        {
+            if ( slot - time < static_cast<int64_t>( windGustPeaks.size() ) )
+            {
+                Hardware::windGust = std::max( Hardware::windGust, value );
+            }
+        }
+    }
+
+    static auto init() -> void
+    {
+        log_d( "begin" );
+
+        Atmosphere::init();
+
+        Hardware::windSpeedInit();
+
+        Analog::init();
+
+        log_d( "end" );
+    }
+
+    static auto update() -> void
+    {
+        pressure = Atmosphere::pressure();
+        temperature = Atmosphere::temperature();
+        humidity = Atmosphere::humidity();
+
+        windDirection.second = Analog::windDirection();
+        rainIntensity.second = Analog::rainIntensity();
+
+        if(const auto direction = Classifier::windDirection(windDirection.second))
+        {
+            windDirection.first = *direction;
+        }
+
+        if(const auto intensity = Classifier::rainIntensity(rainIntensity.second))
+        {
+            rainIntensity.first = *intensity;
+        }
+    }
+
+    static auto process() -> void
+    {
+        Atmosphere::process();
+
+        const auto now = std::chrono::steady_clock::now();
+
+        if (now - updateTimer >= std::chrono::milliseconds{1000})
+        {
+            updateTimer = now;
+
+            Hardware::update();
+        }
+
+        Utils::periodic( std::chrono::milliseconds{cfg->windSpeed.cadence}, Hardware::windSpeedSample );
+    }
+
+    static auto read() -> Infos::SensorData
+    {
+        return
+        {
+            .dateTime = std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() ),
+            .temperature = Hardware::temperature,
+            .humidity = Hardware::humidity,
+            .pressure = Hardware::pressure,
+            .windSpeed = Hardware::windSpeed,
+            .windGust = Hardware::windGust,
+            .windDirection = Hardware::windDirection.first,
+            .rainIntensity = Hardware::rainIntensity.first,
+            .windVector = Utils::WindDirection::getAngle( Hardware::windDirection.first ),
+            .windSteadiness = 1.0f,
+        };
+    }
+
+    static auto gust() -> float
+    {
+        return std::exchange( Hardware::windGustInterval, 0.0f );
+    }
+
+    static auto acquire( std::chrono::milliseconds gate ) -> Infos::SensorData
+    {
+        const auto triggered = Atmosphere::init() and Atmosphere::trigger();
+
+        Analog::init();
+        Hardware::windSpeedInit();
+
+        delay(std::max(gate, Atmosphere::conversion()).count());
+
+        if( triggered )
+        {
+            Atmosphere::collect();
+        }
+
+        Hardware::update();
+
+        Hardware::windSpeed = Hardware::windSpeedFromPulses( Hardware::windSpeedPulsesRead(), gate );
+        Hardware::windGust = Hardware::windSpeed;
+
+        return Hardware::read();
+    }
+} // namespace Sources::Hardware
+
+namespace Sources
+{
+    class HardwareSource : public Source
+    {
+        public:
+            auto init() -> void override
+            {
+                Hardware::init();
+            }
+
+            auto process() -> void override
+            {
+                Hardware::process();
+            }
+
+            auto acquire( std::chrono::milliseconds gate ) -> Infos::SensorData override
+            {
+                return Hardware::acquire( gate );
+            }
+
+            auto read() -> Infos::SensorData override
+            {
+                return Hardware::read();
+            }
+
+            auto gust() -> float override
+            {
+                return Hardware::gust();
+            }
+    };
+
+    auto hardware() -> Source&
+    {
+        static auto source = HardwareSource{};
+        return source;
+    }
+} // namespace Sources
\ No newline at end of file
@@ -0,0 +1,359 @@
+#include <Arduino.h>
+
+#include <WiFi.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <esp_log.h>
+#include <mutex>
+#include <optional>
+
+#include "Configuration.hpp"
+#include "Link.hpp"
+#include "Utils.hpp"
+
+namespace Link
+{
+    using Clock = std::chrono::steady_clock;
+
+    // Com canal e BSSID conhecidos não há varredura, a associação sai em poucas centenas de ms
+    static constexpr auto FAST_TIMEOUT = std::chrono::seconds( 3 );
+    static constexpr auto SCAN_TIMEOUT = std::chrono::seconds( 15 );
+    static constexpr auto MIN_BACKOFF = std::chrono::milliseconds( 250 );
+    static constexpr auto MAX_BACKOFF = std::chrono::seconds( 10 );
+    // O ponto de acesso pode ter trocado de canal, de tempos em tempos a tentativa varre todos
+    static constexpr auto SCAN_EVERY = uint32_t{4};
+
+    static_assert( next( State::IDLE, Event::START ) == State::CONNECTING );
+    static_assert( next( State::IDLE, Event::LOST ) == State::IDLE );
+    static_assert( next( State::CONNECTING, Event::GOT_IP ) == State::CONNECTED );
+    static_assert( next( State::CONNECTING, Event::LOST ) == State::BACKOFF );
+    static_assert( next( State::CONNECTING, Event::TIMEOUT ) == State::BACKOFF );
+    static_assert( next( State::CONNECTED, Event::LOST ) == State::CONNECTING );
+    static_assert( next( State::CONNECTED, Event::TIMEOUT ) == State::CONNECTED );
+    static_assert( next( State::BACKOFF, Event::RETRY ) == State::CONNECTING );
+    static_assert( next( State::BACKOFF, Event::STOP ) == State::IDLE );
+
+    static constexpr auto names = Utils::Names<State, 4>
+    {{
+        {State::IDLE, "IDLE"},
+        {State::CONNECTING, "CONNECTING"},
+        {State::CONNECTED, "CONNECTED"},
+        {State::BACKOFF, "BACKOFF"},
+    }};
+
+    struct Notice
+    {
+        Event event;
+        uint8_t reason;
+        uint8_t channel;
+        std::array<uint8_t, 6> bssid;
+    };
+
+    // Último ponto de acesso na memória RTC, o despertar do deep sleep também reconecta direto
+    struct Cache
+    {
+        bool valid;
+        uint8_t channel;
+        std::array<uint8_t, 6> bssid;
+        std::array<char, 33> ssid;
+    };
+
+    RTC_DATA_ATTR static Cache cache = {};
+
+    // Os eventos chegam na tarefa do Wi-Fi, a máquina roda no loop
+    static std::mutex queueMutex = {};
+    static std::array<Notice, 16> queue = {};
+    static std::size_t head = 0;
+    static std::size_t count = 0;
+
+    static std::mutex statsMutex = {};
+    static std::atomic<State> current = State::IDLE;
+    static Clock::time_point entered = {};
+    static Clock::time_point deadline = {};
+    static std::optional<Clock::time_point> lostAt = {};
+    static Notice candidate = {};
+    static bool fast = false;
+    static uint8_t reason = 0;
+    static uint32_t failures = 0;
+    static uint32_t attempts = 0;
+    static uint32_t hits = 0;
+    static uint32_t reconnects = 0;
+    static std::chrono::milliseconds last = {};
+    static std::chrono::milliseconds best = {};
+    static std::chrono::milliseconds worst = {};
+    static std::chrono::milliseconds total = {};
+
+    static auto push( const Notice& notice ) -> void
+    {
+        const auto lock = std::lock_guard{queueMutex};
+
+        if ( count == queue.size() )
+        {
+            log_d( "queue full" );
+            return;
+        }
+
+        queue[( head + count ) % queue.size()] = notice;
+        count++;
+    }
+
+    static auto pop( Notice& notice ) -> bool
+    {
+        const auto lock = std::lock_guard{queueMutex};
+
+        if ( count == 0 )
+        {
+            return false;
+        }
+
+        notice = queue[head];
+        head = ( head + 1 ) % queue.size();
+        count--;
+        return true;
+    }
+
+    static auto handler( arduino_event_id_t id, arduino_event_info_t info ) -> void
+    {
+        auto notice = Notice{};
+
+        switch ( id )
+        {
+            case ARDUINO_EVENT_WIFI_STA_CONNECTED:
+                notice.event = Event::ASSOCIATED;
+                notice.channel = info.wifi_sta_connected.channel;
+                std::copy_n( info.wifi_sta_connected.bssid, notice.bssid.size(), notice.bssid.begin() );
+                break;
+            case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+                notice.event = Event::GOT_IP;
+                break;
+            case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+                // Saída pedida pelo próprio begin() ao trocar de configuração não é queda
+                if ( info.wifi_sta_disconnected.reason == WIFI_REASON_ASSOC_LEAVE )
+                {
+                    return;
+                }
+                notice.event = Event::LOST;
+                notice.reason = info.wifi_sta_disconnected.reason;
+                break;
+            default:
+                return;
+        }
+
+        push( notice );
+    }
+
+    static auto connect( Clock::time_point now ) -> void
+    {
+        const auto snapshot = cfg.get();
+        const auto& station = snapshot->station;
+
+        // Canal memorizado só vale para a mesma rede
+        if ( cache.valid and std::string_view{station.user} != std::string_view{cache.ssid.data()} )
+        {
+            cache.valid = false;
+        }
+
+        fast = cache.valid and ( failures + 1 ) % SCAN_EVERY != 0;
+        attempts++;
+
+        if ( fast )
+        {
+            log_d( "fast channel = %u", cache.channel );
+            WiFi.begin( station.user.data(), station.password.data(), cache.channel, cache.bssid.data() );
+        }
+        else
+        {
+            WiFi.begin( station.user.data(), station.password.data() );
+        }
+
+        deadline = now + ( fast ? FAST_TIMEOUT : SCAN_TIMEOUT );
+    }
+
+    static auto backoff( Clock::time_point now ) -> void
+    {
+        failures++;
+
+        const auto shift = std::min<uint32_t>( failures - 1, 16 );
+        const auto ceiling = std::min<std::chrono::milliseconds>( MIN_BACKOFF * ( 1u << shift ), MAX_BACKOFF );
+        // Metade fixa e metade sorteada, estações vizinhas não voltam todas juntas
+        const auto half = ceiling.count() / 2;
+        const auto delay = std::chrono::milliseconds( half + esp_random() % ( half + 1 ) );
+
+        log_d( "failures = %u delay = %lld", failures, static_cast<long long>( delay.count() ) );
+        deadline = now + delay;
+    }
+
+    static auto connected( Clock::time_point now ) -> void
+    {
+        failures = 0;
+        hits += fast ? 1 : 0;
+
+        cache.valid = true;
+        cache.channel = candidate.channel;
+        cache.bssid = candidate.bssid;
+        std::snprintf( cache.ssid.data(), cache.ssid.size(), "%s", cfg->station.user.data() );
+
+        if ( lostAt )
+        {
+            last = std::chrono::duration_cast<std::chrono::milliseconds>( now - *lostAt );
+            best = reconnects == 0 ? last : std::min( best, last );
+            worst = std::max( worst, last );
+            total += last;
+            reconnects++;
+            lostAt.reset();
+            log_d( "reconnected in %lld ms", static_cast<long long>( last.count() ) );
+        }
+    }
+
+    static auto dispatch( const Notice& notice ) -> void
+    {
+        const auto from = current.load();
+        const auto to = next( from, notice.event );
+
+        if ( notice.event == Event::ASSOCIATED )
+        {
+            candidate = notice;
+        }
+
+        // START sempre refaz a tentativa, as credenciais podem ter mudado
+        if ( to == from and notice.event != Event::START )
+        {
+            return;
+        }
+
+        log_d( "%s -> %s", Utils::nameOf( names, from ).data(), Utils::nameOf( names, to ).data() );
+
+        const auto now = Clock::now();
+        const auto lock = std::lock_guard{statsMutex};
+
+        current = to;
+        entered = now;
+
+        if ( notice.event == Event::LOST )
+        {
+            reason = notice.reason;
+        }
+
+        switch ( to )
+        {
+            case State::IDLE:
+                failures = 0;
+                lostAt.reset();
+                break;
+            case State::CONNECTING:
+                if ( notice.event == Event::START )
+                {
+                    failures = 0;
+                    lostAt.reset();
+                }
+                else if ( from == State::CONNECTED )
+                {
+                    lostAt = now;
+                }
+                connect( now );
+                break;
+            case State::CONNECTED:
+                connected( now );
+                break;
+            case State::BACKOFF:
+                backoff( now );
+                break;
+        }
+    }
+
+    auto init() -> void
+    {
+        log_d( "begin" );
+
+        WiFi.onEvent( handler, ARDUINO_EVENT_WIFI_STA_CONNECTED );
+        WiFi.onEvent( handler, ARDUINO_EVENT_WIFI_STA_GOT_IP );
+        WiFi.onEvent( handler, ARDUINO_EVENT_WIFI_STA_DISCONNECTED );
+
+        log_d( "cache = %u channel = %u", cache.valid, cache.channel );
+        log_d( "end" );
+    }
+
+    static auto flush() -> void
+    {
+        const auto lock = std::lock_guard{queueMutex};
+        head = 0;
+        count = 0;
+    }
+
+    auto start() -> void
+    {
+        flush();
+        dispatch( Notice{.event = Event::START} );
+    }
+
+    auto stop() -> void
+    {
+        flush();
+        dispatch( Notice{.event = Event::STOP} );
+    }
+
+    auto process() -> void
+    {
+        auto notice = Notice{};
+        while ( pop( notice ) )
+        {
+            dispatch( notice );
+        }
+
+        if ( Clock::now() < deadline )
+        {
+            return;
+        }
+
+        if ( current == State::CONNECTING )
+        {
+            dispatch( Notice{.event = Event::TIMEOUT} );
+        }
+        else if ( current == State::BACKOFF )
+        {
+            dispatch( Notice{.event = Event::RETRY} );
+        }
+    }
+
+    auto state() -> State
+    {
+        return current;
+    }
+
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void
+    {
+        const auto lock = std::lock_guard{statsMutex};
+        const auto now = Clock::now();
+
+        json["state"] = Utils::nameOf( names, current.load() ).data();
+        json["since"] = std::chrono::duration_cast<std::chrono::milliseconds>( now - entered ).count();
+        json["attempts"] = attempts;
+        json["failures"] = failures;
+        json["fast"] = hits;
+        json["reason"] = reason;
+
+        json["reconnect"]["count"] = reconnects;
+        json["reconnect"]["last"] = last.count();
+        json["reconnect"]["best"] = best.count();
+        json["reconnect"]["worst"] = worst.count();
+        json["reconnect"]["average"] = reconnects == 0 ? 0 : total.count() / reconnects;
+
+        auto text = std::array<char, 18>{};
+        std::snprintf( text.data(), text.size(), "%02X:%02X:%02X:%02X:%02X:%02X",
+                       cache.bssid[0], cache.bssid[1], cache.bssid[2], cache.bssid[3], cache.bssid[4], cache.bssid[5] );
+
+        json["cache"]["valid"] = cache.valid;
+        json["cache"]["bssid"] = text.data();
+        json["cache"]["channel"] = cache.channel;
+
+        if ( current == State::CONNECTED )
+        {
+            json["rssi"] = WiFi.RSSI();
+        }
+    }
+} // namespace Link
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include <Arduino.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <esp_log.h>
+#include <mutex>
+
+#include "Metrics.hpp"
+#include "Pool.hpp"
+
+namespace Metrics
+{
+    // Histograma em potências de 2 ms: o balde i conta latências abaixo de 2^i ms
+    static constexpr auto BUCKETS = 16u;
+    static constexpr auto ROUTES = 24u;
+
+    struct Stats
+    {
+        const char* name;
+        uint32_t count;
+        uint32_t active;
+        uint32_t peak;
+        uint64_t total;
+        uint32_t max;
+        std::array<uint32_t, BUCKETS> histogram;
+    };
+
+    struct Sockets
+    {
+        std::size_t clients;
+        std::size_t peak;
+        uint32_t delivered;
+        uint32_t dropped;
+    };
+
+    static std::mutex statsMutex = {};
+    static std::array<Stats, ROUTES> stats = {};
+    static std::size_t size = 0;
+    static uint32_t active = 0;
+    static uint32_t peak = 0;
+    static Sockets sockets = {};
+
+    static auto percentile( const Stats& route, float fraction ) -> uint32_t
+    {
+        if ( route.count == 0 )
+        {
+            return 0;
+        }
+
+        const auto target = static_cast<uint32_t>( route.count * fraction );
+        auto seen = 0u;
+        for ( auto i = 0u; i < BUCKETS; ++i )
+        {
+            seen += route.histogram[i];
+            if ( seen > target )
+            {
+                return 1u << i;
+            }
+        }
+        return 1u << BUCKETS;
+    }
+
+    auto route( const char* name ) -> Route
+    {
+        const auto lock = std::lock_guard<std::mutex>{statsMutex};
+
+        for ( auto i = 0u; i < size; ++i )
+        {
+            if ( std::strcmp( stats[i].name, name ) == 0 )
+            {
+                return i;
+            }
+        }
+
+        if ( size == stats.size() )
+        {
+            log_e( "too many routes: %s", name );
+            return stats.size() - 1;
+        }
+
+        stats[size] = Stats{ .name = name };
+        return size++;
+    }
+
+    auto begin( Route route ) -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{statsMutex};
+
+        auto& current = stats[route];
+        current.active += 1;
+        current.peak = std::max( current.peak, current.active );
+
+        active += 1;
+        peak = std::max( peak, active );
+    }
+
+    auto end( Route route, std::chrono::microseconds latency ) -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{statsMutex};
+
+        const auto ms = static_cast<uint32_t>( std::chrono::duration_cast<std::chrono::milliseconds>( latency ).count() );
+        const auto bucket = ms == 0 ? 0u : std::min<uint32_t>( BUCKETS - 1, 32 - __builtin_clz( ms ) );
+
+        auto& current = stats[route];
+        current.active -= std::min<uint32_t>( current.active, 1 );
+        current.count += 1;
+        current.total += ms;
+        current.max = std::max( current.max, ms );
+        current.histogram[bucket] += 1;
+
+        active -= std::min<uint32_t>( active, 1 );
+    }
+
+    // Contagem por cliente: um lento soma em dropped sem apagar a entrega aos demais
+    auto websocket( std::size_t clients, uint32_t delivered, uint32_t dropped ) -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{statsMutex};
+
+        sockets.clients = clients;
+        sockets.peak = std::max( sockets.peak, clients );
+        sockets.delivered += delivered;
+        sockets.dropped += dropped;
+    }
+
+    auto totals() -> Totals
+    {
+        const auto lock = std::lock_guard<std::mutex>{statsMutex};
+
+        auto requests = 0u;
+        for ( auto i = 0u; i < size; ++i )
+        {
+            requests += stats[i].count;
+        }
+        return Totals{ requests, active, peak, sockets.delivered, sockets.dropped };
+    }
+
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{statsMutex};
+
+        json["uptime"] = millis() / 1000;
+        json["heap"]["free"] = ESP.getFreeHeap();
+        json["heap"]["min_free"] = ESP.getMinFreeHeap();
+        json["heap"]["max_alloc"] = ESP.getMaxAllocHeap();
+        json["requests"]["active"] = active;
+        json["requests"]["peak"] = peak;
+
+        json["websocket"]["clients"] = sockets.clients;
+        json["websocket"]["peak"] = sockets.peak;
+        json["websocket"]["delivered"] = sockets.delivered;
+        json["websocket"]["dropped"] = sockets.dropped;
+
+        auto pools = json["pools"];
+        Pool::serialize( pools );
+
+        for ( auto i = 0u; i < size; ++i )
+        {
+            const auto& current = stats[i];
+            auto route = json["routes"][current.name];
+            route["count"] = current.count;
+            route["peak"] = current.peak;
+            route["mean_ms"] = current.count > 0 ? static_cast<float>( current.total ) / current.count : 0.0f;
+            route["p50_ms"] = Metrics::percentile( current, 0.50f );
+            route["p99_ms"] = Metrics::percentile( current, 0.99f );
+            route["max_ms"] = current.max;
+        }
+    }
+} // namespace Metrics
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <cstdlib>
 #include <esp_log.h>
 #include <driver/gpio.h>
+#include <mutex>
 #include <LittleFS.h>
 #include <SD.h>
 
@@ -27,10 +28,29 @@ namespace Peripherals
 
         LittleFS.begin(true);
 
+        log_d( "end" );
+    }
+
+    // O boot monta em segundo plano enquanto o Replay também pode pedir: o segundo espera o primeiro
+    static std::mutex cardMutex = {};
+
+    auto mountCard() -> bool
+    {
+        log_d( "begin" );
+
+        const auto lock = std::lock_guard<std::mutex>{cardMutex};
+
+        if(SD.cardType() != CARD_NONE) {
+            log_d( "already mounted" );
+            return true;
+        }
+
         if(not SD.begin(SD_CARD::SS, SD_CARD::SPI) or SD.cardType() == CARD_NONE) {
             log_e("sd error");
+            return false;
         }
 
         log_d( "end" );
+        return true;
     }
 }; // namespace Peripherals
\ No newline at end of file
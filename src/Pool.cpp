@@ -0,0 +1,45 @@
+#include <Arduino.h>
+
+#include <array>
+#include <esp_log.h>
+#include <mutex>
+
+#include "Pool.hpp"
+
+namespace Pool
+{
+    static std::mutex poolsMutex = {};
+    static std::array<Counted*, 8> pools = {};
+    static std::size_t count = 0;
+
+    auto record( Counted* pool ) -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{poolsMutex};
+
+        if ( count < pools.size() )
+        {
+            pools[count++] = pool;
+        }
+        else
+        {
+            log_e( "too many pools" );
+        }
+    }
+
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{poolsMutex};
+
+        for ( auto i = 0u; i < count; ++i )
+        {
+            const auto stats = pools[i]->snapshot();
+            auto pool = json[stats.name];
+            pool["size"] = stats.size;
+            pool["used"] = stats.used;
+            pool["peak"] = stats.peak;
+            pool["bytes"] = stats.bytes;
+            pool["acquired"] = stats.acquired;
+            pool["exhausted"] = stats.exhausted;
+        }
+    }
+} // namespace Pool
\ No newline at end of file
@@ -5,20 +5,19 @@
 #include <driver/rtc_io.h>
 #include <esp_log.h>
 #include <esp_sleep.h>
-#include <NTPClient.h>
-#include <WiFiUdp.h>
+#include <esp_sntp.h>
+#include <WiFi.h>
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <cstdlib>
-#include <functional>
-#include <future>
-#include <iomanip>
-#include <iostream>
-#include <sstream>
+#include <optional>
 #include <sys/time.h>
-#include <thread>
 
+#include "Bus.hpp"
 #include "Configuration.hpp"
 #include "Database.hpp"
 #include "Peripherals.hpp"
@@ -27,14 +26,160 @@
 
 namespace RealTime
 {
+    // O relógio do sistema guarda a hora local (UTC-3) como se fosse UTC
+    static constexpr auto UTC_OFFSET = std::chrono::seconds{-10800};
+    static constexpr auto SERVER = "br.pool.ntp.org";
+    static constexpr auto NTP_INTERVAL = std::chrono::hours{1};
+    static constexpr auto NTP_VALIDITY = std::chrono::hours{3};
+    static constexpr auto RTC_INTERVAL = std::chrono::hours{1};
+
+    // Acima disso o relógio é ajustado de uma vez, abaixo é corrigido aos poucos com adjtime
+    static constexpr auto STEP_THRESHOLD = std::chrono::seconds{10};
+    static constexpr auto SLEW_THRESHOLD = std::chrono::milliseconds{500};
+
+    // Gravação do DS3231 esperando a virada do segundo, feita pelo loop sem bloquear
+    struct Write
+    {
+        std::chrono::system_clock::time_point reference;
+        std::chrono::steady_clock::time_point taken;
+        std::chrono::system_clock::time_point due;
+        bool restart;
+    };
+
     static RtcDS3231<TwoWire> rtc = {Wire};
-    static WiFiUDP udp = {};
-    static NTPClient ntp = {udp, "br.pool.ntp.org", -10800};
+
+    static std::atomic<int64_t> ntpSynced = 0;
+    static Drift drift = {};
+    static std::optional<Write> pending = {};
+
+    static auto discipline( std::chrono::microseconds offset ) -> void
+    {
+        if ( std::chrono::abs( offset ) >= STEP_THRESHOLD )
+        {
+            auto now = timeval{};
+            gettimeofday( &now, nullptr );
+
+            const auto target = std::chrono::microseconds{now.tv_sec * 1000000ll + now.tv_usec} + offset;
+            const auto time = timeval{static_cast<std::time_t>( target.count() / 1000000 ), static_cast<suseconds_t>( target.count() % 1000000 )};
+            settimeofday( &time, nullptr );
+            Utils::reschedule();
+
+            log_i( "clock stepped by %lld ms", std::chrono::duration_cast<std::chrono::milliseconds>( offset ).count() );
+        }
+        else if ( std::chrono::abs( offset ) >= SLEW_THRESHOLD )
+        {
+            const auto delta = timeval{static_cast<std::time_t>( offset.count() / 1000000 ), static_cast<suseconds_t>( offset.count() % 1000000 )};
+            adjtime( &delta, nullptr );
+
+            log_d( "clock slewing by %lld ms", std::chrono::duration_cast<std::chrono::milliseconds>( offset ).count() );
+        }
+    }
+
+    static auto readRtc() -> std::optional<std::chrono::system_clock::time_point>
+    {
+        const auto dateTime{rtc.GetDateTime()};
+        if ( rtc.LastError() != Rtc_Wire_Error_None )
+        {
+            Bus::error();
+            return {};
+        }
+
+        return std::chrono::system_clock::from_time_t( static_cast<std::time_t>( dateTime.Unix32Time() ) );
+    }
+
+    // reference é a hora certa no instante taken, restart começa uma base nova de deriva
+    static auto scheduleRtc( std::chrono::system_clock::time_point reference, std::chrono::steady_clock::time_point taken, bool restart ) -> void
+    {
+        pending = Write{ reference, taken, Utils::DateTime::ceil( reference, std::chrono::seconds{1} ), restart };
+    }
+
+    // Grava no início de um segundo para não somar meio segundo de erro, o atraso fica no do loop
+    static auto writeRtc() -> void
+    {
+        if ( not pending )
+        {
+            return;
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto reference = pending->reference + std::chrono::duration_cast<std::chrono::system_clock::duration>( now - pending->taken );
+        if ( reference < pending->due )
+        {
+            return;
+        }
+
+        const auto restart = pending->restart;
+        pending.reset();
+
+        RtcDateTime rtcDateTime{};
+        rtcDateTime.InitWithUnix32Time( std::chrono::system_clock::to_time_t( reference ) );
+        rtc.SetDateTime( rtcDateTime );
+        if ( rtc.LastError() != Rtc_Wire_Error_None )
+        {
+            Bus::error();
+            return;
+        }
+
+        if ( restart )
+        {
+            drift.reset( now );
+        }
+    }
 
     static auto syncDateTime() -> void
     {
-        const auto time{timeval{static_cast<std::time_t>( rtc.GetDateTime().Unix32Time() )}};
-        settimeofday( &time, nullptr );
+        if ( const auto dateTime = RealTime::readRtc() )
+        {
+            const auto time{timeval{std::chrono::system_clock::to_time_t( *dateTime )}};
+            settimeofday( &time, nullptr );
+        }
+    }
+
+    // Sem NTP recente o DS3231 é a referência, corrigida aos poucos
+    static auto followRtc() -> void
+    {
+        const auto synced = std::chrono::microseconds{ntpSynced.load()};
+        if ( synced.count() != 0 and std::chrono::steady_clock::now().time_since_epoch() - synced < NTP_VALIDITY )
+        {
+            return;
+        }
+
+        if ( const auto dateTime = RealTime::readRtc() )
+        {
+            RealTime::discipline( std::chrono::duration_cast<std::chrono::microseconds>( *dateTime - std::chrono::system_clock::now() ) );
+        }
+    }
+
+    // Após um sincronismo NTP compara o DS3231 com a hora do servidor, o relógio do sistema pode estar em correção
+    static auto trimRtc( std::chrono::system_clock::time_point ntp, std::chrono::steady_clock::time_point received ) -> void
+    {
+        const auto dateTime = RealTime::readRtc();
+        if ( not dateTime )
+        {
+            return;
+        }
+
+        const auto reference = [ntp, received]
+        {
+            return ntp + std::chrono::duration_cast<std::chrono::system_clock::duration>( std::chrono::steady_clock::now() - received );
+        };
+
+        // A leitura só tem segundos inteiros, tomada no meio do segundo erra no máximo 0,5 s
+        const auto offset = *dateTime + std::chrono::milliseconds{500} - reference();
+        const auto trim = drift.update( std::chrono::duration_cast<std::chrono::steady_clock::duration>( offset ), std::chrono::steady_clock::now() );
+
+        if ( trim.drift )
+        {
+            const auto aging = RealTime::aging( rtc.GetAgingOffset(), *trim.drift );
+            rtc.SetAgingOffset( aging );
+
+            log_i( "rtc drift %.2f ppm, aging offset %d", *trim.drift, aging );
+        }
+
+        if ( trim.write )
+        {
+            RealTime::scheduleRtc( ntp, received, false );
+        }
     }
 
     static auto startHardware() -> void
@@ -49,6 +194,14 @@ namespace RealTime
         rtc.SetIsRunning( true );
     }
 
+    static auto startNtp() -> void
+    {
+        sntp_setoperatingmode( SNTP_OPMODE_POLL );
+        sntp_setservername( 0, SERVER );
+        sntp_set_sync_interval( std::chrono::duration_cast<std::chrono::milliseconds>( NTP_INTERVAL ).count() );
+        sntp_init();
+    }
+
     auto init() -> void
     {
         log_d( "begin" );
@@ -56,23 +209,55 @@ namespace RealTime
         startHardware();
         syncDateTime();
 
-        ntp.begin();
+        startNtp();
 
         log_d( "now = %s", Utils::DateTime::toString( std::chrono::system_clock::now() ).data() );
 
         log_d( "end" );
     }
 
+    auto sync() -> void
+    {
+        startHardware();
+        syncDateTime();
+    }
+
     auto adjustDateTime( const std::chrono::system_clock::time_point& timePoint ) -> void
     {
-        RtcDateTime rtcDateTime{};
-        rtcDateTime.InitWithUnix32Time( std::chrono::system_clock::to_time_t( timePoint ) );
-        rtc.SetDateTime( rtcDateTime );
-        rtc.SetIsRunning( true );
+        Bus::submit( [timePoint]
+        {
+            const auto time{timeval{std::chrono::system_clock::to_time_t( timePoint )}};
+            settimeofday( &time, nullptr );
+            Utils::reschedule();
+
+            rtc.SetIsRunning( true );
+            RealTime::scheduleRtc( std::chrono::system_clock::now(), std::chrono::steady_clock::now(), true );
+        } );
     }
 
     auto process() -> void
     {
-        Utils::periodic( std::chrono::minutes( 5 ), RealTime::syncDateTime );
+        Utils::periodic( RTC_INTERVAL, RealTime::followRtc );
+        RealTime::writeRtc();
     }
-} // namespace RealTime
\ No newline at end of file
+} // namespace RealTime
+
+// Substitui a implementação fraca do SNTP: aplica o fuso e disciplina o relógio em vez de trocá-lo
+extern "C" void sntp_sync_time( struct timeval* tv )
+{
+    using namespace std::chrono;
+
+    const auto received = steady_clock::now();
+    const auto ntp = system_clock::time_point{duration_cast<system_clock::duration>( seconds{tv->tv_sec} + microseconds{tv->tv_usec} )} + RealTime::UTC_OFFSET;
+
+    RealTime::ntpSynced = duration_cast<microseconds>( received.time_since_epoch() ).count();
+    sntp_set_sync_status( SNTP_SYNC_STATUS_COMPLETED );
+
+    // Aqui ainda é a tarefa do lwIP: o ajuste, que pode refazer os agendamentos, fica para o loop
+    Bus::submit( [ntp, received]
+    {
+        const auto reference = ntp + duration_cast<system_clock::duration>( steady_clock::now() - received );
+        RealTime::discipline( duration_cast<microseconds>( reference - system_clock::now() ) );
+        RealTime::trimRtc( ntp, received );
+    } );
+}
\ No newline at end of file
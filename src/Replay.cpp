@@ -0,0 +1,234 @@
+#include <Arduino.h>
+
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "Configuration.hpp"
+#include "Database.hpp"
+#include "Infos.hpp"
+#include "Peripherals.hpp"
+#include "Sources.hpp"
+#include "Utils.hpp"
+
+namespace Sources::Replay
+{
+    static std::FILE* file = nullptr;
+
+    // current é lido pelos pedidos web na tarefa do async_tcp
+    static std::mutex currentMutex = {};
+    static Infos::SensorData current = {};
+    static std::optional<Infos::SensorData> upcoming = {};
+
+    // Relógio do replay: parte da hora do sistema, ou logo depois do último registro, e só avança
+    static std::time_t base = 0;
+    static std::chrono::microseconds advanced = {};
+    static std::chrono::steady_clock::time_point ticked = {};
+
+    // Hora gravada da primeira linha e posição do relógio no início da volta atual
+    static std::time_t origin = 0;
+    static std::chrono::microseconds lap = {};
+
+    // Linha no formato do /data.csv, colunas novas são opcionais
+    static auto parse( const char* line ) -> std::optional<Infos::SensorData>
+    {
+        auto dateTime = std::array<char, 20>{};
+        auto direction = std::array<char, 16>{};
+        auto intensity = std::array<char, 16>{};
+        auto data = Infos::SensorData{};
+
+        const auto fields = std::sscanf( line, "%19[^;];%f;%f;%f;%f;%15[^;];%15[^;\r\n];%f;%f;%f",
+            dateTime.data(),
+            &data.temperature,
+            &data.humidity,
+            &data.pressure,
+            &data.windSpeed,
+            direction.data(),
+            intensity.data(),
+            &data.windGust,
+            &data.windVector,
+            &data.windSteadiness
+        );
+
+        const auto windDirection = Utils::WindDirection::getValue( direction.data() );
+        const auto rainIntensity = Utils::RainIntensity::getValue( intensity.data() );
+        if ( fields < 7 or not windDirection or not rainIntensity )
+        {
+            return {};
+        }
+
+        data.dateTime = std::chrono::system_clock::to_time_t( Utils::DateTime::fromString( dateTime.data() ) );
+        data.temperature /= cfg->temperature.factor;
+        data.humidity /= cfg->humidity.factor;
+        data.pressure /= cfg->pressure.factor;
+        data.windDirection = *windDirection;
+        data.rainIntensity = *rainIntensity;
+
+        if ( fields < 8 )
+        {
+            data.windGust = data.windSpeed;
+        }
+        if ( fields < 10 )
+        {
+            data.windVector = Utils::WindDirection::getAngle( data.windDirection );
+            data.windSteadiness = 1.0f;
+        }
+
+        return data;
+    }
+
+    static auto next() -> std::optional<Infos::SensorData>
+    {
+        auto line = std::array<char, 128>{};
+
+        while ( std::fgets( line.data(), line.size(), file ) != nullptr )
+        {
+            if ( const auto data = Replay::parse( line.data() ) )
+            {
+                return data;
+            }
+            log_d( "invalid row: %s", line.data() );
+        }
+
+        return {};
+    }
+
+    static auto rewind() -> bool
+    {
+        std::rewind( file );
+
+        upcoming = Replay::next();
+        if ( not upcoming )
+        {
+            log_e( "no rows in %s", cfg->source.file.c_str() );
+            return false;
+        }
+
+        origin = upcoming->dateTime;
+        lap = advanced;
+        return true;
+    }
+
+    static auto clock() -> std::time_t
+    {
+        return base + static_cast<std::time_t>( std::chrono::duration_cast<std::chrono::seconds>( advanced ).count() );
+    }
+
+    static auto read() -> Infos::SensorData
+    {
+        const auto lock = std::lock_guard<std::mutex>{currentMutex};
+
+        auto data = current;
+        data.dateTime = Replay::clock();
+        return data;
+    }
+
+    static auto init() -> void
+    {
+        log_d( "begin" );
+
+        if ( file != nullptr )
+        {
+            log_d( "already open" );
+            return;
+        }
+
+        Peripherals::mountCard();
+
+        file = std::fopen( cfg->source.file.c_str(), "r" );
+        if ( file == nullptr )
+        {
+            log_e( "file error: %s", cfg->source.file.c_str() );
+            return;
+        }
+
+        if ( Replay::rewind() )
+        {
+            const auto lock = std::lock_guard<std::mutex>{currentMutex};
+            current = *upcoming;
+        }
+
+        log_d( "end" );
+    }
+
+    // Avança o relógio gravado à velocidade configurada, reinicia no fim do arquivo
+    static auto process() -> void
+    {
+        const auto now = std::chrono::steady_clock::now();
+        const auto lock = std::lock_guard<std::mutex>{currentMutex};
+
+        // No loop o banco já está aberto: registros de uma execução anterior que correu à frente não são repetidos
+        if ( base == 0 )
+        {
+            base = std::max( std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() ), Database::newest() + 1 );
+            ticked = now;
+        }
+
+        // Integrado a cada passo, uma mudança de velocidade não faz o relógio voltar
+        advanced += std::chrono::duration_cast<std::chrono::microseconds>( now - ticked ) * cfg->source.speed;
+        ticked = now;
+
+        if ( file == nullptr or not upcoming )
+        {
+            return;
+        }
+
+        const auto target = origin + static_cast<std::time_t>( std::chrono::duration_cast<std::chrono::seconds>( advanced - lap ).count() );
+
+        while ( upcoming and upcoming->dateTime <= target )
+        {
+            current = *upcoming;
+            upcoming = Replay::next();
+        }
+
+        if ( not upcoming )
+        {
+            log_i( "replay restarted" );
+            Replay::rewind();
+        }
+    }
+} // namespace Sources::Replay
+
+namespace Sources
+{
+    class ReplaySource : public Source
+    {
+        public:
+            auto init() -> void override
+            {
+                Replay::init();
+            }
+
+            auto process() -> void override
+            {
+                Replay::process();
+            }
+
+            auto acquire( std::chrono::milliseconds gate ) -> Infos::SensorData override
+            {
+                Replay::init();
+                Replay::process();
+                return Replay::read();
+            }
+
+            auto read() -> Infos::SensorData override
+            {
+                return Replay::read();
+            }
+
+            auto clock() -> std::optional<std::time_t> override
+            {
+                const auto lock = std::lock_guard<std::mutex>{Replay::currentMutex};
+                return Replay::clock();
+            }
+    };
+
+    auto replay() -> Source&
+    {
+        static auto source = ReplaySource{};
+        return source;
+    }
+} // namespace Sources
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include <Arduino.h>
+
+#include <WiFi.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <esp_log.h>
+#include <esp_sleep.h>
+#include <vector>
+
+#include "Configuration.hpp"
+#include "Database.hpp"
+#include "Infos.hpp"
+#include "Peripherals.hpp"
+#include "RealTime.hpp"
+#include "Sleep.hpp"
+#include "Utils.hpp"
+
+namespace Sleep
+{
+    // Amostra compacta, a memória RTC tem só 8 KiB
+    struct Sample
+    {
+        uint32_t dateTime;
+        float temperature;
+        float humidity;
+        float pressure;
+        float windSpeed;
+        uint8_t windDirection;
+        uint8_t rainIntensity;
+
+        static auto pack( const Infos::SensorData& data ) -> Sample
+        {
+            return Sample{
+                .dateTime = static_cast<uint32_t>( data.dateTime ),
+                .temperature = data.temperature,
+                .humidity = data.humidity,
+                .pressure = data.pressure,
+                .windSpeed = data.windSpeed,
+                .windDirection = static_cast<uint8_t>( data.windDirection ),
+                .rainIntensity = static_cast<uint8_t>( data.rainIntensity ),
+            };
+        }
+
+        auto unpack() const -> Infos::SensorData
+        {
+            return Infos::SensorData{
+                .dateTime = static_cast<std::time_t>( this->dateTime ),
+                .temperature = this->temperature,
+                .humidity = this->humidity,
+                .pressure = this->pressure,
+                .windSpeed = this->windSpeed,
+                .windGust = this->windSpeed,
+                .windDirection = static_cast<WindDirection>( this->windDirection ),
+                .rainIntensity = static_cast<RainIntensity>( this->rainIntensity ),
+                .windVector = Utils::WindDirection::getAngle( static_cast<WindDirection>( this->windDirection ) ),
+                .windSteadiness = 1.0f,
+            };
+        }
+    };
+
+    RTC_DATA_ATTR static Batch<Sample, 96> batch = {};
+
+    static std::chrono::steady_clock::time_point awakeTimer = {};
+
+    static auto windowOf( std::time_t dateTime ) -> std::time_t
+    {
+        return dateTime - dateTime % cfg->deepSleep.window;
+    }
+
+    static auto sampleWindow( const Sample& sample ) -> std::time_t
+    {
+        return Sleep::windowOf( static_cast<std::time_t>( sample.dateTime ) );
+    }
+
+    static auto flush( std::time_t window, const Sample* samples, std::size_t count ) -> bool
+    {
+        log_d( "begin" );
+
+        if ( not Peripherals::mountCard() )
+        {
+            return false;
+        }
+
+        Database::init();
+
+        auto accumulator = Database::Accumulator{};
+        for ( auto i = 0u; i < count; ++i )
+        {
+            accumulator.add( samples[i].unpack() );
+        }
+
+        auto current = samples[count - 1].unpack();
+        current.dateTime = window + cfg->deepSleep.window;
+
+        Database::insert( accumulator.result( current ) );
+
+        if ( cfg->archive.enabled )
+        {
+            auto raw = std::vector<Infos::SensorData>{};
+            raw.reserve( count );
+            for ( auto i = 0u; i < count; ++i )
+            {
+                raw.push_back( samples[i].unpack() );
+            }
+            Database::archive( raw );
+        }
+
+        if ( current.dateTime % 86400 == 0 )
+        {
+            Database::cleanup();
+        }
+
+        log_d( "end" );
+        return true;
+    }
+
+    static auto push( const Infos::SensorData& sample ) -> void
+    {
+        // Janelas que ficaram para trás com o cartão fora saem cada uma no seu registro
+        const auto discarded = batch.push( Sample::pack( sample ), Sleep::sampleWindow, Sleep::flush );
+        if ( discarded > 0 )
+        {
+            log_e( "window discarded, samples = %u", discarded );
+        }
+    }
+
+    static auto collect() -> void
+    {
+        Sleep::push( Infos::SensorData::get() );
+    }
+
+    static auto sleep() -> void
+    {
+        const auto now = std::chrono::system_clock::now();
+        const auto wake = Utils::DateTime::ceil( now + std::chrono::milliseconds{1}, std::chrono::seconds{cfg->deepSleep.interval} );
+
+        log_d( "sleeping for %lld ms, samples = %u", std::chrono::duration_cast<std::chrono::milliseconds>( wake - now ).count(), batch.size() );
+
+        WiFi.mode( WIFI_MODE_NULL );
+
+        esp_sleep_enable_timer_wakeup( std::chrono::duration_cast<std::chrono::microseconds>( wake - now ).count() );
+        esp_deep_sleep_start();
+    }
+
+    auto init() -> void
+    {
+        log_d( "begin" );
+
+        if ( not cfg->deepSleep.enabled or esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER )
+        {
+            awakeTimer = std::chrono::steady_clock::now() + std::chrono::seconds{cfg->deepSleep.awake};
+
+            log_d( "end" );
+            return;
+        }
+
+        RealTime::sync();
+
+        const auto sample = Infos::acquire( std::chrono::milliseconds{1000} );
+        const auto flushing = batch.size() > 0 and batch.front( Sleep::sampleWindow ).first != Sleep::windowOf( sample.dateTime );
+
+        Sleep::push( sample );
+
+        if ( flushing and cfg->deepSleep.online > 0 )
+        {
+            awakeTimer = std::chrono::steady_clock::now() + std::chrono::seconds{cfg->deepSleep.online};
+
+            log_d( "end" );
+            return;
+        }
+
+        Sleep::sleep();
+    }
+
+    auto process() -> void
+    {
+        if ( not cfg->deepSleep.enabled )
+        {
+            return;
+        }
+
+        Utils::bound( std::chrono::seconds{cfg->deepSleep.interval}, Sleep::collect );
+
+        if ( std::chrono::steady_clock::now() >= awakeTimer )
+        {
+            Sleep::sleep();
+        }
+    }
+} // namespace Sleep
\ No newline at end of file
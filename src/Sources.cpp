@@ -0,0 +1,22 @@
+#include <Arduino.h>
+
+#include "Configuration.hpp"
+#include "Sources.hpp"
+
+namespace Sources
+{
+    auto select( SensorSource type ) -> Source&
+    {
+        switch ( type )
+        {
+            case SensorSource::SYNTHETIC:
+                log_i( "synthetic source" );
+                return Sources::synthetic();
+            case SensorSource::REPLAY:
+                log_i( "replay source" );
+                return Sources::replay();
+            default:
+                return Sources::hardware();
+        }
+    }
+} // namespace Sources
\ No newline at end of file
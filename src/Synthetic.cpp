@@ -0,0 +1,132 @@
+#include <Arduino.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+
+#include "Configuration.hpp"
+#include "Infos.hpp"
+#include "Sources.hpp"
+#include "Utils.hpp"
+
+namespace Sources::Synthetic
+{
+    static constexpr auto DAY = 86400.0f;
+
+    static std::minstd_rand random{ 0x5eed };
+    static std::chrono::system_clock::time_point updateTimer = {};
+
+    static Infos::SensorData current = {};
+
+    static auto uniform( float min, float max ) -> float
+    {
+        return std::uniform_real_distribution<float>{ min, max }( random );
+    }
+
+    static auto update() -> void
+    {
+        const auto now = std::chrono::system_clock::now();
+        const auto dateTime = std::chrono::system_clock::to_time_t( now );
+
+        // Ciclo diário com mínima às 3h e máxima às 15h, maré barométrica de 12h
+        const auto phase = 2.0f * static_cast<float>( M_PI ) * static_cast<float>( dateTime % 86400 ) / DAY;
+        const auto daily = -std::cos( phase - static_cast<float>( M_PI ) / 4.0f );
+
+        const auto temperature = 22.0f + 6.0f * daily + uniform( -0.2f, 0.2f );
+        const auto humidity = std::clamp( 65.0f - 20.0f * daily + uniform( -1.0f, 1.0f ), 0.0f, 100.0f );
+        const auto pressure = 1013.0f + 1.5f * std::cos( 2.0f * phase ) + uniform( -0.1f, 0.1f );
+
+        const auto windSpeed = std::max( 0.0f, 8.0f + 4.0f * daily + uniform( -3.0f, 3.0f ) );
+        const auto windGust = std::max( windSpeed * uniform( 1.2f, 1.8f ), current.windGust * 0.98f );
+
+        // Direção persiste, muda em 10% das atualizações
+        auto direction = static_cast<int>( current.windDirection == WindDirection{} ? WindDirection::EAST : current.windDirection );
+        const auto step = uniform( 0.0f, 1.0f );
+        if ( step < 0.1f )
+        {
+            direction = static_cast<int>( uniform( 1.0f, 8.99f ) );
+        }
+
+        auto rain = static_cast<int>( current.rainIntensity );
+        const auto change = uniform( 0.0f, 1.0f );
+        if ( change < 0.002f )
+        {
+            rain = std::min( rain + 1, static_cast<int>( RainIntensity::RAINY ) );
+        }
+        else if ( change > 0.996f )
+        {
+            rain = std::max( rain - 1, static_cast<int>( RainIntensity::DRY ) );
+        }
+
+        current = Infos::SensorData{
+            .dateTime = dateTime,
+            .temperature = temperature / cfg->temperature.factor,
+            .humidity = humidity / cfg->humidity.factor,
+            .pressure = pressure / cfg->pressure.factor,
+            .windSpeed = windSpeed,
+            .windGust = windGust,
+            .windDirection = static_cast<WindDirection>( direction ),
+            .rainIntensity = static_cast<RainIntensity>( rain ),
+            .windVector = Utils::WindDirection::getAngle( static_cast<WindDirection>( direction ) ),
+            .windSteadiness = 1.0f,
+        };
+    }
+
+    static auto init() -> void
+    {
+        log_d( "begin" );
+
+        Synthetic::update();
+
+        log_d( "end" );
+    }
+
+    static auto process() -> void
+    {
+        const auto now = std::chrono::system_clock::now();
+
+        if ( now - updateTimer >= std::chrono::milliseconds{1000} )
+        {
+            updateTimer = now;
+
+            Synthetic::update();
+        }
+    }
+} // namespace Sources::Synthetic
+
+namespace Sources
+{
+    class SyntheticSource : public Source
+    {
+        public:
+            auto init() -> void override
+            {
+                Synthetic::init();
+            }
+
+            auto process() -> void override
+            {
+                Synthetic::process();
+            }
+
+            auto acquire( std::chrono::milliseconds gate ) -> Infos::SensorData override
+            {
+                Synthetic::update();
+                return Synthetic::current;
+            }
+
+            auto read() -> Infos::SensorData override
+            {
+                auto data = Synthetic::current;
+                data.dateTime = std::chrono::system_clock::to_time_t( std::chrono::system_clock::now() );
+                return data;
+            }
+    };
+
+    auto synthetic() -> Source&
+    {
+        static auto source = SyntheticSource{};
+        return source;
+    }
+} // namespace Sources
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include <Arduino.h>
+
+#include <HTTPClient.h>
+#include <WiFi.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <esp_log.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <mqtt_client.h>
+#include <mutex>
+
+#include "Configuration.hpp"
+#include "Database.hpp"
+#include "Infos.hpp"
+#include "Uplink.hpp"
+#include "Utils.hpp"
+
+namespace Uplink
+{
+    static constexpr auto MAX_BATCH = std::size_t{64};
+    static constexpr auto POLL = std::chrono::seconds( 30 );
+    static constexpr auto TIMEOUT = std::chrono::seconds( 10 );
+    // Com atraso acumulado os lotes seguem em sequência, mas espaçados para não saturar o link recém-recuperado
+    static constexpr auto PACE = std::chrono::seconds( 2 );
+    static constexpr auto MIN_BACKOFF = std::chrono::seconds( 5 );
+    static constexpr auto MAX_BACKOFF = std::chrono::seconds( 900 );
+
+    struct Batch
+    {
+        std::size_t length;
+        uint16_t count;
+        Database::Uplink::Mark last;
+    };
+
+    static TaskHandle_t task = nullptr;
+
+    // Mesmo formato do /data.csv, o lote inteiro cabe no buffer
+    static std::array<char, sizeof( Infos::SensorData::HEADER ) + MAX_BATCH * 100> payload = {};
+
+    static std::mutex statsMutex = {};
+    static Database::Uplink::Mark mark = {};
+    static uint32_t pending = 0;
+    static uint32_t batches = 0;
+    static uint32_t records = 0;
+    static uint64_t bytes = 0;
+    static uint32_t failures = 0;
+    static std::atomic<int> status = 0;
+    static std::chrono::seconds backoff = {};
+
+    namespace Mqtt
+    {
+        static esp_mqtt_client_handle_t client = nullptr;
+        static FixedString<97> uri = {};
+        static std::atomic<bool> connected = false;
+
+        static auto handler( void*, esp_event_base_t, int32_t id, void* data ) -> void
+        {
+            const auto event = static_cast<esp_mqtt_event_handle_t>( data );
+            switch ( static_cast<esp_mqtt_event_id_t>( id ) )
+            {
+                case MQTT_EVENT_CONNECTED:
+                    connected = true;
+                    break;
+                case MQTT_EVENT_DISCONNECTED:
+                    connected = false;
+                    break;
+                case MQTT_EVENT_PUBLISHED:
+                    xTaskNotify( task, static_cast<uint32_t>( event->msg_id ), eSetValueWithOverwrite );
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        static auto stop() -> void
+        {
+            if ( client == nullptr )
+            {
+                return;
+            }
+            esp_mqtt_client_destroy( client );
+            client = nullptr;
+            connected = false;
+        }
+
+        // Refeito só quando o endereço muda, a reconexão fica por conta do próprio cliente
+        static auto start( const FixedString<97>& url ) -> bool
+        {
+            if ( client != nullptr and uri == url )
+            {
+                return true;
+            }
+            Mqtt::stop();
+
+            auto config = esp_mqtt_client_config_t{};
+            config.uri = url.c_str();
+            config.network_timeout_ms = std::chrono::duration_cast<std::chrono::milliseconds>( TIMEOUT ).count();
+            config.buffer_size = payload.size() + 256;
+
+            client = esp_mqtt_client_init( &config );
+            if ( client == nullptr )
+            {
+                log_e( "mqtt init error" );
+                return false;
+            }
+            esp_mqtt_client_register_event( client, MQTT_EVENT_ANY, Mqtt::handler, nullptr );
+            if ( esp_mqtt_client_start( client ) != ESP_OK )
+            {
+                log_e( "mqtt start error" );
+                Mqtt::stop();
+                return false;
+            }
+
+            uri = url;
+            return true;
+        }
+
+        // QoS 1: só conta como entregue depois do PUBACK do broker
+        static auto send( const Configuration& current, const Batch& batch ) -> bool
+        {
+            if ( not Mqtt::start( current.uplink.url ) or not connected )
+            {
+                status = -1;
+                return false;
+            }
+
+            xTaskNotifyStateClear( nullptr );
+            const auto id = esp_mqtt_client_publish( client, current.uplink.topic.c_str(), payload.data(), batch.length, 1, 0 );
+            status = id;
+            if ( id < 0 )
+            {
+                return false;
+            }
+
+            auto acked = uint32_t{0};
+            while ( xTaskNotifyWait( 0, UINT32_MAX, &acked, pdMS_TO_TICKS( std::chrono::duration_cast<std::chrono::milliseconds>( TIMEOUT ).count() ) ) == pdTRUE )
+            {
+                if ( acked == static_cast<uint32_t>( id ) )
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+    } // namespace Mqtt
+
+    namespace Http
+    {
+        static auto send( const Configuration& current, const Batch& batch ) -> bool
+        {
+            auto http = HTTPClient{};
+            http.setTimeout( std::chrono::duration_cast<std::chrono::milliseconds>( TIMEOUT ).count() );
+            if ( not http.begin( current.uplink.url.c_str() ) )
+            {
+                status = -1;
+                return false;
+            }
+
+            http.addHeader( "Content-Type", "text/csv" );
+            http.addHeader( "X-Station", WiFi.macAddress() );
+            status = http.POST( reinterpret_cast<uint8_t*>( payload.data() ), batch.length );
+            http.end();
+
+            return status >= 200 and status < 300;
+        }
+    } // namespace Http
+
+    static auto collect( const Database::Uplink::Mark& from, uint16_t limit ) -> Batch
+    {
+        const auto header = std::strlen( Infos::SensorData::HEADER );
+        std::memcpy( payload.data(), Infos::SensorData::HEADER, header );
+
+        auto batch = Batch{ header, 0, from };
+        auto row = std::array<char, 100>{};
+        Database::Uplink::collect( from, limit, [&]( int64_t sequence, const Infos::SensorData& sensorData )
+        {
+            const auto length = sensorData.serialize( row );
+            if ( length > 0 and batch.length + length > payload.size() )
+            {
+                return false;
+            }
+            // Registro que não vira texto não tem como sair, a marca passa por ele
+            if ( length > 0 )
+            {
+                std::memcpy( payload.data() + batch.length, row.data(), length );
+                batch.length += length;
+                batch.count += 1;
+            }
+            batch.last = { sequence, std::max( batch.last.dateTime, sensorData.dateTime ) };
+            return true;
+        } );
+        return batch;
+    }
+
+    static auto wait( std::chrono::milliseconds duration ) -> void
+    {
+        vTaskDelay( pdMS_TO_TICKS( duration.count() ) );
+    }
+
+    static auto run( void* ) -> void
+    {
+        {
+            const auto lock = std::lock_guard<std::mutex>{statsMutex};
+            mark = Database::Uplink::mark();
+        }
+        auto flushed = std::chrono::steady_clock::now();
+
+        while ( true )
+        {
+            const auto current = cfg.get();
+            if ( not current->uplink.enabled or current->uplink.protocol != UplinkProtocol::MQTT )
+            {
+                Mqtt::stop();
+            }
+            if ( not current->uplink.enabled or not WiFi.isConnected() )
+            {
+                Uplink::wait( POLL );
+                continue;
+            }
+
+            // Registros mais novos apagados: o ROWID volta a ser usado e a marca fica à frente
+            if ( Database::Uplink::regressed( mark ) )
+            {
+                const auto resynced = Database::Uplink::resync( mark );
+                log_w( "uplink mark regressed, sequence = %lld -> %lld", static_cast<long long>( mark.sequence ), static_cast<long long>( resynced.sequence ) );
+                Database::Uplink::advance( resynced );
+                const auto lock = std::lock_guard<std::mutex>{statsMutex};
+                mark = resynced;
+            }
+
+            // Um lote sai quando enche ou quando o registro mais antigo já esperou o bastante
+            const auto waiting = Database::Uplink::pending( mark );
+            {
+                const auto lock = std::lock_guard<std::mutex>{statsMutex};
+                pending = waiting;
+            }
+            const auto due = std::chrono::steady_clock::now() - flushed >= std::chrono::seconds( current->uplink.interval );
+            if ( waiting == 0 or ( waiting < current->uplink.batch and not due ) )
+            {
+                Uplink::wait( POLL );
+                continue;
+            }
+
+            const auto batch = Uplink::collect( mark, current->uplink.batch );
+            if ( batch.count == 0 )
+            {
+                // Nada para enviar, só registros ilegíveis: a marca anda sem mandar lote vazio
+                if ( batch.last.sequence != mark.sequence )
+                {
+                    Database::Uplink::advance( batch.last );
+                    const auto lock = std::lock_guard<std::mutex>{statsMutex};
+                    mark = batch.last;
+                }
+                Uplink::wait( POLL );
+                continue;
+            }
+
+            const auto sent = current->uplink.protocol == UplinkProtocol::MQTT ? Mqtt::send( *current, batch ) : Http::send( *current, batch );
+            if ( not sent )
+            {
+                {
+                    const auto lock = std::lock_guard<std::mutex>{statsMutex};
+                    failures += 1;
+                    backoff = std::clamp( backoff * 2, MIN_BACKOFF, MAX_BACKOFF );
+                }
+                log_w( "uplink failed, status = %d, retry in %lld s", status.load(), backoff.count() );
+                Uplink::wait( backoff );
+                continue;
+            }
+
+            Database::Uplink::advance( batch.last );
+            flushed = std::chrono::steady_clock::now();
+            auto more = false;
+            {
+                const auto lock = std::lock_guard<std::mutex>{statsMutex};
+                mark = batch.last;
+                pending = waiting - std::min<uint32_t>( waiting, batch.count );
+                more = pending > 0;
+                batches += 1;
+                records += batch.count;
+                bytes += batch.length;
+                backoff = {};
+            }
+            log_d( "uplink sent, records = %u, bytes = %u", batch.count, batch.length );
+
+            Uplink::wait( more ? std::chrono::milliseconds( PACE ) : std::chrono::milliseconds( POLL ) );
+        }
+    }
+
+    auto init() -> void
+    {
+        log_d( "begin" );
+
+        xTaskCreatePinnedToCore( Uplink::run, "uplink", 6144, nullptr, 1, &task, 0 );
+
+        log_d( "end" );
+    }
+
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void
+    {
+        const auto current = cfg.get();
+        const auto lock = std::lock_guard<std::mutex>{statsMutex};
+
+        auto text = Utils::DateTime::Text{};
+        json["enabled"] = current->uplink.enabled;
+        json["protocol"] = Utils::UplinkProtocol::getName( current->uplink.protocol ).data();
+        Utils::DateTime::toString( std::chrono::system_clock::from_time_t( mark.dateTime ), text );
+        json["mark"] = text.data();
+        json["sequence"] = mark.sequence;
+        json["pending"] = pending;
+        json["batches"] = batches;
+        json["records"] = records;
+        json["bytes"] = bytes;
+        json["failures"] = failures;
+        json["status"] = status.load();
+        json["backoff"] = backoff.count();
+        json["connected"] = Mqtt::connected.load();
+    }
+} // namespace Uplink
\ No newline at end of file
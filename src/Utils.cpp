@@ -2,6 +2,9 @@
 #include <unordered_map>
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
+#include <array>
+#include <numeric>
 
 #include "Configuration.hpp"
 #include "Utils.hpp"
@@ -11,64 +14,56 @@ namespace Utils
 {
     namespace WindDirection 
     {
-        auto getName(::WindDirection dir) -> std::string 
+        auto getAngle(::WindDirection dir) -> float
         {
-            static const auto windToStr = std::unordered_map<::WindDirection, std::string>
+            static constexpr auto windToAngle = std::array<float, 8>
             {
-                {::WindDirection::NORTH,     "Norte"},
-                {::WindDirection::SOUTH,     "Sul"},
-                {::WindDirection::EAST,      "Leste"},
-                {::WindDirection::WEST,      "Oeste"},
-                {::WindDirection::NORTHEAST, "Nordeste"},
-                {::WindDirection::SOUTHEAST, "Sudeste"},
-                {::WindDirection::SOUTHWEST, "Sudoeste"},
-                {::WindDirection::NORTHWEST, "Noroeste"},
+                0.0f,   // NORTH
+                180.0f, // SOUTH
+                90.0f,  // EAST
+                270.0f, // WEST
+                45.0f,  // NORTHEAST
+                135.0f, // SOUTHEAST
+                225.0f, // SOUTHWEST
+                315.0f, // NORTHWEST
             };
-            return windToStr.at(dir);
-        }
-
-        auto getValue(const std::string& name) -> ::WindDirection 
-        {
-            static const auto strToWind = std::unordered_map<std::string, ::WindDirection>
-            {
-                {"Norte",    ::WindDirection::NORTH},
-                {"Sul",      ::WindDirection::SOUTH},
-                {"Leste",    ::WindDirection::EAST},
-                {"Oeste",    ::WindDirection::WEST},
-                {"Nordeste", ::WindDirection::NORTHEAST},
-                {"Sudeste",  ::WindDirection::SOUTHEAST},
-                {"Sudoeste", ::WindDirection::SOUTHWEST},
-                {"Noroeste", ::WindDirection::NORTHWEST},
-            };
-            return strToWind.at(name);
+            return windToAngle.at(static_cast<std::size_t>(dir) - 1);
         }
     }
 
-    namespace RainIntensity 
+    namespace Samples
     {
-        auto getName(::RainIntensity dir) -> std::string 
+        auto median( std::vector<uint16_t>& samples ) -> uint16_t
         {
-            static const auto rainToStr = std::unordered_map<::RainIntensity, std::string>
+            if( samples.empty() )
             {
-                {::RainIntensity::DRY,   "Seco"},
-                {::RainIntensity::HUMID, "Umido"},
-                {::RainIntensity::RAINY, "Chuva"},
-            };
-            return rainToStr.at(dir);
+                return 0;
+            }
+
+            const auto middle = samples.begin() + samples.size() / 2;
+            std::nth_element( samples.begin(), middle, samples.end() );
+            return *middle;
         }
 
-        auto getValue(const std::string& name) -> ::RainIntensity 
+        auto trimmedMean( std::vector<uint16_t>& samples, float trim ) -> uint16_t
         {
-            static const auto strToRain = std::unordered_map<std::string, ::RainIntensity>
+            const auto cut = static_cast<std::size_t>( samples.size() * trim );
+            if( cut * 2 >= samples.size() )
             {
-                {"Seco",       ::RainIntensity::DRY},
-                {"Umido",      ::RainIntensity::HUMID},
-                {"Chuva",      ::RainIntensity::RAINY},
-            };
-            return strToRain.at(name);
+                return Samples::median( samples );
+            }
+
+            const auto first = samples.begin() + cut;
+            const auto last = samples.end() - cut;
+            std::nth_element( samples.begin(), first, samples.end() );
+            std::nth_element( first, last, samples.end() );
+
+            const auto sum = std::accumulate( first, last, uint32_t{0} );
+            const auto count = static_cast<uint32_t>( last - first );
+            return static_cast<uint16_t>( ( sum + count / 2 ) / count );
         }
     }
-    
+
     static std::unordered_map<void( * )(), std::chrono::system_clock::time_point> timers{};
     auto periodic( std::chrono::milliseconds interval, void( *func )() ) -> void
     {
@@ -121,22 +116,39 @@ namespace Utils
         }
     }
 
+    // Após um ajuste de relógio os agendamentos são refeitos a partir da nova hora
+    auto reschedule() -> void
+    {
+        Utils::timers.clear();
+    }
+
     namespace DateTime
     {
         auto fromString( const std::string& str ) -> std::chrono::system_clock::time_point
         {
-            auto stream{std::istringstream{str}};
+            return DateTime::fromString( str.c_str() );
+        }
+
+        // Versões sem string temporária, usadas nos caminhos do servidor
+        auto fromString( const char* str ) -> std::chrono::system_clock::time_point
+        {
             auto time{std::tm{}};
-            stream >> std::get_time( &time, "%Y-%m-%d %H:%M:%S" );
+            strptime( str, "%Y-%m-%d %H:%M:%S", &time );
             return std::chrono::system_clock::from_time_t( std::mktime( &time ) );
         }
 
         auto toString( const std::chrono::system_clock::time_point& timePoint ) -> std::string
         {
-            auto stream{std::ostringstream{}};
+            auto text{Text{}};
+            return DateTime::toString( timePoint, text );
+        }
+
+        auto toString( const std::chrono::system_clock::time_point& timePoint, Text& text ) -> const char*
+        {
             auto time{std::chrono::system_clock::to_time_t( timePoint )};
-            stream << std::put_time( std::localtime( &time ), "%Y-%m-%d %H:%M:%S" );
-            return stream.str();
+            auto local{std::tm{}};
+            std::strftime( text.data(), text.size(), "%Y-%m-%d %H:%M:%S", localtime_r( &time, &local ) );
+            return text.data();
         }
 
         auto fromStringHttp( const std::string& str ) -> std::chrono::system_clock::time_point
@@ -0,0 +1,425 @@
+#include <Arduino.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <esp_log.h>
+#include <sqlite3.h>
+
+#include "Vfs.hpp"
+
+// VFS sobre o padrão: junta escritas em blocos alinhados e lê adiante em varreduras
+namespace Vfs
+{
+    static constexpr auto SECTOR = sqlite3_int64{512};
+    static constexpr auto BLOCK = sqlite3_int64{8192};
+    static constexpr auto SECTORS = BLOCK / SECTOR;
+
+    struct Counter
+    {
+        std::atomic<uint32_t> count;
+        std::atomic<uint64_t> bytes;
+
+        auto add( sqlite3_int64 length ) -> void
+        {
+            this->count += 1;
+            this->bytes += length;
+        }
+    };
+
+    // Pedidos do SQLite e o que de fato chega ao cartão
+    struct Stats
+    {
+        Counter reads;
+        Counter writes;
+        Counter hits;
+        Counter deviceReads;
+        Counter deviceWrites;
+        Counter syncs;
+        Counter truncates;
+    };
+
+    struct File
+    {
+        sqlite3_file base;
+        sqlite3_file* real;
+        sqlite3_int64 size;
+        sqlite3_int64 offset;
+        sqlite3_int64 length;
+        sqlite3_int64 lastRead;
+        uint16_t valid;
+        uint16_t dirty;
+        bool cached;
+        std::array<uint8_t, BLOCK> block;
+    };
+
+    static sqlite3_vfs vfs = {};
+    static sqlite3_vfs* parent = nullptr;
+    static Stats stats = {};
+
+    static auto alignDown( sqlite3_int64 value, sqlite3_int64 alignment ) -> sqlite3_int64
+    {
+        return value - value % alignment;
+    }
+
+    static auto alignUp( sqlite3_int64 value, sqlite3_int64 alignment ) -> sqlite3_int64
+    {
+        return alignDown( value + alignment - 1, alignment );
+    }
+
+    // Máscara dos setores do bloco que o trecho [start, end) toca
+    static auto sectors( sqlite3_int64 start, sqlite3_int64 end ) -> uint16_t
+    {
+        const auto first = start / SECTOR;
+        const auto last = ( end + SECTOR - 1 ) / SECTOR;
+        return static_cast<uint16_t>( ( ( 1u << last ) - 1 ) & ~( ( 1u << first ) - 1 ) );
+    }
+
+    // Setores sujos vizinhos saem numa única escrita, sem passar do fim do arquivo
+    static auto flush( File* file ) -> int
+    {
+        auto rc = SQLITE_OK;
+
+        for ( auto first = 0; first < SECTORS and rc == SQLITE_OK; )
+        {
+            if ( ( file->dirty & ( 1u << first ) ) == 0 )
+            {
+                first += 1;
+                continue;
+            }
+
+            auto last = first;
+            while ( last < SECTORS and ( file->dirty & ( 1u << last ) ) != 0 )
+            {
+                last += 1;
+            }
+
+            const auto start = first * SECTOR;
+            const auto end = std::min( last * SECTOR, file->length );
+            rc = file->real->pMethods->xWrite( file->real, file->block.data() + start, end - start, file->offset + start );
+            stats.deviceWrites.add( end - start );
+            first = last;
+        }
+
+        file->dirty = 0;
+        return rc;
+    }
+
+    // Troca o bloco em cache, lendo só os setores pedidos
+    static auto load( File* file, sqlite3_int64 offset, uint16_t mask ) -> int
+    {
+        if ( not file->cached or file->offset != alignDown( offset, BLOCK ) )
+        {
+            const auto rc = Vfs::flush( file );
+            if ( rc != SQLITE_OK )
+            {
+                return rc;
+            }
+
+            file->offset = alignDown( offset, BLOCK );
+            file->length = std::clamp( file->size - file->offset, sqlite3_int64{0}, BLOCK );
+            file->valid = 0;
+            file->cached = true;
+        }
+
+        // Setores além do fim do arquivo não têm o que ler
+        mask &= ~file->valid & Vfs::sectors( 0, file->length );
+
+        for ( auto first = 0; first < SECTORS and mask != 0; )
+        {
+            if ( ( mask & ( 1u << first ) ) == 0 )
+            {
+                first += 1;
+                continue;
+            }
+
+            auto last = first;
+            while ( last < SECTORS and ( mask & ( 1u << last ) ) != 0 )
+            {
+                last += 1;
+            }
+
+            const auto start = first * SECTOR;
+            const auto end = std::min( last * SECTOR, file->length );
+            const auto rc = file->real->pMethods->xRead( file->real, file->block.data() + start, end - start, file->offset + start );
+            stats.deviceReads.add( end - start );
+            if ( rc != SQLITE_OK and rc != SQLITE_IOERR_SHORT_READ )
+            {
+                return rc;
+            }
+
+            file->valid |= Vfs::sectors( start, end );
+            mask &= ~Vfs::sectors( start, end );
+            first = last;
+        }
+        return SQLITE_OK;
+    }
+
+    static auto contains( const File* file, sqlite3_int64 offset, sqlite3_int64 amount ) -> bool
+    {
+        if ( not file->cached or offset < file->offset or offset + amount > file->offset + file->length )
+        {
+            return false;
+        }
+
+        const auto mask = Vfs::sectors( offset - file->offset, offset - file->offset + amount );
+        return ( file->valid & mask ) == mask;
+    }
+
+    static auto close( sqlite3_file* base ) -> int
+    {
+        const auto file = reinterpret_cast<File*>( base );
+
+        const auto flushed = Vfs::flush( file );
+        const auto rc = file->real->pMethods->xClose( file->real );
+        return flushed != SQLITE_OK ? flushed : rc;
+    }
+
+    static auto read( sqlite3_file* base, void* data, int amount, sqlite3_int64 offset ) -> int
+    {
+        const auto file = reinterpret_cast<File*>( base );
+        stats.reads.add( amount );
+
+        // Leitura logo após a anterior indica varredura, então o bloco inteiro é carregado
+        const auto sequential = offset == file->lastRead;
+        file->lastRead = offset + amount;
+
+        if ( not Vfs::contains( file, offset, amount ) and sequential and alignDown( offset, BLOCK ) == alignDown( offset + amount - 1, BLOCK ) and offset + amount <= file->size )
+        {
+            const auto rc = Vfs::load( file, offset, 0xffff );
+            if ( rc != SQLITE_OK )
+            {
+                return rc;
+            }
+        }
+
+        if ( Vfs::contains( file, offset, amount ) )
+        {
+            std::memcpy( data, file->block.data() + ( offset - file->offset ), amount );
+            stats.hits.add( amount );
+            return SQLITE_OK;
+        }
+
+        const auto rc = Vfs::flush( file );
+        if ( rc != SQLITE_OK )
+        {
+            return rc;
+        }
+
+        stats.deviceReads.add( amount );
+        return file->real->pMethods->xRead( file->real, data, amount, offset );
+    }
+
+    static auto write( sqlite3_file* base, const void* data, int amount, sqlite3_int64 offset ) -> int
+    {
+        const auto file = reinterpret_cast<File*>( base );
+        stats.writes.add( amount );
+
+        auto source = static_cast<const uint8_t*>( data );
+        auto remaining = sqlite3_int64{amount};
+
+        // Cada pedaço vai para o bloco alinhado que o contém
+        while ( remaining > 0 )
+        {
+            const auto start = alignDown( offset, BLOCK );
+            const auto piece = std::min( remaining, start + BLOCK - offset );
+
+            const auto position = offset - start;
+
+            // Só os setores cobertos pela metade precisam ser lidos antes
+            const auto touched = Vfs::sectors( position, position + piece );
+            const auto edges = ( position % SECTOR != 0 ? Vfs::sectors( position, position + 1 ) : 0 ) | ( ( position + piece ) % SECTOR != 0 ? Vfs::sectors( position + piece - 1, position + piece ) : 0 );
+            const auto rc = Vfs::load( file, offset, edges );
+            if ( rc != SQLITE_OK )
+            {
+                return rc;
+            }
+
+            // Buraco antes do trecho vira zeros, como num arquivo comum
+            if ( position > file->length )
+            {
+                std::memset( file->block.data() + file->length, 0, position - file->length );
+            }
+            std::memcpy( file->block.data() + position, source, piece );
+            file->length = std::max( file->length, position + piece );
+            file->valid |= touched;
+            file->dirty |= touched;
+            file->size = std::max( file->size, offset + piece );
+
+            source += piece;
+            offset += piece;
+            remaining -= piece;
+        }
+        return SQLITE_OK;
+    }
+
+    static auto truncate( sqlite3_file* base, sqlite3_int64 size ) -> int
+    {
+        const auto file = reinterpret_cast<File*>( base );
+        stats.truncates.add( 0 );
+
+        const auto rc = Vfs::flush( file );
+        if ( rc != SQLITE_OK )
+        {
+            return rc;
+        }
+
+        file->cached = false;
+        file->size = size;
+        return file->real->pMethods->xTruncate( file->real, size );
+    }
+
+    static auto sync( sqlite3_file* base, int flags ) -> int
+    {
+        const auto file = reinterpret_cast<File*>( base );
+        stats.syncs.add( 0 );
+
+        const auto rc = Vfs::flush( file );
+        if ( rc != SQLITE_OK )
+        {
+            return rc;
+        }
+        return file->real->pMethods->xSync( file->real, flags );
+    }
+
+    static auto fileSize( sqlite3_file* base, sqlite3_int64* size ) -> int
+    {
+        *size = reinterpret_cast<File*>( base )->size;
+        return SQLITE_OK;
+    }
+
+    static auto lock( sqlite3_file* base, int level ) -> int
+    {
+        const auto file = reinterpret_cast<File*>( base );
+        return file->real->pMethods->xLock( file->real, level );
+    }
+
+    static auto unlock( sqlite3_file* base, int level ) -> int
+    {
+        const auto file = reinterpret_cast<File*>( base );
+        return file->real->pMethods->xUnlock( file->real, level );
+    }
+
+    static auto checkReservedLock( sqlite3_file* base, int* result ) -> int
+    {
+        const auto file = reinterpret_cast<File*>( base );
+        return file->real->pMethods->xCheckReservedLock( file->real, result );
+    }
+
+    static auto fileControl( sqlite3_file* base, int op, void* arg ) -> int
+    {
+        const auto file = reinterpret_cast<File*>( base );
+        return file->real->pMethods->xFileControl( file->real, op, arg );
+    }
+
+    static auto sectorSize( sqlite3_file* ) -> int
+    {
+        return SECTOR;
+    }
+
+    static auto deviceCharacteristics( sqlite3_file* base ) -> int
+    {
+        const auto file = reinterpret_cast<File*>( base );
+        return file->real->pMethods->xDeviceCharacteristics( file->real );
+    }
+
+    static const sqlite3_io_methods methods = {
+        .iVersion = 1,
+        .xClose = Vfs::close,
+        .xRead = Vfs::read,
+        .xWrite = Vfs::write,
+        .xTruncate = Vfs::truncate,
+        .xSync = Vfs::sync,
+        .xFileSize = Vfs::fileSize,
+        .xLock = Vfs::lock,
+        .xUnlock = Vfs::unlock,
+        .xCheckReservedLock = Vfs::checkReservedLock,
+        .xFileControl = Vfs::fileControl,
+        .xSectorSize = Vfs::sectorSize,
+        .xDeviceCharacteristics = Vfs::deviceCharacteristics,
+    };
+
+    static auto open( sqlite3_vfs*, const char* name, sqlite3_file* base, int flags, int* outFlags ) -> int
+    {
+        const auto file = reinterpret_cast<File*>( base );
+        file->base.pMethods = nullptr;
+        file->real = reinterpret_cast<sqlite3_file*>( reinterpret_cast<uint8_t*>( base ) + sizeof( File ) );
+
+        const auto rc = parent->xOpen( parent, name, file->real, flags, outFlags );
+        if ( rc != SQLITE_OK )
+        {
+            return rc;
+        }
+
+        file->size = 0;
+        if ( file->real->pMethods->xFileSize( file->real, &file->size ) != SQLITE_OK )
+        {
+            file->size = 0;
+        }
+        file->offset = 0;
+        file->length = 0;
+        file->valid = 0;
+        file->dirty = 0;
+        file->lastRead = -1;
+        file->cached = false;
+        file->base.pMethods = &methods;
+        return SQLITE_OK;
+    }
+
+    auto init() -> void
+    {
+        log_d( "begin" );
+
+        if ( parent != nullptr )
+        {
+            log_d( "already registered" );
+            return;
+        }
+
+        parent = sqlite3_vfs_find( nullptr );
+
+        // Os demais métodos do VFS padrão servem como estão
+        vfs = *parent;
+        vfs.szOsFile = sizeof( File ) + parent->szOsFile;
+        vfs.zName = NAME;
+        vfs.pNext = nullptr;
+        vfs.xOpen = Vfs::open;
+
+        const auto rc = sqlite3_vfs_register( &vfs, 0 );
+        if ( rc != SQLITE_OK )
+        {
+            log_e( "vfs register error: %d", rc );
+        }
+
+        log_d( "end" );
+    }
+
+    auto reset() -> void
+    {
+        for ( auto counter : { &stats.reads, &stats.writes, &stats.hits, &stats.deviceReads, &stats.deviceWrites, &stats.syncs, &stats.truncates } )
+        {
+            counter->count = 0;
+            counter->bytes = 0;
+        }
+    }
+
+    auto serialize( ArduinoJson::JsonVariant& json ) -> void
+    {
+        const auto fields = std::array<std::pair<const char*, const Counter*>, 7>{{
+            { "reads", &stats.reads },
+            { "writes", &stats.writes },
+            { "cache_hits", &stats.hits },
+            { "device_reads", &stats.deviceReads },
+            { "device_writes", &stats.deviceWrites },
+            { "syncs", &stats.syncs },
+            { "truncates", &stats.truncates },
+        }};
+
+        for ( const auto& [name, counter] : fields )
+        {
+            json[name]["count"] = counter->count.load();
+            json[name]["bytes"] = counter->bytes.load();
+        }
+    }
+} // namespace Vfs
\ No newline at end of file
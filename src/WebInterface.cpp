@@ -12,13 +12,25 @@
 #include <esp_log.h>
 #include <functional>
 #include <memory>
+#include <new>
 #include <Update.h>
+#include <esp_ota_ops.h>
+#include <esp_partition.h>
 #include <esp_task_wdt.h>
 #include <rom/rtc.h>
 #include <future>
-
+#include <atomic>
+#include <tuple>
+#include <algorithm>
+#include <array>
+#include <mutex>
+
+#include "Boot.hpp"
+#include "Classifier.hpp"
 #include "Configuration.hpp"
 #include "Database.hpp"
+#include "Delta.hpp"
+#include "Gzip.hpp"
 #include "Peripherals.hpp"
 #include "RealTime.hpp"
 #include "WebInterface.hpp"
@@ -26,18 +38,53 @@
 #include "Infos.hpp"
 #include "Files.hpp"
 #include "Indicator.hpp"
+#include "Link.hpp"
+#include "Metrics.hpp"
+#include "Pool.hpp"
+#include "Uplink.hpp"
+#include "Vfs.hpp"
+
+// Tamanho dos pools de pedidos, a memória só é reservada no primeiro pedido de cada tipo
+#ifndef WEB_ARENAS
+#define WEB_ARENAS 2
+#endif
+
+#ifndef WEB_ARENA_SIZE
+#define WEB_ARENA_SIZE 6144
+#endif
+
+#ifndef WEB_FILTERS
+#define WEB_FILTERS 4
+#endif
+
+// Cada fluxo custa o que diz o GZIP_WINDOW_BITS
+#ifndef WEB_DEFLATERS
+#define WEB_DEFLATERS 1
+#endif
 
 namespace WebInterface
 {
     static std::unique_ptr<AsyncWebServer> _server = {};
+    static uint16_t _port = 0;
     static std::chrono::system_clock::time_point _modeTimer = {};
-    static std::chrono::system_clock::time_point _reconnectTimer = {};
     static std::chrono::system_clock::time_point _sensorsSendTimer = {};
     static std::chrono::system_clock::time_point _wsCleanupTimer = {};
     static std::future<void> _futuroReinicio = {};
 
     static AsyncWebSocket _sensorsWs("/sensors.ws");
 
+    // Clientes do WebSocket: entram e saem na tarefa do async_tcp, o loop envia a cada um
+    static constexpr auto WS_CLIENTS = 8u;
+    static std::mutex _wsMutex = {};
+    static std::array<uint32_t, WS_CLIENTS> _wsClients = {};
+    static std::size_t _wsCount = 0;
+
+    // Objetos dos pedidos vêm de pools fixos, sem espaço a resposta é 503
+    using Arena = Pool::Arena<WEB_ARENA_SIZE>;
+    static Pool::Fixed<Arena, WEB_ARENAS> _arenas{"arenas"};
+    static Pool::Fixed<Database::Filter, WEB_FILTERS> _filters{"filters"};
+    static Pool::Fixed<Gzip::Deflater, WEB_DEFLATERS> _deflaters{"deflaters"};
+
     static auto reinicia() -> void {
         _futuroReinicio = std::async(std::launch::async, []
         {
@@ -46,48 +93,205 @@ namespace WebInterface
         });
     }
 
+    // Pedidos do servidor web, atendidos no loop: Classifier e rede não são refeitos na tarefa do async_tcp
+    static std::shared_ptr<const Configuration> _pending = {};
+    static std::atomic<bool> _reload = false;
+    static std::atomic<bool> _reconfigure = false;
+
+    static auto stationChanged( const Configuration& previous, const Configuration& next ) -> bool
+    {
+        const auto station = []( const Configuration& c )
+        {
+            return std::tie( c.station.enabled, c.station.ip, c.station.netmask, c.station.gateway, c.station.port, c.station.user, c.station.password );
+        };
+        return station( previous ) != station( next );
+    }
+
+    static auto accessPointChanged( const Configuration& previous, const Configuration& next ) -> bool
+    {
+        const auto accessPoint = []( const Configuration& c )
+        {
+            return std::tie( c.accessPoint.enabled, c.accessPoint.ip, c.accessPoint.netmask, c.accessPoint.gateway, c.accessPoint.port, c.accessPoint.user, c.accessPoint.password );
+        };
+        return accessPoint( previous ) != accessPoint( next );
+    }
+
+    static auto networkChanged( const Configuration& previous, const Configuration& next ) -> bool
+    {
+        return WebInterface::stationChanged( previous, next ) or WebInterface::accessPointChanged( previous, next );
+    }
+
+    static auto sourceChanged( const Configuration& previous, const Configuration& next ) -> bool
+    {
+        return previous.source.type != next.source.type or previous.source.file != next.source.file;
+    }
+
+    // Só agenda a troca, o checkReconfigure publica no loop sem reiniciar e refaz a rede quando muda
+    static auto apply( const Configuration& previous, const Configuration& next ) -> std::string
+    {
+        std::atomic_store( &_pending, std::make_shared<const Configuration>( next ) );
+        _reconfigure = true;
+
+        if ( WebInterface::sourceChanged( previous, next ) )
+        {
+            return "Configuration saved, rebooting";
+        }
+
+        if ( WebInterface::networkChanged( previous, next ) )
+        {
+            return "Configuration applied, reconnecting";
+        }
+
+        return "Configuration applied";
+    }
+
     namespace Get
     {
+        // Documento e texto ficam na arena, que vive até a resposta ser enviada
         static auto handleConfigurationJson( AsyncWebServerRequest* request ) -> void
         {
-            auto response{new AsyncJsonResponse{false, 2048}};
+            auto arena{_arenas.acquire()};
+            if ( not arena )
+            {
+                request->send( 503, "text/plain", "busy" );
+                return;
+            }
+
+            auto doc{ArduinoJson::BasicJsonDocument<Pool::Allocator<Arena>>{3072, Pool::Allocator<Arena>{arena.get()}}};
+            auto responseJson{doc.to<ArduinoJson::JsonVariant>()};
+            if ( doc.capacity() == 0 )
+            {
+                request->send( 503, "text/plain", "busy" );
+                return;
+            }
+
+            const auto current{cfg.get()};
+            current->serialize( responseJson );
+
+            const auto length{ArduinoJson::measureJson( doc )};
+            const auto text{static_cast<char*>( arena->allocate( length + 1 ) )};
+            if ( text == nullptr )
+            {
+                request->send( 503, "text/plain", "busy" );
+                return;
+            }
+            ArduinoJson::serializeJson( doc, text, length + 1 );
+
+            request->send( request->beginResponse( "application/json", length, [arena, text, length]( uint8_t* buffer, size_t maxLen, size_t index ) -> size_t
+            {
+                const auto chunk{std::min( maxLen, length - index )};
+                memcpy( buffer, text + index, chunk );
+                return chunk;
+            }));
+        }
+
+        static auto handleMetricsJson( AsyncWebServerRequest* request ) -> void
+        {
+            auto response{new AsyncJsonResponse{false, 3072}};
             auto& responseJson{response->getRoot()};
 
-            cfg.serialize( responseJson );
+            Metrics::serialize( responseJson );
 
             response->setLength();
             request->send( response );
         }
 
-        static auto handleDateTimeJson( AsyncWebServerRequest* request ) -> void
+        static auto handleBootJson( AsyncWebServerRequest* request ) -> void
         {
-            auto response{new AsyncJsonResponse{}};
+            auto response{new AsyncJsonResponse{true, 2048}};
             auto& responseJson{response->getRoot()};
 
-            responseJson.set( Utils::DateTime::toString( std::chrono::system_clock::now() ) );
+            Boot::serialize( responseJson );
 
             response->setLength();
             request->send( response );
         }
 
-        static auto handleConfigurationHtml( AsyncWebServerRequest* request ) -> void
+        static auto handleBackupJson( AsyncWebServerRequest* request ) -> void
         {
-            request->send_P( 200, "text/html", configuration_html_start, static_cast<size_t>( configuration_html_end - configuration_html_start ) );
+            auto response{new AsyncJsonResponse{false, 512}};
+            auto& responseJson{response->getRoot()};
+
+            Database::Backup::serialize( responseJson );
+
+            response->setLength();
+            request->send( response );
         }
 
-        static auto handleConfigurationJs( AsyncWebServerRequest* request ) -> void
+        // Espera a cópia terminar com a conexão aberta e então envia o arquivo
+        static auto handleDatabaseSqlite( AsyncWebServerRequest* request ) -> void
         {
-            request->send_P( 200, "application/javascript", configuration_js_start, static_cast<size_t>( configuration_js_end - configuration_js_start ) );
+            Database::Backup::request();
+
+            auto response = request->beginChunkedResponse( "application/vnd.sqlite3", [file = std::shared_ptr<FILE>{}]( uint8_t* buffer, size_t maxLen, size_t index ) mutable -> size_t 
+            {
+                if ( not file )
+                {
+                    switch ( Database::Backup::state() )
+                    {
+                        case Database::Backup::State::PENDING:
+                        case Database::Backup::State::RUNNING:
+                            return RESPONSE_TRY_AGAIN;
+                        case Database::Backup::State::DONE:
+                            file = Database::Backup::open();
+                            break;
+                        default:
+                            break;
+                    }
+                    if ( not file )
+                    {
+                        log_e( "backup unavailable" );
+                        return 0;
+                    }
+                }
+
+                return std::fread( buffer, 1, maxLen, file.get() );
+            });
+
+            response->addHeader( "Content-Disposition", "attachment;filename=sensors_data.db" );
+            request->send( response );
         }
 
-        static auto handleDataHtml( AsyncWebServerRequest* request ) -> void
+        static auto handleVfsJson( AsyncWebServerRequest* request ) -> void
         {
-            request->send_P( 200, "text/html", data_html_start, static_cast<size_t>( data_html_end - data_html_start ) );
+            auto response{new AsyncJsonResponse{false, 1024}};
+            auto& responseJson{response->getRoot()};
+
+            Vfs::serialize( responseJson );
+
+            response->setLength();
+            request->send( response );
         }
 
-        static auto handleDataJs( AsyncWebServerRequest* request ) -> void
+        static auto handleUplinkJson( AsyncWebServerRequest* request ) -> void
         {
-            request->send_P( 200, "application/javascript", data_js_start, static_cast<size_t>( data_js_end - data_js_start ) );
+            auto response{new AsyncJsonResponse{false, 512}};
+            auto& responseJson{response->getRoot()};
+
+            Uplink::serialize( responseJson );
+
+            response->setLength();
+            request->send( response );
+        }
+
+        static auto handleWifiJson( AsyncWebServerRequest* request ) -> void
+        {
+            auto response{new AsyncJsonResponse{false, 512}};
+            auto& responseJson{response->getRoot()};
+
+            Link::serialize( responseJson );
+
+            response->setLength();
+            request->send( response );
+        }
+
+        static auto handleDateTimeJson( AsyncWebServerRequest* request ) -> void
+        {
+            auto text{Utils::DateTime::Text{}};
+            auto quoted{std::array<char, 24>{}};
+
+            snprintf( quoted.data(), quoted.size(), "\"%s\"", Utils::DateTime::toString( std::chrono::system_clock::now(), text ) );
+            request->send( 200, "application/json", quoted.data() );
         }
 
         class comma_punct : public std::numpunct<char>
@@ -100,12 +304,67 @@ namespace WebInterface
         };
         std::locale loc{ std::locale{}, new comma_punct };
 
+        static constexpr auto CSV_HEADER = Infos::SensorData::HEADER;
+
+        // Linhas entram no compressor até a saída preencher o chunk inteiro
+        static auto handleDataCsvGzip( AsyncWebServerRequest* request, Pool::Ptr<Database::Filter> filter, Pool::Ptr<Gzip::Deflater> deflater ) -> void
+        {
+            deflater->write( reinterpret_cast<const uint8_t*>( CSV_HEADER ), strlen( CSV_HEADER ) );
+
+            auto response = request->beginChunkedResponse( "text/csv", [=]( uint8_t* buffer, size_t maxLen, size_t index ) -> size_t 
+            {
+                auto len = 0u;
+                auto rowBuf = std::array<char, 100u>{};
+
+                while ( true )
+                {
+                    len += deflater->read( buffer + len, maxLen - len );
+                    if ( len == maxLen or deflater->done() )
+                    {
+                        return len;
+                    }
+
+                    const auto sensorData = filter->next();
+                    if ( not sensorData.has_value() )
+                    {
+                        deflater->finish();
+                        continue;
+                    }
+
+                    const auto written = sensorData->serialize( rowBuf );
+                    deflater->write( reinterpret_cast<const uint8_t*>( rowBuf.data() ), written );
+                }
+            });
+
+            response->addHeader( "Content-Encoding", "gzip" );
+            response->addHeader( "Vary", "Accept-Encoding" );
+            response->addHeader( "Content-Disposition", "attachment;filename=data.csv" );
+            request->send( response );
+        }
+
         static auto handleDataCsv( AsyncWebServerRequest* request ) -> void
         {
             const auto start = Utils::DateTime::fromString( request->getParam( "start" )->value().c_str() );
             const auto end = Utils::DateTime::fromString( request->getParam( "end" )->value().c_str() );
+            const auto resolution = request->hasParam( "resolution" ) and request->getParam( "resolution" )->value() == "raw" ? Database::Resolution::RAW : Database::Resolution::AGGREGATE;
 
-            auto filter = std::make_shared<Database::Filter>(start, end, 10000);
+            auto filter = _filters.acquire(start, end, 10000, resolution);
+            if ( not filter )
+            {
+                request->send( 503, "text/plain", "busy" );
+                return;
+            }
+
+            // Sem compressor livre a exportação segue sem compressão
+            if ( request->hasHeader( "Accept-Encoding" ) and request->getHeader( "Accept-Encoding" )->value().indexOf( "gzip" ) >= 0 )
+            {
+                auto deflater = _deflaters.acquire();
+                if ( deflater )
+                {
+                    handleDataCsvGzip( request, filter, deflater );
+                    return;
+                }
+            }
 
             auto response = request->beginChunkedResponse( "text/csv", [=]( uint8_t* buffer, size_t maxLen, size_t index ) -> size_t 
             {
@@ -114,8 +373,8 @@ namespace WebInterface
 
                 if(index == 0 and len == 0)
                 {
-                    memcpy(buffer, "datahora;temp;umid;pressao;vento;direcao;chuva\r\n", 48);
-                    len += 48;
+                    memcpy(buffer, CSV_HEADER, strlen(CSV_HEADER));
+                    len += strlen(CSV_HEADER);
                 }
 
                 while(len + rowBuf.size() <= maxLen)
@@ -138,48 +397,53 @@ namespace WebInterface
             request->send( response );
         }
 
-        static auto handleJqueryMinJs( AsyncWebServerRequest* request ) -> void
+        static auto handleAsset( AsyncWebServerRequest* request, const Files::Asset& asset ) -> void
         {
-            auto response = request->beginResponse_P(200, "application/javascript", jquery_min_js_gz_start, static_cast<size_t>(jquery_min_js_gz_end - jquery_min_js_gz_start));
-            response->addHeader("Content-Encoding", "gzip");
-            request->send(response);
+            auto response{request->beginResponse_P( 200, asset.type, asset.start, static_cast<size_t>( asset.end - asset.start ) )};
+            response->addHeader( "Content-Encoding", "gzip" );
+            request->send( response );
         }
 
-        static auto handleChartMinJs(AsyncWebServerRequest *request) -> void
+    } // namespace Get
+
+    namespace File 
+    {
+        // Imagem gzip é descompressa durante o envio, só a janela de 32 KiB fica em memória
+        static std::unique_ptr<Gzip::Inflater> inflater = {};
+        // Patch refaz a imagem nova lendo a partição em execução
+        static std::unique_ptr<Delta::Patcher> patcher = {};
+
+        static auto flash( const uint8_t* data, std::size_t length ) -> bool
         {
-            auto response{request->beginResponse_P(200, "application/javascript", chart_min_js_gz_start, static_cast<size_t>(chart_min_js_gz_end - chart_min_js_gz_start))};
-            response->addHeader("Content-Encoding", "gzip");
-            request->send(response);
+            return Update.write( const_cast<uint8_t*>( data ), length ) == length;
         }
 
-        static auto handleInfosHtml( AsyncWebServerRequest* request ) -> void
+        static auto running( uint32_t offset, uint8_t* data, std::size_t length ) -> bool
         {
-            request->send_P( 200, "text/html", infos_html_start, static_cast<size_t>( infos_html_end - infos_html_start ) );
+            return esp_partition_read( esp_ota_get_running_partition(), offset, data, length ) == ESP_OK;
         }
 
-        static auto handleInfosJs( AsyncWebServerRequest* request ) -> void
+        static auto unpack( const uint8_t* data, std::size_t length ) -> bool
         {
-            request->send_P( 200, "application/javascript", infos_js_start, static_cast<size_t>( infos_js_end - infos_js_start ) );
+            return patcher ? patcher->write( data, length ) : File::flash( data, length );
         }
 
-        static auto handleStyleCss( AsyncWebServerRequest* request ) -> void
+        static auto release() -> void
         {
-            request->send_P( 200, "text/css", style_css_start, static_cast<size_t>( style_css_end - style_css_start ) );
+            inflater.reset();
+            patcher.reset();
         }
 
-    } // namespace Get
-
-    namespace File 
-    {
         auto handleFirmwareBin(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) -> void
         {
             if (index == 0)
             {
                 log_d("POST /firmware.bin");
 
-                if (not filename.endsWith(".bin"))
+                const auto patch = filename.endsWith(".patch") or filename.endsWith(".patch.gz");
+                if (not filename.endsWith(".bin") and not filename.endsWith(".bin.gz") and not patch)
                 {
-                    request->send(400, "text/plain", "File extension must be .bin");
+                    request->send(400, "text/plain", "File extension must be .bin, .bin.gz, .patch or .patch.gz");
                     return;
                 }
 
@@ -195,21 +459,71 @@ namespace WebInterface
                     return;
                 }
 
-                if (not Update.begin(request->contentLength()))
+                const auto compressed = len >= 2 and data[0] == 0x1f and data[1] == 0x8b;
+                File::release();
+                if (compressed)
+                {
+                    inflater.reset( new (std::nothrow) Gzip::Inflater{File::unpack} );
+                }
+                if (patch)
                 {
+                    auto digest = Delta::Digest{};
+                    if (esp_partition_get_sha256(esp_ota_get_running_partition(), digest.data()) != ESP_OK)
+                    {
+                        request->send(500, "text/plain", "Running firmware digest unavailable");
+                        return;
+                    }
+                    patcher.reset( new (std::nothrow) Delta::Patcher{digest, File::running, File::flash} );
+                }
+                if ((compressed and not inflater) or (patch and not patcher))
+                {
+                    File::release();
+                    request->send(500, "text/plain", "Out of memory");
+                    return;
+                }
+
+                // O tamanho final só aparece no fim do gzip ou no cabeçalho do patch
+                if (not Update.begin(compressed or patch ? UPDATE_SIZE_UNKNOWN : request->contentLength()))
+                {
+                    File::release();
                     request->send(500, "text/plain", Update.errorString());
                     return;
                 }
+
+                // Digest opcional da imagem final, conferido pelo Update.end
+                if (request->hasHeader("X-Firmware-MD5") and not Update.setMD5(request->header("X-Firmware-MD5").c_str()))
+                {
+                    Update.abort();
+                    File::release();
+                    request->send(400, "text/plain", "Invalid MD5");
+                    return;
+                }
             }
 
-            if (Update.write(data, len) != len)
+            const auto written = inflater ? inflater->write(data, len) : File::unpack(data, len);
+            if (not written)
             {
-                request->send(500, "text/plain", Update.errorString());
+                const auto reason = patcher ? patcher->error() : inflater ? "Corrupt compressed image" : Update.errorString();
+                const auto code = patcher or inflater ? 400 : 500;
+                Update.abort();
+                File::release();
+                request->send(code, "text/plain", reason);
                 return;
             }
 
             if (final)
             {
+                const auto inflated = not inflater or inflater->done();
+                const auto patched = not patcher or patcher->done();
+                const auto reason = not inflated ? "Truncated compressed image" : patcher ? patcher->error() : "";
+                log_d("written = %u", patcher ? patcher->written() : inflater ? inflater->decompressed() : index + len);
+                File::release();
+                if (not inflated or not patched)
+                {
+                    Update.abort();
+                    request->send(400, "text/plain", reason);
+                    return;
+                }
                 if (not Update.end(true))
                 {
                     request->send(500, "text/plain", Update.errorString());
@@ -267,9 +581,11 @@ namespace WebInterface
             {
                 file.close();
 
-                request->send(200, "text/plain", "Success, rebooting");
-                
-                WebInterface::reinicia();
+                // Importado no loop, junto com a publicação
+                _reload = true;
+                _reconfigure = true;
+
+                request->send(200, "text/plain", "Configuration uploaded, applying");
             }
         }
     }
@@ -290,15 +606,20 @@ namespace WebInterface
             auto response{new AsyncJsonResponse{}};
             auto& responseJson{response->getRoot()};
 
-            auto newCfg{cfg};
+            const auto previous = cfg.get();
+            auto newCfg{*previous};
             newCfg.deserialize( requestJson );
             Configuration::save( newCfg );
 
-            responseJson.set( "Configuration saved, rebooting" );
+            auto message{WebInterface::apply( *previous, newCfg )};
+            for ( const auto& warning : Classifier::validate( newCfg ) )
+            {
+                message += "; " + warning;
+            }
+
+            responseJson.set( message );
             response->setLength();
             request->send( response );
-
-            WebInterface::reinicia();
         }
 
         static auto handleDateTimeJson( AsyncWebServerRequest* request, JsonVariant& requestJson ) -> void
@@ -311,11 +632,9 @@ namespace WebInterface
             const auto dateTime{Utils::DateTime::fromString( requestJson.as<std::string>() )};
             RealTime::adjustDateTime( dateTime );
 
-            responseJson.set( "DateTime saved, rebooting" );
+            responseJson.set( "DateTime saved" );
             response->setLength();
             request->send( response );
-
-            WebInterface::reinicia();
         }
 
         auto handleFile(AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final) -> void
@@ -343,10 +662,28 @@ namespace WebInterface
             {
                 log_d("WS %s (%u) connect", server->url(), client->id());
                 client->ping();
+
+                const auto lock = std::lock_guard<std::mutex>{_wsMutex};
+                if (_wsCount < _wsClients.size())
+                {
+                    _wsClients[_wsCount++] = client->id();
+                }
+                else
+                {
+                    log_w("WS %s (%u) not tracked, too many clients", server->url(), client->id());
+                }
             }
             else if (type == WS_EVT_DISCONNECT)
             {
                 log_d("WS %s (%u) disconnect", server->url(), client->id());
+
+                const auto lock = std::lock_guard<std::mutex>{_wsMutex};
+                const auto end = _wsClients.begin() + _wsCount;
+                const auto found = std::find(_wsClients.begin(), end, client->id());
+                if (found != end)
+                {
+                    *found = _wsClients[--_wsCount];
+                }
             }
             else if (type == WS_EVT_ERROR)
             {
@@ -363,38 +700,85 @@ namespace WebInterface
         }
     }
 
+    // Marca só a primeira resposta, as seguintes não pagam o mutex e a busca do Boot
+    static std::atomic<bool> _responded = {false};
+
+    static auto tracked( const char* name, ArRequestHandlerFunction handler ) -> ArRequestHandlerFunction
+    {
+        const auto route = Metrics::route( name );
+        return [route, handler]( AsyncWebServerRequest* request )
+        {
+            if ( not _responded.load( std::memory_order_relaxed ) and not _responded.exchange( true ) )
+            {
+                Boot::mark( "first response" );
+            }
+            Metrics::track( route, request );
+            handler( request );
+        };
+    }
+
+    static auto tracked( const char* name, ArJsonRequestHandlerFunction handler ) -> ArJsonRequestHandlerFunction
+    {
+        const auto route = Metrics::route( name );
+        return [route, handler]( AsyncWebServerRequest* request, JsonVariant& json )
+        {
+            Metrics::track( route, request );
+            handler( request, json );
+        };
+    }
+
     static auto configureServer() -> void
     {
-        _server.release();
+        const auto port = WiFi.getMode() == WIFI_MODE_AP ? cfg->accessPoint.port : cfg->station.port;
+
+        // Troca de rede na mesma porta mantém o servidor e os clientes conectados
+        if ( _server and port == _port )
+        {
+            return;
+        }
+
+        if ( _server )
+        {
+            _server->end();
+        }
+
+        _server.reset();
+        _port = port;
 
         if ( WiFi.getMode() == WIFI_MODE_STA )
         {
-            _server.reset( new AsyncWebServer{cfg.station.port} );
+            _server.reset( new AsyncWebServer{cfg->station.port} );
         }
         else if ( WiFi.getMode() == WIFI_MODE_AP )
         {
-            _server.reset( new AsyncWebServer{cfg.accessPoint.port} );
+            _server.reset( new AsyncWebServer{cfg->accessPoint.port} );
         }
 
         if ( _server )
         {
-            _server->on( "/", HTTP_GET, Get::handleInfosHtml );
-            _server->on( "/configuration.json", HTTP_GET, Get::handleConfigurationJson );
-            _server->on( "/datetime.json", HTTP_GET, Get::handleDateTimeJson );
-            _server->on( "/configuration.html", HTTP_GET, Get::handleConfigurationHtml );
-            _server->on( "/configuration.js", HTTP_GET, Get::handleConfigurationJs );
-            _server->on( "/data.html", HTTP_GET, Get::handleDataHtml );
-            _server->on( "/data.js", HTTP_GET, Get::handleDataJs );
-            _server->on( "/data.csv", HTTP_GET, Get::handleDataCsv );
-            _server->on( "/jquery.min.js", HTTP_GET, Get::handleJqueryMinJs);
-            _server->on( "/chart.min.js", HTTP_GET, Get::handleChartMinJs);
-            _server->on( "/infos.html", HTTP_GET, Get::handleInfosHtml );
-            _server->on( "/infos.js", HTTP_GET, Get::handleInfosJs );
-            _server->on( "/style.css", HTTP_GET, Get::handleStyleCss );
+            // Páginas e bibliotecas vêm da tabela gerada por tools/assets.py
+            for ( const auto& asset : Files::ASSETS )
+            {
+                _server->on( asset.path, HTTP_GET, tracked( asset.route, [&asset]( AsyncWebServerRequest* request )
+                {
+                    Get::handleAsset( request, asset );
+                } ) );
+            }
+
+            _server->on( "/configuration.json", HTTP_GET, tracked( "GET /configuration.json", Get::handleConfigurationJson ) );
+            _server->on( "/datetime.json", HTTP_GET, tracked( "GET /datetime.json", Get::handleDateTimeJson ) );
+            _server->on( "/metrics.json", HTTP_GET, Get::handleMetricsJson );
+            _server->on( "/boot.json", HTTP_GET, tracked( "GET /boot.json", Get::handleBootJson ) );
+            _server->on( "/data.csv", HTTP_GET, tracked( "GET /data.csv", Get::handleDataCsv ) );
+            _server->on( "/database.sqlite", HTTP_GET, tracked( "GET /database.sqlite", Get::handleDatabaseSqlite ) );
+            _server->on( "/backup.json", HTTP_GET, tracked( "GET /backup.json", Get::handleBackupJson ) );
+            _server->on( "/vfs.json", HTTP_GET, tracked( "GET /vfs.json", Get::handleVfsJson ) );
+            _server->on( "/uplink.json", HTTP_GET, tracked( "GET /uplink.json", Get::handleUplinkJson ) );
+            _server->on( "/wifi.json", HTTP_GET, tracked( "GET /wifi.json", Get::handleWifiJson ) );
 
             _server->on( "/firmware.bin", HTTP_POST, Post::handleFirmwareBin, File::handleFirmwareBin );
-            _server->on( "/configuration.json", HTTP_POST, Post::handleConfigurationJson );
-            _server->on( "/datetime.json", HTTP_POST, Post::handleDateTimeJson );
+            _server->on( "/configuration.json", HTTP_POST, tracked( "POST /configuration.json", Post::handleConfigurationJson ) );
+            _server->on( "/datetime.json", HTTP_POST, tracked( "POST /datetime.json", Post::handleDateTimeJson ) );
 
             _sensorsWs.onEvent(WebSocket::handleDefaultWs);
             _server->addHandler(&_sensorsWs);
@@ -422,17 +806,18 @@ namespace WebInterface
     {
         log_d( "begin" );
 
-        log_d( "enabled = %u", cfg.station.enabled );
-        log_d( "mac = %02X-%02X-%02X-%02X-%02X-%02X", cfg.station.mac[0], cfg.station.mac[1], cfg.station.mac[2], cfg.station.mac[3], cfg.station.mac[4], cfg.station.mac[5] );
-        log_d( "ip = %u.%u.%u.%u", cfg.station.ip[0], cfg.station.ip[1], cfg.station.ip[2], cfg.station.ip[3] );
-        log_d( "netmask = %u.%u.%u.%u", cfg.station.netmask[0], cfg.station.netmask[1], cfg.station.netmask[2], cfg.station.netmask[3] );
-        log_d( "gateway = %u.%u.%u.%u", cfg.station.gateway[0], cfg.station.gateway[1], cfg.station.gateway[2], cfg.station.gateway[3] );
-        log_d( "port = %u", cfg.station.port );
-        log_d( "user = %s", cfg.station.user.data() );
-        log_d( "password = %s", cfg.station.password.data() );
+        log_d( "enabled = %u", cfg->station.enabled );
+        log_d( "mac = %02X-%02X-%02X-%02X-%02X-%02X", cfg->station.mac[0], cfg->station.mac[1], cfg->station.mac[2], cfg->station.mac[3], cfg->station.mac[4], cfg->station.mac[5] );
+        log_d( "ip = %u.%u.%u.%u", cfg->station.ip[0], cfg->station.ip[1], cfg->station.ip[2], cfg->station.ip[3] );
+        log_d( "netmask = %u.%u.%u.%u", cfg->station.netmask[0], cfg->station.netmask[1], cfg->station.netmask[2], cfg->station.netmask[3] );
+        log_d( "gateway = %u.%u.%u.%u", cfg->station.gateway[0], cfg->station.gateway[1], cfg->station.gateway[2], cfg->station.gateway[3] );
+        log_d( "port = %u", cfg->station.port );
+        log_d( "user = %s", cfg->station.user.data() );
+        log_d( "password = %s", cfg->station.password.data() );
 
-        if ( not cfg.station.enabled )
+        if ( not cfg->station.enabled )
         {
+            Link::stop();
             WiFi.mode( WIFI_MODE_NULL );
             return false;
         }
@@ -447,7 +832,7 @@ namespace WebInterface
         WiFi.setAutoConnect( false );
         WiFi.setAutoReconnect( false );
 
-        if ( not WiFi.config( cfg.station.ip.data(), cfg.station.gateway.data(), cfg.station.netmask.data() ) )
+        if ( not WiFi.config( cfg->station.ip.data(), cfg->station.gateway.data(), cfg->station.netmask.data() ) )
         {
             log_d( "config error" );
             return false;
@@ -455,11 +840,7 @@ namespace WebInterface
 
         WiFi.setHostname( "WeatherCentral" );
 
-        if ( not WiFi.begin( cfg.station.user.data(), cfg.station.password.data() ) )
-        {
-            log_d( "init error" );
-            return false;
-        }
+        Link::start();
 
         configureServer();
         Indicator::fast();
@@ -470,17 +851,19 @@ namespace WebInterface
     {
         log_d( "begin" );
 
-        log_d( "enabled = %u", cfg.accessPoint.enabled );
-        log_d( "mac = %02X-%02X-%02X-%02X-%02X-%02X", cfg.accessPoint.mac[0], cfg.accessPoint.mac[1], cfg.accessPoint.mac[2], cfg.accessPoint.mac[3], cfg.accessPoint.mac[4], cfg.accessPoint.mac[5] );
-        log_d( "ip = %u.%u.%u.%u", cfg.accessPoint.ip[0], cfg.accessPoint.ip[1], cfg.accessPoint.ip[2], cfg.accessPoint.ip[3] );
-        log_d( "netmask = %u.%u.%u.%u", cfg.accessPoint.netmask[0], cfg.accessPoint.netmask[1], cfg.accessPoint.netmask[2], cfg.accessPoint.netmask[3] );
-        log_d( "gateway = %u.%u.%u.%u", cfg.accessPoint.gateway[0], cfg.accessPoint.gateway[1], cfg.accessPoint.gateway[2], cfg.accessPoint.gateway[3] );
-        log_d( "port = %u", cfg.accessPoint.port );
-        log_d( "user = %s", cfg.accessPoint.user.data() );
-        log_d( "password = %s", cfg.accessPoint.password.data() );
-        log_d( "duration = %u", cfg.accessPoint.duration );
+        log_d( "enabled = %u", cfg->accessPoint.enabled );
+        log_d( "mac = %02X-%02X-%02X-%02X-%02X-%02X", cfg->accessPoint.mac[0], cfg->accessPoint.mac[1], cfg->accessPoint.mac[2], cfg->accessPoint.mac[3], cfg->accessPoint.mac[4], cfg->accessPoint.mac[5] );
+        log_d( "ip = %u.%u.%u.%u", cfg->accessPoint.ip[0], cfg->accessPoint.ip[1], cfg->accessPoint.ip[2], cfg->accessPoint.ip[3] );
+        log_d( "netmask = %u.%u.%u.%u", cfg->accessPoint.netmask[0], cfg->accessPoint.netmask[1], cfg->accessPoint.netmask[2], cfg->accessPoint.netmask[3] );
+        log_d( "gateway = %u.%u.%u.%u", cfg->accessPoint.gateway[0], cfg->accessPoint.gateway[1], cfg->accessPoint.gateway[2], cfg->accessPoint.gateway[3] );
+        log_d( "port = %u", cfg->accessPoint.port );
+        log_d( "user = %s", cfg->accessPoint.user.data() );
+        log_d( "password = %s", cfg->accessPoint.password.data() );
+        log_d( "duration = %u", cfg->accessPoint.duration );
+
+        Link::stop();
 
-        if ( not cfg.accessPoint.enabled or rtc_get_reset_reason( 0 ) == DEEPSLEEP_RESET )
+        if ( not cfg->accessPoint.enabled or rtc_get_reset_reason( 0 ) == DEEPSLEEP_RESET )
         {
             WiFi.mode( WIFI_MODE_NULL );
             return false;
@@ -494,7 +877,7 @@ namespace WebInterface
 
         WiFi.persistent( false );
 
-        if ( not WiFi.softAPConfig( cfg.accessPoint.ip.data(), cfg.accessPoint.gateway.data(), cfg.accessPoint.netmask.data() ) )
+        if ( not WiFi.softAPConfig( cfg->accessPoint.ip.data(), cfg->accessPoint.gateway.data(), cfg->accessPoint.netmask.data() ) )
         {
             log_d( "config error" );
             return false;
@@ -502,7 +885,7 @@ namespace WebInterface
 
         WiFi.setHostname( "WeatherCentral" );
 
-        if ( not WiFi.softAP( cfg.accessPoint.user.data(), cfg.accessPoint.password.data() ) )
+        if ( not WiFi.softAP( cfg->accessPoint.user.data(), cfg->accessPoint.password.data() ) )
         {
             log_d( "init error" );
             return false;
@@ -535,22 +918,32 @@ namespace WebInterface
 
             if (_sensorsWs.count() > 0)
             {
-                auto doc{ArduinoJson::DynamicJsonDocument{1024}};
-                auto json{doc.as<ArduinoJson::JsonVariant>()};
+                static auto doc{ArduinoJson::StaticJsonDocument<1024>{}};
+                static auto text{std::array<char, 1024>{}};
+                auto json{doc.to<ArduinoJson::JsonVariant>()};
 
                 const auto sensorData = Infos::SensorData::get();
                 sensorData.serialize(json);
 
-                auto str = String{};
-                ArduinoJson::serializeJson(doc, str);
-                _sensorsWs.textAll(str);
+                // Cliente lento com fila cheia perde a amostra em vez de acumular memória
+                auto clients{std::array<uint32_t, WS_CLIENTS>{}};
+                auto count{std::size_t{0}};
+                {
+                    const auto lock = std::lock_guard<std::mutex>{_wsMutex};
+                    clients = _wsClients;
+                    count = _wsCount;
+                }
+
+                const auto length = ArduinoJson::serializeJson(doc, text.data(), text.size());
+                const auto delivery = broadcast(_sensorsWs, clients.data(), count, text.data(), length);
+                Metrics::websocket(_sensorsWs.count(), delivery.delivered, delivery.dropped);
             }
         }
     }
 
     static auto checkModeChange() -> void 
     {
-        if(not cfg.accessPoint.enabled or WiFi.getMode() != WIFI_MODE_AP)
+        if(not cfg->accessPoint.enabled or WiFi.getMode() != WIFI_MODE_AP)
         {
             return;
         }
@@ -566,7 +959,7 @@ namespace WebInterface
         {
             Indicator::fast();
 
-            if( now - _modeTimer > std::chrono::seconds( cfg.accessPoint.duration ) )
+            if( now - _modeTimer > std::chrono::seconds( cfg->accessPoint.duration ) )
             {
                 _modeTimer = now;
                 configureStation();
@@ -574,29 +967,22 @@ namespace WebInterface
         }
     }
 
-    static auto checkReconnect() -> void 
+    static auto checkLink() -> void 
     {
-        if(not cfg.station.enabled or WiFi.getMode() != WIFI_MODE_STA)
+        if(not cfg->station.enabled or WiFi.getMode() != WIFI_MODE_STA)
         {
             return;
         }
 
-        const auto now = std::chrono::system_clock::now();
+        Link::process();
 
-        if(WiFi.isConnected())
+        if(Link::state() == Link::State::CONNECTED)
         {
             Indicator::slow();
-            _reconnectTimer = now;
         }
         else 
         {
             Indicator::fast();
-
-            if( now - _reconnectTimer > std::chrono::seconds{15} )
-            {
-                _reconnectTimer = now;
-                WiFi.begin();
-            }
         }
     }
 
@@ -614,10 +1000,59 @@ namespace WebInterface
         log_d( "end" );
     }
 
+    static auto checkReconfigure() -> void
+    {
+        if ( not _reconfigure.exchange( false ) )
+        {
+            return;
+        }
+
+        const auto previous = cfg.get();
+
+        if ( _reload.exchange( false ) )
+        {
+            Configuration::load();
+        }
+
+        if ( const auto next = std::atomic_exchange( &_pending, std::shared_ptr<const Configuration>{} ) )
+        {
+            Configuration::publish( *next );
+        }
+
+        const auto current = cfg.get();
+
+        if ( WebInterface::sourceChanged( *previous, *current ) )
+        {
+            WebInterface::reinicia();
+            return;
+        }
+
+        // Só a interface em uso cuja configuração mudou é refeita, a outra lê a nova quando entrar
+        const auto mode = WiFi.getMode();
+        const auto accessPoint = WebInterface::accessPointChanged( *previous, *current );
+        const auto station = WebInterface::stationChanged( *previous, *current );
+
+        if ( mode == WIFI_MODE_AP and accessPoint )
+        {
+            log_d( "access point reconfigure" );
+            if ( not configureAccessPoint() )
+            {
+                configureStation();
+            }
+            _modeTimer = std::chrono::system_clock::now();
+        }
+        else if ( mode != WIFI_MODE_AP and station )
+        {
+            log_d( "station reconfigure" );
+            configureStation();
+        }
+    }
+
     auto process() -> void
     {
+        WebInterface::checkReconfigure();
         WebInterface::checkModeChange();
-        WebInterface::checkReconnect();
+        WebInterface::checkLink();
         WebInterface::cleanupWebSockets();
         WebInterface::sendSensors();
     }
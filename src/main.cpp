@@ -7,6 +7,8 @@
 #include <LittleFS.h>
 #include <HTTPClient.h>
 
+#include "Boot.hpp"
+#include "Bus.hpp"
 #include "Configuration.hpp"
 #include "Database.hpp"
 #include "Peripherals.hpp"
@@ -15,34 +17,48 @@
 #include "Infos.hpp"
 #include "Utils.hpp"
 #include "Indicator.hpp"
+#include "Link.hpp"
+#include "Sleep.hpp"
+#include "Uplink.hpp"
 
 void setup()
 {
-    delay( 1000 );
     Serial.begin( 115200 );
     Serial.setDebugOutput( true );
 
     log_d( "begin" );
 
-    Peripherals::init();
-    Configuration::init();
+    Boot::step( "peripherals", Peripherals::init );
+    Boot::step( "bus", Bus::init );
+    Boot::step( "configuration", []{ Configuration::init(); Configuration::load(); } );
+    Boot::step( "sleep", Sleep::init );
 
-    Configuration::load( &cfg );
+    // SD e SQLite no SPI em paralelo com RTC e sensores no I2C, o Replay espera a montagem no mountCard
+    auto storage = Boot::background( "storage", []{ Peripherals::mountCard(); Database::init(); } );
 
-    RealTime::init();
-    Database::init();
-    WebInterface::init();
-    Infos::init();
-    Indicator::init();
+    Boot::step( "realtime", RealTime::init );
+    Boot::step( "infos", Infos::init );
+    Boot::step( "indicator", Indicator::init );
+
+    storage.wait();
+
+    // A associação Wi-Fi segue em segundo plano
+    Boot::step( "link", Link::init );
+    Boot::step( "web", WebInterface::init );
+    Boot::step( "uplink", Uplink::init );
+    Boot::mark( "setup" );
+    Boot::report();
 
     log_d( "end" );
 }
 
 void loop()
 {
+    Bus::process();
     Infos::process();
     Database::process();
     RealTime::process();
     WebInterface::process();
     Indicator::process();
+    Sleep::process();
 }
\ No newline at end of file
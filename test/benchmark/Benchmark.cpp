@@ -0,0 +1,190 @@
+#include <Arduino.h>
+
+#include <ArduinoJson.hpp>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include "Configuration.hpp"
+#include "Database.hpp"
+#include "Infos.hpp"
+#include "Utils.hpp"
+#include "Vfs.hpp"
+
+// Roda no host sobre um banco descartável em DATABASE_ROOT: pio run -e benchmark -t exec
+// O JSON vai para a saída padrão ou para o arquivo passado como argumento
+namespace Benchmark
+{
+    static constexpr auto BASE = std::time_t{86400};
+    static constexpr auto ROWS = 200u;
+    static constexpr auto ENCODES = 1000u;
+    static constexpr auto PARSES = 20u;
+    static constexpr auto CALLS = 10000u;
+
+    static auto elapsed( std::chrono::steady_clock::time_point start ) -> float
+    {
+        return std::chrono::duration<float, std::micro>( std::chrono::steady_clock::now() - start ).count();
+    }
+
+    static auto insert( ArduinoJson::JsonObject json ) -> void
+    {
+        auto sample = Infos::SensorData::get();
+
+        const auto start = std::chrono::steady_clock::now();
+        for ( auto i = 0u; i < ROWS; ++i )
+        {
+            sample.dateTime = BASE + i * 900;
+            Database::insert( sample );
+        }
+        const auto us = elapsed( start );
+
+        json["rows"] = ROWS;
+        json["us"] = us;
+        json["rows_per_s"] = ROWS * 1e6f / us;
+    }
+
+    static auto query( ArduinoJson::JsonObject json ) -> void
+    {
+        auto rows = 0u;
+
+        const auto start = std::chrono::steady_clock::now();
+        {
+            auto filter = Database::Filter{ std::chrono::system_clock::from_time_t( BASE ), std::chrono::system_clock::from_time_t( BASE + ROWS * 900 ), ROWS };
+            while ( filter.next() )
+            {
+                rows += 1;
+            }
+        }
+        const auto us = elapsed( start );
+
+        json["rows"] = rows;
+        json["us"] = us;
+        json["rows_per_s"] = rows * 1e6f / us;
+    }
+
+    static auto csv( ArduinoJson::JsonObject json ) -> void
+    {
+        const auto sample = Infos::SensorData::get();
+        auto row = std::array<char, 100>{};
+        auto bytes = 0u;
+
+        const auto start = std::chrono::steady_clock::now();
+        for ( auto i = 0u; i < ENCODES; ++i )
+        {
+            bytes += sample.serialize( row );
+        }
+        const auto us = elapsed( start );
+
+        json["rows"] = ENCODES;
+        json["us"] = us;
+        json["rows_per_s"] = ENCODES * 1e6f / us;
+        json["bytes_per_s"] = bytes * 1e6f / us;
+    }
+
+    static auto encode( ArduinoJson::JsonObject json ) -> void
+    {
+        const auto sample = Infos::SensorData::get();
+        auto buffer = std::array<char, 512>{};
+        auto bytes = 0u;
+
+        const auto start = std::chrono::steady_clock::now();
+        for ( auto i = 0u; i < ENCODES; ++i )
+        {
+            auto doc = ArduinoJson::StaticJsonDocument<512>{};
+            auto variant = doc.as<ArduinoJson::JsonVariant>();
+            sample.serialize( variant );
+            bytes += ArduinoJson::serializeJson( doc, buffer.data(), buffer.size() );
+        }
+        const auto us = elapsed( start );
+
+        json["rows"] = ENCODES;
+        json["us"] = us;
+        json["rows_per_s"] = ENCODES * 1e6f / us;
+        json["bytes_per_s"] = bytes * 1e6f / us;
+    }
+
+    static auto config( ArduinoJson::JsonObject json ) -> void
+    {
+        auto text = std::string{};
+        {
+            auto doc = ArduinoJson::DynamicJsonDocument{3072};
+            auto variant = doc.as<ArduinoJson::JsonVariant>();
+            const auto current = cfg.get();
+            current->serialize( variant );
+            ArduinoJson::serializeJson( doc, text );
+        }
+
+        auto copy{*cfg.get()};
+
+        const auto start = std::chrono::steady_clock::now();
+        for ( auto i = 0u; i < PARSES; ++i )
+        {
+            auto doc = ArduinoJson::DynamicJsonDocument{3072};
+            ArduinoJson::deserializeJson( doc, text );
+            copy.deserialize( doc.as<ArduinoJson::JsonVariant>() );
+        }
+        const auto us = elapsed( start );
+
+        json["bytes"] = text.size();
+        json["us_per_parse"] = us / PARSES;
+    }
+
+    static auto noop() -> void
+    {
+    }
+
+    static auto scheduler( ArduinoJson::JsonObject json ) -> void
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for ( auto i = 0u; i < CALLS; ++i )
+        {
+            Utils::periodic( std::chrono::hours{1}, Benchmark::noop );
+        }
+        const auto us = elapsed( start );
+
+        json["calls"] = CALLS;
+        json["ns_per_call"] = us * 1000.0f / CALLS;
+    }
+} // namespace Benchmark
+
+auto main( int argc, char** argv ) -> int
+{
+    // Cada execução parte de um banco vazio
+    std::filesystem::create_directories( DATABASE_ROOT );
+    std::filesystem::remove( DATABASE_ROOT "/sensors_data.db" );
+
+    Infos::init();
+    Database::init();
+
+    auto doc = ArduinoJson::DynamicJsonDocument{3072};
+
+    doc["build"] = __DATE__ " " __TIME__;
+    doc["datetime"] = Utils::DateTime::toString( std::chrono::system_clock::now() );
+    doc["source"] = Utils::SensorSource::getName( cfg->source.type ).data();
+
+    // Contadores do VFS cobrem só a inserção e a consulta
+    Vfs::reset();
+    Benchmark::insert( doc["insert"].to<ArduinoJson::JsonObject>() );
+    Benchmark::query( doc["query"].to<ArduinoJson::JsonObject>() );
+    auto vfs = doc["vfs"].to<ArduinoJson::JsonVariant>();
+    Vfs::serialize( vfs );
+    Benchmark::csv( doc["csv"].to<ArduinoJson::JsonObject>() );
+    Benchmark::encode( doc["json"].to<ArduinoJson::JsonObject>() );
+    Benchmark::config( doc["config"].to<ArduinoJson::JsonObject>() );
+    Benchmark::scheduler( doc["scheduler"].to<ArduinoJson::JsonObject>() );
+
+    if ( argc > 1 )
+    {
+        auto file = std::ofstream{ argv[1] };
+        ArduinoJson::serializeJsonPretty( doc, file );
+        return file ? 0 : 1;
+    }
+
+    ArduinoJson::serializeJsonPretty( doc, std::cout );
+    std::cout << std::endl;
+    return 0;
+}
\ No newline at end of file
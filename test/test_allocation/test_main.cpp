@@ -0,0 +1,216 @@
+#include <Arduino.h>
+
+#include <ArduinoJson.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unity.h>
+
+#include "Configuration.hpp"
+#include "Infos.hpp"
+#include "Utils.hpp"
+
+// Contar alocações só vale sobre o ArduinoJson de verdade (lib_deps do env:native), não sobre um substituto
+#if not defined( ARDUINOJSON_VERSION_MAJOR ) or ARDUINOJSON_VERSION_MAJOR != 6
+#error "test_allocation precisa do ArduinoJson 6 real"
+#endif
+
+// Toda alocação do programa passa por aqui, os testes contam só dentro do trecho medido
+static std::atomic<bool> counting = {false};
+static std::atomic<uint32_t> allocations = {0};
+
+auto operator new( std::size_t size ) -> void*
+{
+    if ( counting )
+    {
+        allocations += 1;
+    }
+    if ( auto pointer = std::malloc( size == 0 ? 1 : size ) )
+    {
+        return pointer;
+    }
+    throw std::bad_alloc{};
+}
+
+auto operator new[]( std::size_t size ) -> void*
+{
+    return ::operator new( size );
+}
+
+auto operator delete( void* pointer ) noexcept -> void
+{
+    std::free( pointer );
+}
+
+auto operator delete[]( void* pointer ) noexcept -> void
+{
+    std::free( pointer );
+}
+
+auto operator delete( void* pointer, std::size_t ) noexcept -> void
+{
+    std::free( pointer );
+}
+
+auto operator delete[]( void* pointer, std::size_t ) noexcept -> void
+{
+    std::free( pointer );
+}
+
+template<typename F>
+static auto allocationsOf( F&& f ) -> uint32_t
+{
+    allocations = 0;
+    counting = true;
+    f();
+    counting = false;
+    return allocations;
+}
+
+static const auto SAMPLE = Infos::SensorData{
+    .dateTime = 1700000000,
+    .temperature = 23.5f,
+    .humidity = 61.0f,
+    .pressure = 1013.2f,
+    .windSpeed = 12.3f,
+    .windGust = 20.1f,
+    .windDirection = WindDirection::NORTHEAST,
+    .rainIntensity = RainIntensity::HUMID,
+    .windVector = 44.0f,
+    .windSteadiness = 0.8f,
+};
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+// As tabelas são constexpr: nem precisam rodar para responder
+static_assert( Utils::WindDirection::getName( WindDirection::WEST ) == "Oeste" );
+static_assert( Utils::RainIntensity::getValue( "Chuva" ) == RainIntensity::RAINY );
+
+static auto test_enum_tables() -> void
+{
+    const auto count = allocationsOf( []
+    {
+        for ( const auto& [value, name] : Utils::WindDirection::names )
+        {
+            TEST_ASSERT_TRUE( Utils::WindDirection::getValue( Utils::WindDirection::getName( value ) ) == value );
+            TEST_ASSERT_TRUE( Utils::WindDirection::getName( value ) == name );
+        }
+        for ( const auto& [value, name] : Utils::RainIntensity::names )
+        {
+            TEST_ASSERT_TRUE( Utils::RainIntensity::getValue( name ) == value );
+        }
+        TEST_ASSERT_TRUE( Utils::SensorSource::getValue( "?" ) == SensorSource::HARDWARE );
+        TEST_ASSERT_FALSE( Utils::WindDirection::getValue( "Norte " ).has_value() );
+    } );
+    TEST_ASSERT_EQUAL_UINT32( 0, count );
+}
+
+// Leitura da versão vigente e cópia da configuração inteira, o caminho de todo cfg->
+static auto test_configuration_hot_path() -> void
+{
+    auto total = 0u;
+    const auto count = allocationsOf( [&total]
+    {
+        for ( auto i = 0; i < 100; ++i )
+        {
+            total += cfg->windSpeed.cadence + cfg->deepSleep.window;
+        }
+
+        auto copy = *cfg.get();
+        copy.station.user = "estacao-com-um-nome-longo-que-nao-cabe-no-campo";
+        copy.source.file = std::string_view{"/sd/replay.csv"};
+        TEST_ASSERT_EQUAL( 32u, copy.station.user.size() );
+        TEST_ASSERT_TRUE( std::string_view{copy.source.file} == "/sd/replay.csv" );
+    } );
+    TEST_ASSERT_EQUAL_UINT32( 0, count );
+    TEST_ASSERT_TRUE( total > 0 );
+}
+
+static auto test_configuration_json() -> void
+{
+    static auto doc = ArduinoJson::StaticJsonDocument<4096>{};
+    auto source = *cfg.get();
+    auto parsed = *cfg.get();
+
+    // Valores fora do padrão: a ida e volta só passa se o documento carregou os dados
+    source.station.user = "estacao-teste";
+    source.windSpeed.cadence += 7;
+    source.temperature.factor = 1.25f;
+
+    const auto count = allocationsOf( [&source, &parsed]
+    {
+        doc.clear();
+        auto json = doc.to<ArduinoJson::JsonVariant>();
+        source.serialize( json );
+        parsed.deserialize( json );
+    } );
+    TEST_ASSERT_EQUAL_UINT32( 0, count );
+    TEST_ASSERT_FALSE( doc.overflowed() );
+    TEST_ASSERT_TRUE( doc.memoryUsage() > 0 );
+    TEST_ASSERT_TRUE( parsed.station.user == source.station.user );
+    TEST_ASSERT_EQUAL( source.windSpeed.cadence, parsed.windSpeed.cadence );
+    TEST_ASSERT_FLOAT_WITHIN( 0.001f, 1.25f, parsed.temperature.factor );
+}
+
+// Linha do /data.csv e JSON do WebSocket
+static auto test_sensor_serialization() -> void
+{
+    static auto doc = ArduinoJson::StaticJsonDocument<1024>{};
+    auto row = std::array<char, 100>{};
+    auto text = Utils::DateTime::Text{};
+    auto length = 0;
+
+    const auto count = allocationsOf( [&]
+    {
+        for ( auto i = 0; i < 100; ++i )
+        {
+            length = SAMPLE.serialize( row );
+        }
+
+        doc.clear();
+        auto json = doc.to<ArduinoJson::JsonVariant>();
+        SAMPLE.serialize( json );
+
+        Utils::DateTime::toString( std::chrono::system_clock::from_time_t( SAMPLE.dateTime ), text );
+    } );
+    TEST_ASSERT_EQUAL_UINT32( 0, count );
+    TEST_ASSERT_FALSE( doc.overflowed() );
+    TEST_ASSERT_TRUE( doc.size() > 0 );
+    TEST_ASSERT_TRUE( length > 0 and length < static_cast<int>( row.size() ) );
+    TEST_ASSERT_EQUAL( 19u, std::strlen( text.data() ) );
+}
+
+// O contador funciona: um std::string longo aloca
+static auto test_counter_sees_allocations() -> void
+{
+    const auto count = allocationsOf( []
+    {
+        auto text = std::string( 200, 'x' );
+        TEST_ASSERT_EQUAL( 200u, text.size() );
+    } );
+    TEST_ASSERT_TRUE( count > 0 );
+}
+
+auto main() -> int
+{
+    Configuration::init();
+
+    UNITY_BEGIN();
+    RUN_TEST( test_counter_sees_allocations );
+    RUN_TEST( test_enum_tables );
+    RUN_TEST( test_configuration_hot_path );
+    RUN_TEST( test_configuration_json );
+    RUN_TEST( test_sensor_serialization );
+    return UNITY_END();
+}
\ No newline at end of file
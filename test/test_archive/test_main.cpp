@@ -0,0 +1,103 @@
+#include <Arduino.h>
+
+#include <chrono>
+#include <ctime>
+#include <filesystem>
+#include <unity.h>
+#include <vector>
+
+#include "Configuration.hpp"
+#include "Database.hpp"
+
+static constexpr auto BASE = std::time_t{1700000000};
+
+static auto sample( std::time_t dateTime, float speed, float gust ) -> Infos::SensorData
+{
+    auto sensorData = Infos::SensorData{};
+    sensorData.dateTime = dateTime;
+    sensorData.windSpeed = speed;
+    sensorData.windGust = gust;
+    sensorData.windDirection = WindDirection::NORTH;
+    return sensorData;
+}
+
+static auto raw( std::time_t start, std::time_t end ) -> std::vector<Infos::SensorData>
+{
+    auto filter = Database::Filter{ std::chrono::system_clock::from_time_t( start ), std::chrono::system_clock::from_time_t( end ), 1000, Database::Resolution::RAW };
+    auto rows = std::vector<Infos::SensorData>{};
+    while ( const auto sensorData = filter.next() )
+    {
+        rows.push_back( *sensorData );
+    }
+    return rows;
+}
+
+auto setUp() -> void
+{
+}
+
+auto tearDown() -> void
+{
+}
+
+// Rajada curta de uma amostra de 10 s continua no arquivo bruto
+static auto test_raw_keeps_gust() -> void
+{
+    auto samples = std::vector<Infos::SensorData>{};
+    for ( auto i = 0; i < 90; i++ )
+    {
+        samples.push_back( sample( BASE + i * 10, 3.0f, i == 42 ? 17.5f : 4.0f ) );
+    }
+    Database::archive( samples );
+
+    const auto rows = raw( BASE, BASE + 899 );
+    TEST_ASSERT_EQUAL_UINT32( 90, rows.size() );
+    TEST_ASSERT_FLOAT_WITHIN( 0.001f, 17.5f, rows[42].windGust );
+    TEST_ASSERT_FLOAT_WITHIN( 0.001f, 4.0f, rows[41].windGust );
+    TEST_ASSERT_FLOAT_WITHIN( 0.001f, 3.0f, rows[42].windSpeed );
+}
+
+// Consulta bruta não completa com os registros agregados da memória
+static auto test_raw_excludes_aggregates() -> void
+{
+    Database::insert( sample( BASE + 7200, 5.0f, 9.0f ) );
+
+    TEST_ASSERT_EQUAL_UINT32( 0, raw( BASE + 3600, BASE + 10800 ).size() );
+}
+
+// Retenção apaga do cartão e da memória, a consulta agregada não devolve o que saiu
+static auto test_cleanup_evicts_hot() -> void
+{
+    const auto now = std::time( nullptr );
+    const auto old = now - now % 900 - 400 * 86400;
+    const auto recent = now - now % 900 - 86400;
+    Database::insert( sample( old, 1.0f, 1.0f ) );
+    Database::insert( sample( recent, 2.0f, 2.0f ) );
+
+    Database::cleanup();
+
+    auto filter = Database::Filter{ std::chrono::system_clock::from_time_t( old - 1 ), std::chrono::system_clock::from_time_t( now ), 1000 };
+    auto rows = std::vector<Infos::SensorData>{};
+    while ( const auto sensorData = filter.next() )
+    {
+        rows.push_back( *sensorData );
+    }
+    TEST_ASSERT_EQUAL_UINT32( 1, rows.size() );
+    TEST_ASSERT_TRUE( rows[0].dateTime == recent );
+}
+
+auto main() -> int
+{
+    // Cada execução parte de um banco vazio
+    std::filesystem::create_directories( DATABASE_ROOT );
+    std::filesystem::remove( DATABASE_ROOT "/sensors_data.db" );
+
+    Configuration::init();
+    Database::init();
+
+    UNITY_BEGIN();
+    RUN_TEST( test_raw_keeps_gust );
+    RUN_TEST( test_raw_excludes_aggregates );
+    RUN_TEST( test_cleanup_evicts_hot );
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include <Arduino.h>
+
+#include <optional>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+#include "Classifier.hpp"
+#include "Configuration.hpp"
+
+// Referência direta: a primeira faixa da configuração que contém a leitura
+template<typename Threshoulds>
+static auto expected( const Threshoulds& threshoulds, std::size_t n ) -> std::optional<typename Threshoulds::value_type::first_type>
+{
+    for ( const auto& [value, threshould] : threshoulds )
+    {
+        if ( threshould.first <= n and n <= threshould.second )
+        {
+            return value;
+        }
+    }
+    return {};
+}
+
+// Mapa de cobertura por leitura, como o validate fazia antes
+template<typename Threshoulds>
+static auto reference( const char* name, const Threshoulds& threshoulds ) -> std::vector<std::string>
+{
+    auto warnings = std::vector<std::string>{};
+    auto coverage = std::vector<uint8_t>( Classifier::RESOLUTION );
+    for ( const auto& [value, threshould] : threshoulds )
+    {
+        if ( threshould.first > threshould.second or threshould.second >= Classifier::RESOLUTION )
+        {
+            warnings.emplace_back( std::string{name} + ": invalid range " + std::to_string( threshould.first ) + "-" + std::to_string( threshould.second ) );
+            continue;
+        }
+        for ( auto n = std::size_t{threshould.first}; n <= threshould.second; n++ )
+        {
+            coverage[n] = std::min<uint8_t>( coverage[n] + 1, 2 );
+        }
+    }
+
+    auto n = std::size_t{0};
+    while ( n < Classifier::RESOLUTION )
+    {
+        auto last = n;
+        while ( last + 1 < Classifier::RESOLUTION and coverage[last + 1] == coverage[n] )
+        {
+            last += 1;
+        }
+        if ( coverage[n] != 1 )
+        {
+            warnings.emplace_back( std::string{name} + ( coverage[n] == 0 ? ": gap " : ": overlap " ) + std::to_string( n ) + "-" + std::to_string( last ) );
+        }
+        n = last + 1;
+    }
+    return warnings;
+}
+
+static auto check( const Configuration& config ) -> void
+{
+    Classifier::load( config );
+
+    for ( auto n = std::size_t{0}; n < Classifier::RESOLUTION; n++ )
+    {
+        TEST_ASSERT_TRUE( Classifier::windDirection( n ) == expected( config.windDirection.threshoulds, n ) );
+        TEST_ASSERT_TRUE( Classifier::rainIntensity( n ) == expected( config.rainIntensity.threshoulds, n ) );
+    }
+
+    auto warnings = reference( "wind_direction", config.windDirection.threshoulds );
+    const auto rain = reference( "rain_intensity", config.rainIntensity.threshoulds );
+    warnings.insert( warnings.end(), rain.begin(), rain.end() );
+    TEST_ASSERT_TRUE( Classifier::validate( config ) == warnings );
+}
+
+static auto defaults() -> Configuration
+{
+    return Configuration{ *cfg.get() };
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+    Classifier::load( defaults() );
+}
+
+static void test_defaults()
+{
+    check( defaults() );
+}
+
+static void test_gaps_and_overlaps()
+{
+    auto config = defaults();
+    config.windDirection.threshoulds[0].second.first = 100;
+    config.windDirection.threshoulds[3].second = { 0, 0 };
+    config.rainIntensity.threshoulds[1].second = { 1200, 4095 };
+    config.rainIntensity.threshoulds[2].second = { 4000, 4095 };
+    check( config );
+}
+
+static void test_invalid_ranges()
+{
+    auto config = defaults();
+    config.windDirection.threshoulds[2].second = { 3000, 2000 };
+    config.rainIntensity.threshoulds[0].second = { 0, 4096 };
+    check( config );
+}
+
+static void test_full_overlap()
+{
+    auto config = defaults();
+    for ( auto& [value, threshould] : config.rainIntensity.threshoulds )
+    {
+        threshould = { 0, 4095 };
+    }
+    check( config );
+}
+
+static void test_out_of_range_reading()
+{
+    Classifier::load( defaults() );
+    TEST_ASSERT_TRUE( Classifier::windDirection( 0xFFFF ) == Classifier::windDirection( Classifier::RESOLUTION - 1 ) );
+    TEST_ASSERT_TRUE( Classifier::rainIntensity( 0xFFFF ) == Classifier::rainIntensity( Classifier::RESOLUTION - 1 ) );
+}
+
+auto main() -> int
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_defaults );
+    RUN_TEST( test_gaps_and_overlaps );
+    RUN_TEST( test_invalid_ranges );
+    RUN_TEST( test_full_overlap );
+    RUN_TEST( test_out_of_range_reading );
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include <Arduino.h>
+
+#include <ArduinoJson.hpp>
+#include <FastCRC.h>
+#include <Preferences.h>
+#include <cstring>
+#include <unity.h>
+#include <vector>
+
+#include "Configuration.hpp"
+
+auto setUp() -> void
+{
+}
+
+auto tearDown() -> void
+{
+}
+
+static auto assertUsable( const Configuration::DeepSleep& deepSleep ) -> void
+{
+    TEST_ASSERT_TRUE( deepSleep.interval >= 1 );
+    TEST_ASSERT_TRUE( deepSleep.interval <= Configuration::DeepSleep::MAX_INTERVAL );
+    TEST_ASSERT_TRUE( deepSleep.window >= deepSleep.interval );
+    TEST_ASSERT_TRUE( deepSleep.window <= Configuration::DeepSleep::MAX_WINDOW );
+    TEST_ASSERT_EQUAL_UINT32( 0, deepSleep.window % deepSleep.interval );
+    TEST_ASSERT_TRUE( deepSleep.awake >= Configuration::DeepSleep::MIN_AWAKE );
+    TEST_ASSERT_TRUE( deepSleep.awake <= Configuration::DeepSleep::MAX_AWAKE );
+    TEST_ASSERT_TRUE( deepSleep.online <= Configuration::DeepSleep::MAX_AWAKE );
+}
+
+static auto test_limit_zero_values() -> void
+{
+    auto deepSleep = Configuration::DeepSleep{ true, 0, 0, 0, 0 };
+    deepSleep.limit();
+
+    assertUsable( deepSleep );
+    TEST_ASSERT_EQUAL_UINT32( 1, deepSleep.interval );
+    TEST_ASSERT_EQUAL_UINT32( 1, deepSleep.window );
+    TEST_ASSERT_EQUAL_UINT32( 0, deepSleep.online );
+}
+
+static auto test_limit_out_of_range() -> void
+{
+    auto deepSleep = Configuration::DeepSleep{ true, 65535, 65535, 65535, 65535 };
+    deepSleep.limit();
+    assertUsable( deepSleep );
+
+    // Janela menor que o período sobe até ele, a que não é múltipla desce ao múltiplo anterior
+    deepSleep = Configuration::DeepSleep{ true, 60, 30, 300, 0 };
+    deepSleep.limit();
+    TEST_ASSERT_EQUAL_UINT32( 60, deepSleep.window );
+
+    deepSleep = Configuration::DeepSleep{ true, 60, 950, 300, 0 };
+    deepSleep.limit();
+    TEST_ASSERT_EQUAL_UINT32( 900, deepSleep.window );
+
+    // Valores válidos passam intactos
+    deepSleep = Configuration::DeepSleep{ true, 10, 900, 300, 120 };
+    deepSleep.limit();
+    TEST_ASSERT_EQUAL_UINT32( 10, deepSleep.interval );
+    TEST_ASSERT_EQUAL_UINT32( 900, deepSleep.window );
+    TEST_ASSERT_EQUAL_UINT32( 300, deepSleep.awake );
+    TEST_ASSERT_EQUAL_UINT32( 120, deepSleep.online );
+}
+
+static auto test_json_is_limited() -> void
+{
+    auto doc = ArduinoJson::DynamicJsonDocument{1024};
+    const auto text = R"({"deep_sleep":{"enabled":true,"interval":0,"window":0,"awake":0,"online":100000}})";
+    TEST_ASSERT_TRUE( ArduinoJson::deserializeJson( doc, text ) == ArduinoJson::DeserializationError::Ok );
+
+    auto parsed = *cfg.get();
+    parsed.deserialize( doc.as<ArduinoJson::JsonVariant>() );
+    assertUsable( parsed.deepSleep );
+}
+
+// Registro gravado por uma versão sem limites ainda carrega valores usáveis
+static auto test_record_is_limited() -> void
+{
+    auto broken = *cfg.get();
+    broken.deepSleep = Configuration::DeepSleep{ true, 0, 0, 0, 65535 };
+    Configuration::save( broken );
+
+    Configuration::load();
+    assertUsable( cfg->deepSleep );
+    TEST_ASSERT_TRUE( cfg->deepSleep.enabled );
+}
+
+// Registro da versão 2, que terminava nas redes: convertido uma vez e gravado já na versão atual
+static auto test_upgrade_is_persisted() -> void
+{
+    auto current = *cfg.get();
+    current.station.port = 1234;
+    Configuration::save( current );
+
+    auto preferences = Preferences{};
+    TEST_ASSERT_TRUE( preferences.begin( "configuration", false ) );
+    const auto size = preferences.getBytesLength( "record" );
+    auto blob = std::vector<uint8_t>( size );
+    TEST_ASSERT_EQUAL_UINT32( size, preferences.getBytes( "record", blob.data(), blob.size() ) );
+
+    // versão, tamanho e as duas redes de 113 bytes, seguidos do crc
+    const auto body = std::size_t{4 + 2 * 113};
+    const auto version = uint16_t{2};
+    const auto length = static_cast<uint16_t>( body + sizeof( uint32_t ) );
+    blob.resize( length );
+    std::memcpy( blob.data(), &version, sizeof( version ) );
+    std::memcpy( blob.data() + 2, &length, sizeof( length ) );
+    auto fastCRC = FastCRC32{};
+    const auto crc = fastCRC.crc32( blob.data(), body );
+    std::memcpy( blob.data() + body, &crc, sizeof( crc ) );
+    TEST_ASSERT_EQUAL_UINT32( blob.size(), preferences.putBytes( "record", blob.data(), blob.size() ) );
+    preferences.end();
+
+    Configuration::load();
+    TEST_ASSERT_EQUAL_UINT32( 1234, cfg->station.port );
+
+    TEST_ASSERT_TRUE( preferences.begin( "configuration", true ) );
+    TEST_ASSERT_EQUAL_UINT32( size, preferences.getBytesLength( "record" ) );
+    auto upgraded = std::vector<uint8_t>( size );
+    preferences.getBytes( "record", upgraded.data(), upgraded.size() );
+    preferences.end();
+
+    auto stored = uint16_t{};
+    std::memcpy( &stored, upgraded.data(), sizeof( stored ) );
+    TEST_ASSERT_TRUE( stored > version );
+}
+
+auto main() -> int
+{
+    Configuration::init();
+
+    UNITY_BEGIN();
+    RUN_TEST( test_limit_zero_values );
+    RUN_TEST( test_limit_out_of_range );
+    RUN_TEST( test_json_is_limited );
+    RUN_TEST( test_record_is_limited );
+    RUN_TEST( test_upgrade_is_persisted );
+    return UNITY_END();
+}
\ No newline at end of file
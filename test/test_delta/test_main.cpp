@@ -0,0 +1,251 @@
+#include <Arduino.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <unity.h>
+#include <vector>
+
+#include "Delta.hpp"
+
+// Partição em execução e partição de destino simuladas
+static std::vector<uint8_t> running = {};
+static std::vector<uint8_t> written = {};
+
+static auto source( uint32_t offset, uint8_t* data, std::size_t length ) -> bool
+{
+    if ( offset + length > running.size() )
+    {
+        return false;
+    }
+    std::memcpy( data, running.data() + offset, length );
+    return true;
+}
+
+static auto sink( const uint8_t* data, std::size_t length ) -> bool
+{
+    written.insert( written.end(), data, data + length );
+    return true;
+}
+
+struct Entry
+{
+    uint32_t diff;
+    uint32_t extra;
+    int64_t seek;
+};
+
+static auto digest( const std::vector<uint8_t>& data ) -> Delta::Digest
+{
+    auto sha = mbedtls_sha256_context{};
+    auto result = Delta::Digest{};
+    mbedtls_sha256_init( &sha );
+    mbedtls_sha256_starts_ret( &sha, 0 );
+    mbedtls_sha256_update_ret( &sha, data.data(), data.size() );
+    mbedtls_sha256_finish_ret( &sha, result.data() );
+    mbedtls_sha256_free( &sha );
+    return result;
+}
+
+static auto leb128( std::vector<uint8_t>& out, uint64_t value ) -> void
+{
+    do
+    {
+        const auto byte = static_cast<uint8_t>( value & 0x7f );
+        value >>= 7;
+        out.push_back( value != 0 ? byte | 0x80 : byte );
+    } while ( value != 0 );
+}
+
+// Mesmo formato que o gerador de patches: cabeçalho e entradas (diff, extra, seek em zigzag)
+static auto encode( const std::vector<uint8_t>& old, const std::vector<uint8_t>& target, const std::vector<Entry>& entries ) -> std::vector<uint8_t>
+{
+    auto patch = std::vector<uint8_t>( Delta::MAGIC.begin(), Delta::MAGIC.end() );
+    const auto size = static_cast<uint32_t>( target.size() );
+    patch.insert( patch.end(), reinterpret_cast<const uint8_t*>( &size ), reinterpret_cast<const uint8_t*>( &size ) + sizeof( size ) );
+    const auto from = digest( old );
+    const auto to = digest( target );
+    patch.insert( patch.end(), from.begin(), from.end() );
+    patch.insert( patch.end(), to.begin(), to.end() );
+
+    auto position = int64_t{0};
+    auto produced = std::size_t{0};
+    for ( const auto& entry : entries )
+    {
+        leb128( patch, entry.diff );
+        leb128( patch, entry.extra );
+        leb128( patch, ( static_cast<uint64_t>( entry.seek ) << 1 ) ^ static_cast<uint64_t>( entry.seek >> 63 ) );
+        for ( auto i = 0u; i < entry.diff; ++i )
+        {
+            patch.push_back( static_cast<uint8_t>( target[produced++] - old[position++] ) );
+        }
+        patch.insert( patch.end(), target.begin() + produced, target.begin() + produced + entry.extra );
+        produced += entry.extra;
+        position += entry.seek;
+    }
+    return patch;
+}
+
+// Versão nova a partir da antiga: trechos copiados com poucos bytes trocados, inserções e saltos para os dois lados
+static auto edit( const std::vector<uint8_t>& old, std::mt19937& random, std::vector<Entry>& entries ) -> std::vector<uint8_t>
+{
+    auto target = std::vector<uint8_t>{};
+    auto position = int64_t{0};
+    for ( auto n = 0; n < 40; ++n )
+    {
+        const auto diff = static_cast<uint32_t>( random() % std::min<int64_t>( 20000, static_cast<int64_t>( old.size() ) - position + 1 ) );
+        for ( auto i = 0u; i < diff; ++i )
+        {
+            target.push_back( random() % 500 == 0 ? static_cast<uint8_t>( random() ) : old[position + i] );
+        }
+        position += diff;
+
+        const auto extra = static_cast<uint32_t>( random() % 3 == 0 ? random() % 2000 : 0 );
+        for ( auto i = 0u; i < extra; ++i )
+        {
+            target.push_back( static_cast<uint8_t>( random() ) );
+        }
+
+        const auto seek = static_cast<int64_t>( random() % ( old.size() + 1 ) ) - position;
+        entries.push_back( Entry{ diff, extra, seek } );
+        position += seek;
+    }
+    return target;
+}
+
+static auto apply( const std::vector<uint8_t>& patch, std::mt19937& random, std::size_t max ) -> std::unique_ptr<Delta::Patcher>
+{
+    written.clear();
+    auto patcher = std::make_unique<Delta::Patcher>( digest( running ), source, sink );
+    auto size = std::uniform_int_distribution<std::size_t>{1, max};
+    for ( auto offset = std::size_t{0}; offset < patch.size(); )
+    {
+        const auto length = std::min( size( random ), patch.size() - offset );
+        if ( not patcher->write( patch.data() + offset, length ) )
+        {
+            break;
+        }
+        offset += length;
+    }
+    return patcher;
+}
+
+void setUp()
+{
+    auto random = std::mt19937{10};
+    running.resize( 200000 );
+    std::generate( running.begin(), running.end(), [&random] { return static_cast<uint8_t>( random() % 16 ); } );
+}
+
+void tearDown()
+{
+}
+
+static auto test_sha256_vector() -> void
+{
+    const auto result = digest( { 'a', 'b', 'c' } );
+    const uint8_t expected[] = { 0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+                                 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad };
+    TEST_ASSERT_EQUAL_MEMORY( expected, result.data(), sizeof( expected ) );
+}
+
+static auto test_applies_random_chunks() -> void
+{
+    auto random = std::mt19937{11};
+    auto entries = std::vector<Entry>{};
+    const auto target = edit( running, random, entries );
+    const auto patch = encode( running, target, entries );
+
+    for ( const std::size_t max : {1, 13, 256, 4096} )
+    {
+        const auto patcher = apply( patch, random, max );
+        TEST_ASSERT_TRUE_MESSAGE( patcher->done(), patcher->error() );
+        TEST_ASSERT_EQUAL_UINT32( target.size(), patcher->written() );
+        TEST_ASSERT_TRUE( written == target );
+    }
+}
+
+static auto test_empty_target() -> void
+{
+    auto random = std::mt19937{12};
+    const auto patcher = apply( encode( running, {}, {} ), random, 7 );
+    TEST_ASSERT_TRUE( patcher->done() );
+    TEST_ASSERT_EQUAL( 0u, written.size() );
+}
+
+static auto test_rejects_other_firmware() -> void
+{
+    auto random = std::mt19937{13};
+    auto entries = std::vector<Entry>{};
+    const auto target = edit( running, random, entries );
+    const auto patch = encode( running, target, entries );
+
+    running[100] ^= 1;
+    const auto patcher = apply( patch, random, 64 );
+    TEST_ASSERT_FALSE( patcher->done() );
+    TEST_ASSERT_EQUAL_STRING( "patch does not match running firmware", patcher->error() );
+    TEST_ASSERT_EQUAL( 0u, written.size() );
+}
+
+static auto test_rejects_damaged_patch() -> void
+{
+    auto random = std::mt19937{14};
+    auto entries = std::vector<Entry>{ { 1000, 10, 0 } };
+    auto target = std::vector<uint8_t>( running.begin(), running.begin() + 1000 );
+    target.insert( target.end(), 10, 0xaa );
+    const auto patch = encode( running, target, entries );
+
+    auto magic = patch;
+    magic[0] = 'X';
+    TEST_ASSERT_EQUAL_STRING( "not a patch", apply( magic, random, 64 )->error() );
+
+    // Um byte de diff trocado só aparece no digest do final
+    auto data = patch;
+    data[data.size() - 20] ^= 0x40;
+    TEST_ASSERT_EQUAL_STRING( "digest mismatch", apply( data, random, 64 )->error() );
+
+    auto truncated = patch;
+    truncated.resize( truncated.size() - 3 );
+    TEST_ASSERT_EQUAL_STRING( "truncated patch", apply( truncated, random, 64 )->error() );
+
+    auto trailing = patch;
+    trailing.push_back( 0 );
+    TEST_ASSERT_EQUAL_STRING( "data after end of patch", apply( trailing, random, 64 )->error() );
+}
+
+static auto test_rejects_bad_entries() -> void
+{
+    auto random = std::mt19937{15};
+    auto target = std::vector<uint8_t>( 100, 0x55 );
+
+    // Entrada maior que o que falta do resultado
+    auto header = encode( running, target, {} );
+    leb128( header, 90 );
+    leb128( header, 20 );
+    leb128( header, 0 );
+    TEST_ASSERT_EQUAL_STRING( "entry exceeds target size", apply( header, random, 64 )->error() );
+
+    // Seek para antes do início da origem
+    auto before = encode( running, target, {} );
+    leb128( before, 0 );
+    leb128( before, 0 );
+    leb128( before, ( 10u << 1 ) | 1 );
+    leb128( before, 10 );
+    leb128( before, 0 );
+    leb128( before, 0 );
+    before.insert( before.end(), 10, 0 );
+    TEST_ASSERT_EQUAL_STRING( "source read error", apply( before, random, 64 )->error() );
+}
+
+auto main() -> int
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_sha256_vector );
+    RUN_TEST( test_applies_random_chunks );
+    RUN_TEST( test_empty_target );
+    RUN_TEST( test_rejects_other_firmware );
+    RUN_TEST( test_rejects_damaged_patch );
+    RUN_TEST( test_rejects_bad_entries );
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include <Arduino.h>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <unity.h>
+
+#include "RealTime.hpp"
+
+using namespace std::chrono;
+
+// DS3231 simulado: conta em segundos fracionários e só mostra a parte inteira
+struct Clock
+{
+    double rtc;
+    double ppm;
+    int8_t aging = 0;
+    uint32_t updates = 0;
+
+    auto rate() const -> double
+    {
+        return ( this->ppm - this->aging * RealTime::AGING_PPM ) * 1e-6;
+    }
+};
+
+// NTP a cada hora como no firmware, a hora de referência chega em qualquer fração de segundo
+static auto simulate( Clock& clock, hours length, uint32_t seed ) -> double
+{
+    auto drift = RealTime::Drift{};
+    auto random = std::mt19937{seed};
+    auto phase = std::uniform_real_distribution<double>{0.0, 1.0};
+    auto worst = 0.0;
+
+    auto reference = 1000.0;
+    clock.rtc = reference;
+    for ( auto hour = hours{0}; hour < length; hour++ )
+    {
+        const auto step = 3600.0 + phase( random );
+        reference += step;
+        clock.rtc += step * ( 1.0 + clock.rate() );
+        worst = std::max( worst, std::fabs( clock.rtc - reference ) );
+
+        // Mesma conta do trimRtc: a leitura inteira mais meio segundo contra a referência exata
+        const auto offset = duration_cast<steady_clock::duration>( duration<double>{ std::floor( clock.rtc ) + 0.5 - reference } );
+        const auto trim = drift.update( offset, steady_clock::time_point{ duration_cast<steady_clock::duration>( duration<double>{reference} ) } );
+
+        if ( trim.drift )
+        {
+            clock.aging = RealTime::aging( clock.aging, *trim.drift );
+            clock.updates++;
+        }
+        // Gravação alinhada na virada do segundo, a fase passa a ser a da referência
+        if ( trim.write )
+        {
+            clock.rtc = reference;
+        }
+    }
+    return worst;
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static void test_first_update_writes()
+{
+    auto drift = RealTime::Drift{};
+    const auto trim = drift.update( {}, steady_clock::time_point{} );
+    TEST_ASSERT_TRUE( trim.write );
+    TEST_ASSERT_FALSE( trim.drift.has_value() );
+}
+
+static void test_short_baseline_does_not_estimate()
+{
+    auto drift = RealTime::Drift{};
+    drift.update( {}, steady_clock::time_point{} );
+    const auto trim = drift.update( seconds{5}, steady_clock::time_point{ hours{23} } );
+    TEST_ASSERT_TRUE( trim.write );
+    TEST_ASSERT_FALSE( trim.drift.has_value() );
+}
+
+// Trims de 1 s não podem zerar a base: a 0,125 s/h o DS3231 é regravado a cada 8 h e em 24 h a conta ainda vê os 3 s
+static void test_trims_accumulate()
+{
+    auto drift = RealTime::Drift{};
+    drift.update( {}, steady_clock::time_point{} );
+
+    auto rtc = milliseconds{0};
+    for ( auto hour = 1; hour <= 24; hour++ )
+    {
+        rtc += milliseconds{125};
+        const auto trim = drift.update( rtc, steady_clock::time_point{ hours{hour} } );
+        TEST_ASSERT_EQUAL( hour % 8 == 0, trim.write );
+        TEST_ASSERT_EQUAL( hour == 24, trim.drift.has_value() );
+        if ( trim.drift )
+        {
+            TEST_ASSERT_FLOAT_WITHIN( 0.01f, 0.125f / 3600.0f * 1e6f, *trim.drift );
+        }
+        if ( trim.write )
+        {
+            rtc = {};
+        }
+    }
+}
+
+static void test_reset_starts_over()
+{
+    auto drift = RealTime::Drift{};
+    drift.update( {}, steady_clock::time_point{} );
+    drift.update( seconds{1}, steady_clock::time_point{ hours{12} } );
+    drift.reset( steady_clock::time_point{ hours{20} } );
+    TEST_ASSERT_FALSE( drift.update( seconds{1}, steady_clock::time_point{ hours{30} } ).drift.has_value() );
+}
+
+static void test_aging_clamps()
+{
+    TEST_ASSERT_EQUAL( 127, RealTime::aging( 120, 5.0f ) );
+    TEST_ASSERT_EQUAL( -128, RealTime::aging( -120, -5.0f ) );
+    TEST_ASSERT_EQUAL( 20, RealTime::aging( 0, 2.0f ) );
+}
+
+// Deriva típica do DS3231 fora da faixa de temperatura ideal: com o aging corrigido o resto fica abaixo de 0,5 ppm
+static void test_closed_loop_converges()
+{
+    for ( const auto ppm : { 2.5, -4.0, 8.0, -11.0 } )
+    {
+        for ( auto seed = 1u; seed <= 8; seed++ )
+        {
+            auto clock = Clock{ 0.0, ppm };
+            simulate( clock, hours{24 * 60}, seed );
+            TEST_ASSERT_GREATER_THAN( 0u, clock.updates );
+            TEST_ASSERT_FLOAT_WITHIN( 0.5, 0.0, clock.rate() * 1e6 );
+        }
+    }
+}
+
+// Entre dois sincronismos o DS3231 nunca se afasta mais que um trim e a deriva de uma hora
+static void test_offset_stays_bounded()
+{
+    auto clock = Clock{ 0.0, 8.0 };
+    const auto worst = simulate( clock, hours{24 * 30}, 3 );
+    TEST_ASSERT_LESS_THAN( 2.0, worst );
+}
+
+auto main() -> int
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_first_update_writes );
+    RUN_TEST( test_short_baseline_does_not_estimate );
+    RUN_TEST( test_trims_accumulate );
+    RUN_TEST( test_reset_starts_over );
+    RUN_TEST( test_aging_clamps );
+    RUN_TEST( test_closed_loop_converges );
+    RUN_TEST( test_offset_stays_bounded );
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,247 @@
+#include <Arduino.h>
+
+#include <FastCRC.h>
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+#include "Gzip.hpp"
+
+// Saída do Inflater, o sink é um ponteiro de função
+static std::vector<uint8_t> output = {};
+static bool accepting = true;
+
+static auto sink( const uint8_t* data, std::size_t length ) -> bool
+{
+    output.insert( output.end(), data, data + length );
+    return accepting;
+}
+
+// Entrega a entrada em pedaços de tamanho aleatório, de 1 byte até max
+static auto inflate( const std::vector<uint8_t>& compressed, std::mt19937& random, std::size_t max ) -> std::unique_ptr<Gzip::Inflater>
+{
+    output.clear();
+    auto inflater = std::make_unique<Gzip::Inflater>( sink );
+
+    auto size = std::uniform_int_distribution<std::size_t>{1, max};
+    for ( auto offset = std::size_t{0}; offset < compressed.size(); )
+    {
+        const auto length = std::min( size( random ), compressed.size() - offset );
+        if ( not inflater->write( compressed.data() + offset, length ) )
+        {
+            break;
+        }
+        offset += length;
+    }
+    return inflater;
+}
+
+static auto deflate( const std::vector<uint8_t>& data, std::mt19937& random ) -> std::vector<uint8_t>
+{
+    auto deflater = std::make_unique<Gzip::Deflater>();
+    auto size = std::uniform_int_distribution<std::size_t>{1, 3000};
+
+    for ( auto offset = std::size_t{0}; offset < data.size(); )
+    {
+        const auto length = std::min( size( random ), data.size() - offset );
+        deflater->write( data.data() + offset, length );
+        offset += length;
+    }
+    deflater->finish();
+
+    auto compressed = std::vector<uint8_t>{};
+    auto buffer = std::array<uint8_t, 700>{};
+    while ( not deflater->done() )
+    {
+        const auto length = deflater->read( buffer.data(), buffer.size() );
+        compressed.insert( compressed.end(), buffer.begin(), buffer.begin() + length );
+    }
+    return compressed;
+}
+
+// Texto parecido com o /data.csv, com repetições próximas e distantes
+static auto sample( std::size_t size, uint32_t seed ) -> std::vector<uint8_t>
+{
+    auto random = std::mt19937{seed};
+    auto data = std::vector<uint8_t>{};
+    while ( data.size() < size )
+    {
+        const auto line = "2024-05-0" + std::to_string( random() % 9 + 1 ) + " 12:" + std::to_string( random() % 60 ) + ";23." + std::to_string( random() % 10 ) + ";61;1013.2;12.3;Nordeste;Seco\r\n";
+        data.insert( data.end(), line.begin(), line.end() );
+        if ( random() % 50 == 0 )
+        {
+            data.push_back( static_cast<uint8_t>( random() ) );
+        }
+    }
+    data.resize( size );
+    return data;
+}
+
+// Blocos sem compressão montados à mão, maiores que a janela
+static auto stored( const std::vector<uint8_t>& data ) -> std::vector<uint8_t>
+{
+    auto stream = std::vector<uint8_t>{0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03};
+    for ( auto offset = std::size_t{0}; offset < data.size() or offset == 0; )
+    {
+        const auto length = static_cast<uint16_t>( std::min<std::size_t>( data.size() - offset, 65535 ) );
+        const auto last = offset + length == data.size();
+        stream.push_back( last ? 0x01 : 0x00 );
+        stream.push_back( length & 0xff );
+        stream.push_back( length >> 8 );
+        stream.push_back( ~length & 0xff );
+        stream.push_back( static_cast<uint16_t>( ~length ) >> 8 );
+        stream.insert( stream.end(), data.begin() + offset, data.begin() + offset + length );
+        offset += length;
+        if ( last )
+        {
+            break;
+        }
+    }
+
+    // O FastCRC recebe o tamanho em 16 bits, vai em partes
+    auto crc = FastCRC32{};
+    auto checksum = 0u;
+    for ( auto offset = std::size_t{0}; offset < data.size(); offset += 32768 )
+    {
+        const auto length = static_cast<uint16_t>( std::min<std::size_t>( data.size() - offset, 32768 ) );
+        checksum = offset == 0 ? crc.crc32( data.data(), length ) : crc.crc32_upd( data.data() + offset, length );
+    }
+    const auto size = static_cast<uint32_t>( data.size() );
+    for ( const auto value : { checksum, size } )
+    {
+        for ( auto i = 0; i < 4; ++i )
+        {
+            stream.push_back( static_cast<uint8_t>( value >> ( 8 * i ) ) );
+        }
+    }
+    return stream;
+}
+
+void setUp()
+{
+    accepting = true;
+}
+
+void tearDown()
+{
+}
+
+static auto test_round_trip_random_chunks() -> void
+{
+    auto random = std::mt19937{5};
+    const std::size_t sizes[] = {0, 1, 100, 4096, 70000, 300000};
+
+    for ( const auto size : sizes )
+    {
+        const auto data = sample( size, static_cast<uint32_t>( size ) );
+        const auto compressed = deflate( data, random );
+        TEST_ASSERT_TRUE( size < 4096 or compressed.size() < data.size() / 2 );
+
+        for ( const std::size_t max : {1, 7, 300, 5000} )
+        {
+            const auto inflater = inflate( compressed, random, max );
+            TEST_ASSERT_TRUE( inflater->done() );
+            TEST_ASSERT_EQUAL_UINT32( size, inflater->decompressed() );
+            TEST_ASSERT_TRUE( output == data );
+        }
+    }
+}
+
+// Gerado pelo gzip do Python (nível 9, janela de 32 KiB), códigos dinâmicos
+static auto test_foreign_stream() -> void
+{
+    static const uint8_t compressed[] = {
+        0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xed, 0xd0, 0x31, 0x0e, 0xc2, 0x30,
+        0x0c, 0x85, 0xe1, 0x9d, 0x53, 0xf8, 0x00, 0x95, 0x69, 0x12, 0x95, 0x01, 0x46, 0x94, 0x95, 0x01,
+        0x4e, 0x60, 0x25, 0x16, 0x2d, 0x10, 0x5c, 0x25, 0x4e, 0xcf, 0x4f, 0x8e, 0x41, 0xa5, 0x8c, 0x6f,
+        0x78, 0xff, 0xf0, 0xf9, 0xa2, 0x14, 0x48, 0x20, 0xb1, 0xb2, 0x64, 0xf9, 0xc8, 0x73, 0x09, 0x74,
+        0x06, 0xe5, 0xb4, 0x72, 0x26, 0xad, 0x99, 0xc0, 0x3a, 0x9c, 0x06, 0xa8, 0x69, 0x89, 0x14, 0x19,
+        0x4e, 0x66, 0x80, 0x35, 0x73, 0x29, 0xed, 0x64, 0x46, 0xe3, 0xd0, 0x5e, 0x60, 0xe3, 0xaf, 0xb6,
+        0x65, 0xd1, 0xc1, 0x3b, 0x1d, 0x67, 0xb8, 0x49, 0x8e, 0x5c, 0x94, 0x11, 0xfc, 0xae, 0xf3, 0xd7,
+        0xb9, 0x6e, 0x2d, 0xf7, 0xe0, 0x20, 0x08, 0x77, 0x7a, 0x51, 0x6c, 0xbd, 0x11, 0x0d, 0x1e, 0x7c,
+        0x67, 0xeb, 0x6c, 0x9d, 0xed, 0xbf, 0xd9, 0x7e, 0x9f, 0x3d, 0x11, 0x2a, 0xdc, 0x04, 0x00, 0x00,
+    };
+
+    auto line = std::string{};
+    for ( auto i = 0; i < 3; ++i )
+    {
+        line += "Estacao meteorologica: temperatura 23.5, umidade 61, pressao 1013.2; vento 12.3 km/h Nordeste. ";
+    }
+    line += "Chuva: Seco. Rajada 20.1.\n";
+    auto text = std::string{};
+    for ( auto i = 0; i < 4; ++i )
+    {
+        text += line;
+    }
+
+    auto random = std::mt19937{6};
+    for ( const std::size_t max : {1, 3, 50, 200} )
+    {
+        const auto inflater = inflate( std::vector<uint8_t>( std::begin( compressed ), std::end( compressed ) ), random, max );
+        TEST_ASSERT_TRUE( inflater->done() );
+        TEST_ASSERT_EQUAL( text.size(), output.size() );
+        TEST_ASSERT_EQUAL_MEMORY( text.data(), output.data(), text.size() );
+    }
+}
+
+static auto test_stored_blocks() -> void
+{
+    auto random = std::mt19937{7};
+    for ( const std::size_t size : {0, 10, 65535, 140000} )
+    {
+        const auto data = sample( size, 99 );
+        const auto inflater = inflate( stored( data ), random, 4000 );
+        TEST_ASSERT_TRUE( inflater->done() );
+        TEST_ASSERT_TRUE( output == data );
+    }
+}
+
+// Tamanho ou CRC errados no trailer reprovam a imagem
+static auto test_rejects_corruption() -> void
+{
+    auto random = std::mt19937{8};
+    const auto data = sample( 20000, 3 );
+    const auto compressed = deflate( data, random );
+
+    auto badCrc = compressed;
+    badCrc[badCrc.size() - 8] ^= 0x01;
+    TEST_ASSERT_FALSE( inflate( badCrc, random, 100 )->done() );
+
+    auto badSize = compressed;
+    badSize[badSize.size() - 1] ^= 0x80;
+    TEST_ASSERT_FALSE( inflate( badSize, random, 100 )->done() );
+
+    auto truncated = compressed;
+    truncated.resize( truncated.size() - 5 );
+    TEST_ASSERT_FALSE( inflate( truncated, random, 100 )->done() );
+
+    auto header = compressed;
+    header[2] = 0x07;
+    TEST_ASSERT_FALSE( inflate( header, random, 100 )->done() );
+}
+
+// O destino recusando (falha do Update.write) interrompe a descompressão
+static auto test_sink_failure_stops() -> void
+{
+    auto random = std::mt19937{9};
+    const auto compressed = deflate( sample( 100000, 4 ), random );
+
+    accepting = false;
+    const auto inflater = inflate( compressed, random, 1000 );
+    TEST_ASSERT_FALSE( inflater->done() );
+    TEST_ASSERT_TRUE( output.size() < 100000 );
+}
+
+auto main() -> int
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_round_trip_random_chunks );
+    RUN_TEST( test_foreign_stream );
+    RUN_TEST( test_stored_blocks );
+    RUN_TEST( test_rejects_corruption );
+    RUN_TEST( test_sink_failure_stops );
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include <Arduino.h>
+
+#include <WiFi.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <unity.h>
+
+#include "Configuration.hpp"
+#include "Link.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+static constexpr auto BSSID = std::array<uint8_t, 6>{0x02, 0x11, 0x22, 0x33, 0x44, 0x55};
+static constexpr auto CHANNEL = uint8_t{6};
+
+// Papel da tarefa do Wi-Fi: cada emit() cai no handler registrado pelo init()
+static auto associated() -> void
+{
+    auto info = arduino_event_info_t{};
+    info.wifi_sta_connected.channel = CHANNEL;
+    std::copy( BSSID.begin(), BSSID.end(), info.wifi_sta_connected.bssid );
+    WiFi.emit( ARDUINO_EVENT_WIFI_STA_CONNECTED, info );
+}
+
+static auto gotIp() -> void
+{
+    WiFi.emit( ARDUINO_EVENT_WIFI_STA_GOT_IP, arduino_event_info_t{} );
+}
+
+static auto lost( uint8_t reason ) -> void
+{
+    auto info = arduino_event_info_t{};
+    info.wifi_sta_disconnected.reason = reason;
+    WiFi.emit( ARDUINO_EVENT_WIFI_STA_DISCONNECTED, info );
+}
+
+static auto online() -> void
+{
+    associated();
+    gotIp();
+    Link::process();
+}
+
+// Roda o loop até sair do BACKOFF e devolve quanto tempo levou
+static auto retry() -> int
+{
+    const auto begin = Clock::now();
+    while ( Link::state() == Link::State::BACKOFF and Clock::now() - begin < std::chrono::seconds( 5 ) )
+    {
+        Link::process();
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    return static_cast<int>( std::chrono::duration_cast<std::chrono::milliseconds>( Clock::now() - begin ).count() );
+}
+
+auto setUp() -> void
+{
+}
+
+auto tearDown() -> void
+{
+}
+
+static auto test_idle_ignores_events() -> void
+{
+    Link::stop();
+    const auto before = WiFi.attempt.count;
+
+    online();
+    lost( WIFI_REASON_BEACON_TIMEOUT );
+    Link::process();
+
+    TEST_ASSERT_TRUE( Link::state() == Link::State::IDLE );
+    TEST_ASSERT_EQUAL_UINT32( before, WiFi.attempt.count );
+}
+
+static auto test_first_connect_scans() -> void
+{
+    Link::stop();
+    const auto before = WiFi.attempt.count;
+
+    Link::start();
+    TEST_ASSERT_TRUE( Link::state() == Link::State::CONNECTING );
+    TEST_ASSERT_EQUAL_UINT32( before + 1, WiFi.attempt.count );
+    TEST_ASSERT_EQUAL_INT( 0, WiFi.attempt.channel );
+
+    // Associação sozinha ainda não é conexão
+    associated();
+    Link::process();
+    TEST_ASSERT_TRUE( Link::state() == Link::State::CONNECTING );
+
+    gotIp();
+    Link::process();
+    TEST_ASSERT_TRUE( Link::state() == Link::State::CONNECTED );
+}
+
+static auto test_reconnect_uses_cache() -> void
+{
+    Link::stop();
+    Link::start();
+    online();
+    const auto before = WiFi.attempt.count;
+
+    lost( WIFI_REASON_BEACON_TIMEOUT );
+    Link::process();
+
+    TEST_ASSERT_TRUE( Link::state() == Link::State::CONNECTING );
+    TEST_ASSERT_EQUAL_UINT32( before + 1, WiFi.attempt.count );
+    TEST_ASSERT_EQUAL_INT( CHANNEL, WiFi.attempt.channel );
+    TEST_ASSERT_EQUAL_MEMORY( BSSID.data(), WiFi.attempt.bssid.data(), BSSID.size() );
+
+    online();
+    TEST_ASSERT_TRUE( Link::state() == Link::State::CONNECTED );
+}
+
+static auto test_assoc_leave_is_not_a_loss() -> void
+{
+    Link::stop();
+    Link::start();
+    online();
+    const auto before = WiFi.attempt.count;
+
+    lost( WIFI_REASON_ASSOC_LEAVE );
+    Link::process();
+
+    TEST_ASSERT_TRUE( Link::state() == Link::State::CONNECTED );
+    TEST_ASSERT_EQUAL_UINT32( before, WiFi.attempt.count );
+}
+
+static auto test_backoff_grows_and_rescans() -> void
+{
+    Link::stop();
+    Link::start();
+    online();
+
+    // Queda leva a CONNECTING, a falha dessa tentativa é que entra em BACKOFF
+    lost( WIFI_REASON_BEACON_TIMEOUT );
+    Link::process();
+    TEST_ASSERT_TRUE( Link::state() == Link::State::CONNECTING );
+
+    // Teto dobra a cada falha a partir de 250 ms, a espera fica entre metade e o teto
+    const auto ceilings = std::array<int, 3>{250, 500, 1000};
+    for ( auto failure = std::size_t{0}; failure < ceilings.size(); failure++ )
+    {
+        lost( WIFI_REASON_NO_AP_FOUND );
+        Link::process();
+        TEST_ASSERT_TRUE( Link::state() == Link::State::BACKOFF );
+
+        const auto before = WiFi.attempt.count;
+        const auto waited = retry();
+
+        TEST_ASSERT_TRUE( Link::state() == Link::State::CONNECTING );
+        TEST_ASSERT_EQUAL_UINT32( before + 1, WiFi.attempt.count );
+        TEST_ASSERT_GREATER_OR_EQUAL( ceilings[failure] / 2, waited );
+        TEST_ASSERT_LESS_OR_EQUAL( ceilings[failure] + 100, waited );
+
+        // A cada SCAN_EVERY tentativas uma varre todos os canais
+        const auto scan = failure + 1 == 3;
+        TEST_ASSERT_EQUAL_INT( scan ? 0 : CHANNEL, WiFi.attempt.channel );
+    }
+
+    online();
+    TEST_ASSERT_TRUE( Link::state() == Link::State::CONNECTED );
+
+    // Sucesso zera as falhas, a próxima espera volta ao mínimo
+    lost( WIFI_REASON_BEACON_TIMEOUT );
+    Link::process();
+    lost( WIFI_REASON_NO_AP_FOUND );
+    Link::process();
+    TEST_ASSERT_LESS_OR_EQUAL( 350, retry() );
+}
+
+static auto test_stop_from_backoff() -> void
+{
+    Link::stop();
+    Link::start();
+    lost( WIFI_REASON_AUTH_FAIL );
+    Link::process();
+    TEST_ASSERT_TRUE( Link::state() == Link::State::BACKOFF );
+
+    Link::stop();
+    TEST_ASSERT_TRUE( Link::state() == Link::State::IDLE );
+
+    // Eventos atrasados da tentativa anterior não religam
+    const auto before = WiFi.attempt.count;
+    std::this_thread::sleep_for( std::chrono::milliseconds( 300 ) );
+    online();
+    TEST_ASSERT_TRUE( Link::state() == Link::State::IDLE );
+    TEST_ASSERT_EQUAL_UINT32( before, WiFi.attempt.count );
+}
+
+auto main() -> int
+{
+    Configuration::init();
+    Link::init();
+
+    UNITY_BEGIN();
+    RUN_TEST( test_idle_ignores_events );
+    RUN_TEST( test_first_connect_scans );
+    RUN_TEST( test_reconnect_uses_cache );
+    RUN_TEST( test_assoc_leave_is_not_a_loss );
+    RUN_TEST( test_backoff_grows_and_rescans );
+    RUN_TEST( test_stop_from_backoff );
+    return UNITY_END();
+}
\ No newline at end of file
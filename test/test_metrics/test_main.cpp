@@ -0,0 +1,294 @@
+#include <Arduino.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unity.h>
+#include <vector>
+
+#include "Metrics.hpp"
+#include "WebInterface.hpp"
+
+using namespace std::chrono;
+
+// Substituto do AsyncWebServerRequest: o onDisconnect roda quando a conexão fecha, como no destrutor da biblioteca
+class Request
+{
+    private:
+        std::function<void()> disconnect = {};
+    public:
+        int status = 0;
+        bool partial = false;
+
+        auto onDisconnect( std::function<void()> handler ) -> void
+        {
+            this->disconnect = std::move( handler );
+        }
+
+        auto send( int code ) -> void
+        {
+            this->status = code;
+        }
+
+        ~Request()
+        {
+            if ( this->disconnect )
+            {
+                this->disconnect();
+            }
+        }
+};
+
+using Handler = std::function<void( Request* )>;
+
+static auto tracked( const char* name, Handler handler ) -> Handler
+{
+    const auto route = Metrics::route( name );
+    return [route, handler]( Request* request )
+    {
+        Metrics::track( route, request );
+        handler( request );
+    };
+}
+
+// Substituto do servidor: respostas em partes terminam depois, na tarefa do "async_tcp"
+class Server
+{
+    private:
+        std::map<std::string, Handler> routes = {};
+        std::mutex mutex = {};
+        std::condition_variable ready = {};
+        std::deque<Request*> sending = {};
+        bool stopping = false;
+        std::thread tcp;
+
+        auto run() -> void
+        {
+            auto lock = std::unique_lock<std::mutex>{this->mutex};
+            while ( true )
+            {
+                this->ready.wait( lock, [this] { return this->stopping or not this->sending.empty(); } );
+                if ( this->sending.empty() )
+                {
+                    return;
+                }
+                const auto request = this->sending.front();
+                this->sending.pop_front();
+                lock.unlock();
+                std::this_thread::sleep_for( microseconds{50} );
+                delete request;
+                lock.lock();
+            }
+        }
+    public:
+        Server() : tcp{ [this] { this->run(); } } {}
+
+        ~Server()
+        {
+            {
+                const auto lock = std::lock_guard<std::mutex>{this->mutex};
+                this->stopping = true;
+            }
+            this->ready.notify_all();
+            this->tcp.join();
+        }
+
+        auto on( const std::string& path, const char* name, Handler handler ) -> void
+        {
+            this->routes[path] = tracked( name, handler );
+        }
+
+        auto dispatch( const std::string& path ) -> int
+        {
+            auto request = new Request{};
+            const auto found = this->routes.find( path );
+            if ( found == this->routes.end() )
+            {
+                request->send( 404 );
+            }
+            else
+            {
+                found->second( request );
+            }
+
+            const auto status = request->status;
+            if ( request->partial )
+            {
+                {
+                    const auto lock = std::lock_guard<std::mutex>{this->mutex};
+                    this->sending.push_back( request );
+                }
+                this->ready.notify_one();
+            }
+            else
+            {
+                delete request;
+            }
+            return status;
+        }
+};
+
+// Substituto do AsyncWebSocket com uma fila por cliente
+struct Sockets
+{
+    static constexpr auto QUEUE = 4u;
+
+    std::mutex mutex = {};
+    std::map<uint32_t, uint32_t> queued = {};
+    std::map<uint32_t, uint32_t> received = {};
+
+    auto availableForWrite( uint32_t id ) -> bool
+    {
+        const auto lock = std::lock_guard<std::mutex>{this->mutex};
+        return this->queued[id] < QUEUE;
+    }
+
+    auto text( uint32_t id, const char*, std::size_t ) -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{this->mutex};
+        this->queued[id] += 1;
+        this->received[id] += 1;
+    }
+
+    auto drain( uint32_t id ) -> void
+    {
+        const auto lock = std::lock_guard<std::mutex>{this->mutex};
+        this->queued[id] = 0;
+    }
+};
+
+static auto _before = Metrics::Totals{};
+
+void setUp()
+{
+    _before = Metrics::totals();
+}
+
+void tearDown()
+{
+}
+
+static auto test_request_counts_until_disconnect() -> void
+{
+    const auto route = Metrics::route( "GET /single" );
+    auto request = new Request{};
+    Metrics::track( route, request );
+
+    auto totals = Metrics::totals();
+    TEST_ASSERT_EQUAL_UINT32( _before.active + 1, totals.active );
+    TEST_ASSERT_EQUAL_UINT32( _before.requests, totals.requests );
+
+    delete request;
+    totals = Metrics::totals();
+    TEST_ASSERT_EQUAL_UINT32( _before.active, totals.active );
+    TEST_ASSERT_EQUAL_UINT32( _before.requests + 1, totals.requests );
+}
+
+static auto test_slow_client_does_not_block_others() -> void
+{
+    const uint32_t ids[] = {1, 2, 3};
+    auto sockets = Sockets{};
+    const auto text = "{}";
+
+    // O cliente 2 nunca esvazia a fila, os outros leem a cada envio
+    for ( auto tick = 0u; tick < 10; ++tick )
+    {
+        const auto delivery = WebInterface::broadcast( sockets, ids, 3, text, 2 );
+        Metrics::websocket( 3, delivery.delivered, delivery.dropped );
+        sockets.drain( 1 );
+        sockets.drain( 3 );
+    }
+
+    TEST_ASSERT_EQUAL_UINT32( 10, sockets.received[1] );
+    TEST_ASSERT_EQUAL_UINT32( Sockets::QUEUE, sockets.received[2] );
+    TEST_ASSERT_EQUAL_UINT32( 10, sockets.received[3] );
+
+    const auto totals = Metrics::totals();
+    TEST_ASSERT_EQUAL_UINT32( _before.delivered + 20 + Sockets::QUEUE, totals.delivered );
+    TEST_ASSERT_EQUAL_UINT32( _before.dropped + 10 - Sockets::QUEUE, totals.dropped );
+}
+
+// Carga: vários clientes em paralelo, metade das respostas em partes, com o WebSocket enviando ao mesmo tempo
+static auto test_load() -> void
+{
+    static constexpr auto CLIENTS = 8u;
+    static constexpr auto REQUESTS = 2000u;
+    static constexpr auto SOCKETS = 5u;
+
+    auto completed = std::atomic<uint32_t>{0};
+    auto ticks = std::atomic<uint32_t>{0};
+    auto running = std::atomic<bool>{true};
+    const auto start = steady_clock::now();
+    {
+        auto server = Server{};
+        server.on( "/a", "GET /a", []( Request* request ) { request->send( 200 ); } );
+        server.on( "/b", "GET /b", []( Request* request ) { request->partial = true; request->send( 200 ); } );
+        server.on( "/c", "GET /c", []( Request* request ) { std::this_thread::sleep_for( microseconds{20} ); request->send( 200 ); } );
+
+        auto sockets = Sockets{};
+        auto broadcaster = std::thread{ [&]
+        {
+            const uint32_t ids[SOCKETS] = {1, 2, 3, 4, 5};
+            while ( running )
+            {
+                const auto delivery = WebInterface::broadcast( sockets, ids, SOCKETS, "{}", 2 );
+                Metrics::websocket( SOCKETS, delivery.delivered, delivery.dropped );
+                ticks += 1;
+                // Só os clientes ímpares acompanham
+                sockets.drain( 1 );
+                sockets.drain( 3 );
+                sockets.drain( 5 );
+                std::this_thread::sleep_for( microseconds{100} );
+            }
+        } };
+
+        auto clients = std::vector<std::thread>{};
+        for ( auto client = 0u; client < CLIENTS; ++client )
+        {
+            clients.emplace_back( [&, client]
+            {
+                const char* paths[] = {"/a", "/b", "/c", "/missing"};
+                for ( auto i = 0u; i < REQUESTS; ++i )
+                {
+                    const auto status = server.dispatch( paths[( i + client ) % 4] );
+                    completed += status == 200 ? 1 : 0;
+                }
+            } );
+        }
+        for ( auto& client : clients )
+        {
+            client.join();
+        }
+        running = false;
+        broadcaster.join();
+    }
+    const auto elapsed = duration_cast<milliseconds>( steady_clock::now() - start ).count();
+
+    // O servidor só termina depois de fechar as respostas em partes
+    const auto totals = Metrics::totals();
+    TEST_ASSERT_EQUAL_UINT32( CLIENTS * REQUESTS * 3 / 4, completed.load() );
+    TEST_ASSERT_EQUAL_UINT32( _before.requests + completed, totals.requests );
+    TEST_ASSERT_EQUAL_UINT32( 0, totals.active );
+    TEST_ASSERT_TRUE( totals.peak >= 1 );
+    TEST_ASSERT_EQUAL_UINT32( ticks * SOCKETS, ( totals.delivered - _before.delivered ) + ( totals.dropped - _before.dropped ) );
+    TEST_ASSERT_TRUE( totals.delivered - _before.delivered >= ticks * 3 );
+
+    std::printf( "load: %u requests in %lld ms, peak %u active, %u websocket ticks\n",
+                 completed.load(), static_cast<long long>( elapsed ), totals.peak, ticks.load() );
+}
+
+auto main() -> int
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_request_counts_until_disconnect );
+    RUN_TEST( test_slow_client_does_not_block_others );
+    RUN_TEST( test_load );
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include <Arduino.h>
+
+#include <cstdint>
+#include <unity.h>
+
+#include "Pool.hpp"
+
+struct Item
+{
+    int value;
+
+    explicit Item( int value ) : value{ value } {}
+};
+
+auto setUp() -> void
+{
+}
+
+auto tearDown() -> void
+{
+}
+
+static auto test_fixed_exhausts_and_recycles() -> void
+{
+    auto pool = Pool::Fixed<Item, 2>{"items"};
+
+    auto first = pool.acquire( 1 );
+    auto second = pool.acquire( 2 );
+    TEST_ASSERT_TRUE( static_cast<bool>( first ) );
+    TEST_ASSERT_TRUE( static_cast<bool>( second ) );
+    TEST_ASSERT_FALSE( static_cast<bool>( pool.acquire( 3 ) ) );
+
+    // Cópia segura o objeto, o slot só volta com a última referência
+    auto copy = first;
+    first = {};
+    TEST_ASSERT_FALSE( static_cast<bool>( pool.acquire( 4 ) ) );
+    copy = {};
+
+    auto third = pool.acquire( 5 );
+    TEST_ASSERT_TRUE( static_cast<bool>( third ) );
+    TEST_ASSERT_EQUAL_INT( 5, third->value );
+    TEST_ASSERT_EQUAL_INT( 2, second->value );
+}
+
+static auto test_fixed_frees_idle_slots() -> void
+{
+    auto pool = Pool::Fixed<Item, 2>{"idle"};
+    TEST_ASSERT_EQUAL_INT( 0, pool.snapshot().bytes );
+
+    auto first = pool.acquire( 1 );
+    auto second = pool.acquire( 2 );
+    TEST_ASSERT_GREATER_OR_EQUAL( 2 * sizeof( Item ), pool.snapshot().bytes );
+
+    // Enquanto houver um objeto vivo a reserva fica
+    first = {};
+    TEST_ASSERT_EQUAL_INT( 1, pool.snapshot().used );
+    TEST_ASSERT_GREATER_OR_EQUAL( 2 * sizeof( Item ), pool.snapshot().bytes );
+
+    second = {};
+    const auto stats = pool.snapshot();
+    TEST_ASSERT_EQUAL_INT( 0, stats.used );
+    TEST_ASSERT_EQUAL_INT( 0, stats.bytes );
+    TEST_ASSERT_EQUAL_INT( 2, stats.peak );
+    TEST_ASSERT_EQUAL_INT( 2, stats.acquired );
+
+    // Volta a reservar no próximo uso
+    auto third = pool.acquire( 3 );
+    TEST_ASSERT_TRUE( static_cast<bool>( third ) );
+    TEST_ASSERT_EQUAL_INT( 3, third->value );
+}
+
+static auto test_arena_grows_only_last_block() -> void
+{
+    auto arena = Pool::Arena<256>{};
+
+    auto* first = arena.allocate( 32 );
+    auto* second = arena.allocate( 32 );
+    TEST_ASSERT_NOT_NULL( first );
+    TEST_ASSERT_NOT_NULL( second );
+
+    // Bloco do meio diminui no lugar mas não cresce sobre o vizinho
+    TEST_ASSERT_TRUE( arena.reallocate( first, 16 ) == first );
+    TEST_ASSERT_TRUE( arena.reallocate( first, 16 ) == first );
+    TEST_ASSERT_NULL( arena.reallocate( first, 33 ) );
+
+    // O último cresce até o fim da região e não passa dele
+    TEST_ASSERT_TRUE( arena.reallocate( second, 128 ) == second );
+    TEST_ASSERT_NULL( arena.reallocate( second, 256 ) );
+    TEST_ASSERT_TRUE( arena.reallocate( second, 8 ) == second );
+
+    // Diminuir o último devolve o espaço para a próxima alocação
+    auto* third = arena.allocate( 128 );
+    TEST_ASSERT_NOT_NULL( third );
+    TEST_ASSERT_NULL( arena.allocate( 128 ) );
+}
+
+static auto test_allocator_reallocate() -> void
+{
+    auto arena = Pool::Arena<128>{};
+    auto allocator = Pool::Allocator<Pool::Arena<128>>{&arena};
+
+    auto* block = allocator.allocate( 64 );
+    TEST_ASSERT_NOT_NULL( block );
+    TEST_ASSERT_NULL( allocator.reallocate( block, 1024 ) );
+    TEST_ASSERT_TRUE( allocator.reallocate( block, 48 ) == block );
+}
+
+auto main() -> int
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_fixed_exhausts_and_recycles );
+    RUN_TEST( test_fixed_frees_idle_slots );
+    RUN_TEST( test_arena_grows_only_last_block );
+    RUN_TEST( test_allocator_reallocate );
+    return UNITY_END();
+}
\ No newline at end of file
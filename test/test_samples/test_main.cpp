@@ -0,0 +1,138 @@
+#include <Arduino.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <unity.h>
+#include <vector>
+
+#include "Configuration.hpp"
+#include "Utils.hpp"
+
+// Referências por ordenação completa, o que o nth_element tem de reproduzir
+static auto sortedMedian( std::vector<uint16_t> samples ) -> uint16_t
+{
+    if ( samples.empty() )
+    {
+        return 0;
+    }
+    std::sort( samples.begin(), samples.end() );
+    return samples[samples.size() / 2];
+}
+
+static auto sortedTrimmedMean( std::vector<uint16_t> samples, float trim ) -> uint16_t
+{
+    const auto cut = static_cast<std::size_t>( samples.size() * trim );
+    if ( cut * 2 >= samples.size() )
+    {
+        return sortedMedian( samples );
+    }
+    std::sort( samples.begin(), samples.end() );
+    const auto sum = std::accumulate( samples.begin() + cut, samples.end() - cut, uint32_t{0} );
+    const auto count = static_cast<uint32_t>( samples.size() - 2 * cut );
+    return static_cast<uint16_t>( ( sum + count / 2 ) / count );
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static auto test_median_small() -> void
+{
+    auto empty = std::vector<uint16_t>{};
+    TEST_ASSERT_EQUAL_UINT32( 0, Utils::Samples::median( empty ) );
+
+    auto one = std::vector<uint16_t>{42};
+    TEST_ASSERT_EQUAL_UINT32( 42, Utils::Samples::median( one ) );
+
+    auto odd = std::vector<uint16_t>{9, 1, 5};
+    TEST_ASSERT_EQUAL_UINT32( 5, Utils::Samples::median( odd ) );
+
+    // Com quantidade par fica o maior dos dois centrais
+    auto even = std::vector<uint16_t>{4, 1, 3, 2};
+    TEST_ASSERT_EQUAL_UINT32( 3, Utils::Samples::median( even ) );
+}
+
+static auto test_trimmed_mean_rounds() -> void
+{
+    auto samples = std::vector<uint16_t>{1, 2, 2, 3};
+    TEST_ASSERT_EQUAL_UINT32( 2, Utils::Samples::trimmedMean( samples, 0.0f ) );
+
+    auto half = std::vector<uint16_t>{1, 2};
+    TEST_ASSERT_EQUAL_UINT32( 2, Utils::Samples::trimmedMean( half, 0.0f ) );
+}
+
+// Corte de metade ou mais cai na mediana
+static auto test_trimmed_mean_degenerates_to_median() -> void
+{
+    auto samples = std::vector<uint16_t>{7, 100, 3, 50};
+    TEST_ASSERT_EQUAL_UINT32( sortedMedian( samples ), Utils::Samples::trimmedMean( samples, 0.5f ) );
+
+    auto empty = std::vector<uint16_t>{};
+    TEST_ASSERT_EQUAL_UINT32( 0, Utils::Samples::trimmedMean( empty, 0.1f ) );
+}
+
+// Picos do ADC nos extremos não mexem no resultado
+static auto test_rejects_spikes() -> void
+{
+    auto random = std::mt19937{1};
+    auto noise = std::uniform_int_distribution<int>{-8, 8};
+
+    auto samples = std::vector<uint16_t>{};
+    for ( auto i = 0; i < 256; ++i )
+    {
+        samples.push_back( static_cast<uint16_t>( 2048 + noise( random ) ) );
+    }
+    for ( auto i = 0; i < 20; ++i )
+    {
+        samples[i * 12] = i % 2 == 0 ? 0 : 4095;
+    }
+
+    auto copy = samples;
+    const auto median = Utils::Samples::median( copy );
+    copy = samples;
+    const auto mean = Utils::Samples::trimmedMean( copy, 0.1f );
+
+    TEST_ASSERT_TRUE( median >= 2040 and median <= 2056 );
+    TEST_ASSERT_TRUE( mean >= 2040 and mean <= 2056 );
+}
+
+static auto test_matches_sorted_reference() -> void
+{
+    auto random = std::mt19937{2};
+    auto value = std::uniform_int_distribution<int>{0, 4095};
+    const float trims[] = {0.0f, 0.05f, 0.1f, 0.25f, 0.49f};
+
+    for ( auto size = 1u; size <= 300; ++size )
+    {
+        auto samples = std::vector<uint16_t>( size );
+        for ( auto& sample : samples )
+        {
+            sample = static_cast<uint16_t>( value( random ) );
+        }
+
+        auto copy = samples;
+        TEST_ASSERT_EQUAL_UINT32( sortedMedian( samples ), Utils::Samples::median( copy ) );
+
+        for ( const auto trim : trims )
+        {
+            copy = samples;
+            TEST_ASSERT_EQUAL_UINT32( sortedTrimmedMean( samples, trim ), Utils::Samples::trimmedMean( copy, trim ) );
+        }
+    }
+}
+
+auto main() -> int
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_median_small );
+    RUN_TEST( test_trimmed_mean_rounds );
+    RUN_TEST( test_trimmed_mean_degenerates_to_median );
+    RUN_TEST( test_rejects_spikes );
+    RUN_TEST( test_matches_sorted_reference );
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+#include <Arduino.h>
+
+#include <ctime>
+#include <limits>
+#include <random>
+#include <unity.h>
+#include <vector>
+
+#include "Sleep.hpp"
+
+static constexpr auto INTERVAL = std::time_t{60};
+static constexpr auto WINDOW = std::time_t{900};
+
+struct Sample
+{
+    std::time_t dateTime;
+    uint32_t sequence;
+};
+
+struct Record
+{
+    std::time_t window;
+    std::vector<Sample> samples;
+};
+
+static auto windowOf( const Sample& sample ) -> std::time_t
+{
+    return sample.dateTime - sample.dateTime % WINDOW;
+}
+
+// Cartão simulado: grava enquanto available
+struct Card
+{
+    bool available = true;
+    std::vector<Record> records = {};
+
+    auto flush( std::time_t window, const Sample* samples, std::size_t count ) -> bool
+    {
+        if ( not this->available )
+        {
+            return false;
+        }
+        this->records.push_back( Record{ window, std::vector<Sample>( samples, samples + count ) } );
+        return true;
+    }
+};
+
+template<std::size_t N>
+static auto push( Sleep::Batch<Sample, N>& batch, Card& card, const Sample& sample ) -> std::size_t
+{
+    return batch.push( sample, windowOf, [&card]( std::time_t window, const Sample* samples, std::size_t count ) { return card.flush( window, samples, count ); } );
+}
+
+static auto check( const Card& card ) -> void
+{
+    for ( const auto& record : card.records )
+    {
+        for ( const auto& sample : record.samples )
+        {
+            TEST_ASSERT_EQUAL_INT64( record.window, windowOf( sample ) );
+        }
+    }
+}
+
+void setUp()
+{
+}
+
+void tearDown()
+{
+}
+
+static auto test_failed_flush_keeps_windows_apart() -> void
+{
+    auto batch = Sleep::Batch<Sample, 96>{};
+    auto card = Card{};
+    auto sequence = 0u;
+
+    // Cartão fora durante três janelas inteiras
+    card.available = false;
+    for ( auto dateTime = std::time_t{0}; dateTime < 3 * WINDOW; dateTime += INTERVAL )
+    {
+        TEST_ASSERT_EQUAL( 0u, push( batch, card, Sample{ dateTime, sequence++ } ) );
+    }
+    TEST_ASSERT_EQUAL( 0u, card.records.size() );
+
+    card.available = true;
+    push( batch, card, Sample{ 3 * WINDOW, sequence++ } );
+
+    TEST_ASSERT_EQUAL( 3u, card.records.size() );
+    for ( auto i = 0u; i < 3; ++i )
+    {
+        TEST_ASSERT_EQUAL_INT64( i * WINDOW, card.records[i].window );
+        TEST_ASSERT_EQUAL( static_cast<std::size_t>( WINDOW / INTERVAL ), card.records[i].samples.size() );
+    }
+    TEST_ASSERT_EQUAL( 1u, batch.size() );
+    check( card );
+}
+
+static auto test_full_batch_drops_only_oldest_window() -> void
+{
+    auto batch = Sleep::Batch<Sample, 20>{};
+    auto card = Card{};
+    auto sequence = 0u;
+    auto discarded = std::size_t{0};
+
+    card.available = false;
+    for ( auto dateTime = std::time_t{0}; dateTime < 2 * WINDOW + 5 * INTERVAL; dateTime += INTERVAL )
+    {
+        discarded += push( batch, card, Sample{ dateTime, sequence++ } );
+    }
+
+    // 35 amostras em 20 lugares: a primeira janela (15) saiu inteira, a segunda ficou
+    TEST_ASSERT_EQUAL( 15u, discarded );
+    TEST_ASSERT_EQUAL( 20u, batch.size() );
+    TEST_ASSERT_EQUAL_INT64( WINDOW, batch.front( windowOf ).first );
+    TEST_ASSERT_EQUAL( 15u, batch.front( windowOf ).second );
+    TEST_ASSERT_EQUAL_UINT32( 15, batch.data()[0].sequence );
+}
+
+// Ciclos de acordar e dormir com o cartão falhando ao acaso: toda amostra acaba num registro da sua janela
+static auto test_wake_sleep_keeps_every_sample() -> void
+{
+    auto batch = Sleep::Batch<Sample, 96>{};
+    auto card = Card{};
+    auto random = std::mt19937{7};
+    auto failure = std::bernoulli_distribution{0.3};
+    auto sequence = 0u;
+    auto discarded = std::size_t{0};
+
+    for ( auto dateTime = std::time_t{0}; dateTime < 7 * 86400; dateTime += INTERVAL )
+    {
+        card.available = not failure( random );
+        discarded += push( batch, card, Sample{ dateTime, sequence++ } );
+    }
+    card.available = true;
+    batch.drain( std::numeric_limits<std::time_t>::max(), windowOf, [&card]( std::time_t window, const Sample* samples, std::size_t count ) { return card.flush( window, samples, count ); } );
+
+    TEST_ASSERT_EQUAL( 0u, discarded );
+    TEST_ASSERT_EQUAL( 0u, batch.size() );
+    TEST_ASSERT_EQUAL( static_cast<std::size_t>( 7 * 86400 / WINDOW ), card.records.size() );
+    check( card );
+
+    auto expected = 0u;
+    for ( const auto& record : card.records )
+    {
+        for ( const auto& sample : record.samples )
+        {
+            TEST_ASSERT_EQUAL_UINT32( expected++, sample.sequence );
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32( sequence, expected );
+}
+
+auto main() -> int
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_failed_flush_keeps_windows_apart );
+    RUN_TEST( test_full_batch_drops_only_oldest_window );
+    RUN_TEST( test_wake_sleep_keeps_every_sample );
+    return UNITY_END();
+}
\ No newline at end of file
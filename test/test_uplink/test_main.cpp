@@ -0,0 +1,170 @@
+#include <Arduino.h>
+
+#include <ctime>
+#include <filesystem>
+#include <sqlite3.h>
+#include <unity.h>
+#include <vector>
+
+#include "Configuration.hpp"
+#include "Database.hpp"
+
+static constexpr auto BASE = std::time_t{1700000000};
+static constexpr auto LEGACY = BASE - 86400;
+
+static auto sample( std::time_t dateTime ) -> Infos::SensorData
+{
+    auto sensorData = Infos::SensorData{};
+    sensorData.dateTime = dateTime;
+    sensorData.temperature = 20.0f;
+    return sensorData;
+}
+
+// Lê o que sairia no próximo lote e devolve a marca depois dele
+static auto drain( Database::Uplink::Mark mark, std::vector<std::time_t>& sent ) -> Database::Uplink::Mark
+{
+    Database::Uplink::collect( mark, 64, [&]( int64_t sequence, const Infos::SensorData& sensorData )
+    {
+        sent.push_back( sensorData.dateTime );
+        mark = { sequence, std::max( mark.dateTime, sensorData.dateTime ) };
+        return true;
+    } );
+    return mark;
+}
+
+// Banco de uma versão anterior: DATE_TIME como chave, marca do uplink no ROWID
+static auto legacy() -> void
+{
+    sqlite3* db = nullptr;
+    sqlite3_open( DATABASE_ROOT "/sensors_data.db", &db );
+    const auto command = " CREATE TABLE SENSORS_DATA ( DATE_TIME DATETIME PRIMARY KEY, TEMPERATURE NUMERIC, HUMIDITY NUMERIC,     "
+                         "     PRESSURE NUMERIC, WIND_SPEED NUMERIC, WIND_DIRECTION INTEGER, RAIN_INTENSITY INTEGER );           "
+                         " CREATE TABLE UPLINK_STATE ( ID INTEGER PRIMARY KEY, MARK DATETIME );                                 "
+                         " INSERT INTO SENSORS_DATA ( DATE_TIME, TEMPERATURE ) VALUES ( 1699913600, 1 ), ( 1699915400, 2 ); "
+                         " INSERT INTO SENSORS_DATA ( DATE_TIME, TEMPERATURE ) VALUES ( 1699914500, 3 );                      "
+                         " INSERT INTO UPLINK_STATE ( ID, MARK ) VALUES ( 0, 1699915400 );                                    "
+                         " ALTER TABLE UPLINK_STATE ADD COLUMN SEQUENCE INTEGER;                                              "
+                         " UPDATE UPLINK_STATE SET SEQUENCE = 2;                                                              ";
+    sqlite3_exec( db, command, nullptr, nullptr, nullptr );
+    sqlite3_close( db );
+}
+
+auto setUp() -> void
+{
+}
+
+auto tearDown() -> void
+{
+}
+
+// Os dois primeiros já tinham saído, o atrasado (ROWID 3, hora anterior à marca) continua pendente
+static auto test_legacy_mark_migrated() -> void
+{
+    auto mark = Database::Uplink::mark();
+    TEST_ASSERT_EQUAL_INT( 2, static_cast<int>( mark.sequence ) );
+    TEST_ASSERT_EQUAL_UINT32( 1, Database::Uplink::pending( mark ) );
+
+    auto sent = std::vector<std::time_t>{};
+    mark = drain( mark, sent );
+    TEST_ASSERT_EQUAL_UINT32( 1, sent.size() );
+    TEST_ASSERT_TRUE( sent[0] == LEGACY + 900 );
+    Database::Uplink::advance( mark );
+}
+
+static auto test_late_rows_are_sent() -> void
+{
+    auto mark = Database::Uplink::mark();
+    TEST_ASSERT_EQUAL_UINT32( 0, Database::Uplink::pending( mark ) );
+
+    for ( auto i = 0; i < 3; i++ )
+    {
+        Database::insert( sample( BASE + i * 900 ) );
+    }
+
+    auto sent = std::vector<std::time_t>{};
+    mark = drain( mark, sent );
+    Database::Uplink::advance( mark );
+    TEST_ASSERT_EQUAL_UINT32( 3, sent.size() );
+    TEST_ASSERT_EQUAL_UINT32( 0, Database::Uplink::pending( mark ) );
+
+    // Chega atrasado, com hora anterior à marca: a hora sozinha perderia esse registro
+    Database::insert( sample( BASE + 450 ) );
+    TEST_ASSERT_EQUAL_UINT32( 1, Database::Uplink::pending( mark ) );
+
+    sent.clear();
+    mark = drain( mark, sent );
+    TEST_ASSERT_EQUAL_UINT32( 1, sent.size() );
+    TEST_ASSERT_TRUE( sent[0] == BASE + 450 );
+    TEST_ASSERT_TRUE( mark.dateTime == BASE + 1800 );
+    Database::Uplink::advance( mark );
+
+    // A marca gravada volta igual
+    const auto stored = Database::Uplink::mark();
+    TEST_ASSERT_TRUE( stored.sequence == mark.sequence );
+    TEST_ASSERT_TRUE( stored.dateTime == mark.dateTime );
+}
+
+// Apagar os mais novos não faz a sequência voltar: o próximo registro ainda fica depois da marca
+static auto test_erase_keeps_sequence() -> void
+{
+    const auto mark = Database::Uplink::mark();
+    TEST_ASSERT_FALSE( Database::Uplink::regressed( mark ) );
+
+    Database::erase( BASE + 450, BASE + 1800 );
+    Database::insert( sample( BASE + 2700 ) );
+    TEST_ASSERT_FALSE( Database::Uplink::regressed( mark ) );
+    TEST_ASSERT_EQUAL_UINT32( 1, Database::Uplink::pending( mark ) );
+
+    auto sent = std::vector<std::time_t>{};
+    Database::Uplink::advance( drain( mark, sent ) );
+    TEST_ASSERT_EQUAL_UINT32( 1, sent.size() );
+    TEST_ASSERT_TRUE( sent[0] == BASE + 2700 );
+}
+
+// Banco restaurado de uma cópia antiga fica atrás da marca: recomeça pela hora do último enviado
+static auto test_regression_resends_newer_rows() -> void
+{
+    const auto current = Database::Uplink::mark();
+    const auto ahead = Database::Uplink::Mark{ current.sequence + 100, BASE + 900 };
+    TEST_ASSERT_TRUE( Database::Uplink::regressed( ahead ) );
+    TEST_ASSERT_EQUAL_UINT32( 0, Database::Uplink::pending( ahead ) );
+
+    auto mark = Database::Uplink::resync( ahead );
+    TEST_ASSERT_FALSE( Database::Uplink::regressed( mark ) );
+
+    auto sent = std::vector<std::time_t>{};
+    mark = drain( mark, sent );
+    TEST_ASSERT_EQUAL_UINT32( 1, sent.size() );
+    TEST_ASSERT_TRUE( sent[0] == BASE + 2700 );
+}
+
+static auto test_empty_batch() -> void
+{
+    const auto mark = Database::Uplink::mark();
+    auto sent = std::vector<std::time_t>{};
+
+    Database::Uplink::advance( drain( mark, sent ) );
+    sent.clear();
+    const auto after = drain( Database::Uplink::mark(), sent );
+    TEST_ASSERT_EQUAL_UINT32( 0, sent.size() );
+    TEST_ASSERT_EQUAL_UINT32( 0, Database::Uplink::pending( after ) );
+}
+
+auto main() -> int
+{
+    // Cada execução parte de um banco antigo, convertido pelo init
+    std::filesystem::create_directories( DATABASE_ROOT );
+    std::filesystem::remove( DATABASE_ROOT "/sensors_data.db" );
+
+    legacy();
+    Configuration::init();
+    Database::init();
+
+    UNITY_BEGIN();
+    RUN_TEST( test_legacy_mark_migrated );
+    RUN_TEST( test_late_rows_are_sent );
+    RUN_TEST( test_erase_keeps_sequence );
+    RUN_TEST( test_regression_resends_newer_rows );
+    RUN_TEST( test_empty_batch );
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,203 @@
+#include <Arduino.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sqlite3.h>
+#include <string>
+#include <unity.h>
+#include <vector>
+
+#include "Vfs.hpp"
+
+// Arquivos no disco do host: o VFS padrão faz o papel do cartão
+static const auto ROOT = std::filesystem::temp_directory_path() / "test_vfs";
+
+static auto onDisk( const std::string& path ) -> std::vector<uint8_t>
+{
+    auto stream = std::ifstream{path, std::ios::binary};
+    return std::vector<uint8_t>( std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{} );
+}
+
+class Handle
+{
+    private:
+        sqlite3_vfs* vfs;
+        std::vector<uint8_t> storage;
+    public:
+        const std::string path;
+        sqlite3_file* file;
+
+        Handle( const std::string& path ) : vfs{ sqlite3_vfs_find( Vfs::NAME ) }, storage( vfs->szOsFile ), path{ path }, file{ reinterpret_cast<sqlite3_file*>( storage.data() ) }
+        {
+            auto flags = 0;
+            TEST_ASSERT_EQUAL_INT( SQLITE_OK, this->vfs->xOpen( this->vfs, this->path.c_str(), this->file, SQLITE_OPEN_MAIN_DB | SQLITE_OPEN_CREATE | SQLITE_OPEN_READWRITE, &flags ) );
+        }
+
+        ~Handle()
+        {
+            this->file->pMethods->xClose( this->file );
+        }
+
+        auto size() -> sqlite3_int64
+        {
+            auto size = sqlite3_int64{0};
+            this->file->pMethods->xFileSize( this->file, &size );
+            return size;
+        }
+};
+
+static auto query( sqlite3* db, const char* sql ) -> int64_t
+{
+    sqlite3_stmt* res;
+    if ( sqlite3_prepare_v2( db, sql, -1, &res, nullptr ) != SQLITE_OK )
+    {
+        return -1;
+    }
+    const auto value = sqlite3_step( res ) == SQLITE_ROW ? sqlite3_column_int64( res, 0 ) : int64_t{-1};
+    sqlite3_finalize( res );
+    return value;
+}
+
+void setUp()
+{
+    std::filesystem::remove_all( ROOT );
+    std::filesystem::create_directories( ROOT );
+    Vfs::init();
+}
+
+void tearDown()
+{
+    std::filesystem::remove_all( ROOT );
+}
+
+// Escritas e leituras desalinhadas contra um modelo em memória; após cada sync o arquivo real tem de bater
+static auto test_random_io_matches_model() -> void
+{
+    auto random = std::mt19937{3};
+    auto model = std::vector<uint8_t>{};
+    const auto path = ( ROOT / "random.bin" ).string();
+
+    {
+        auto handle = Handle{path};
+        for ( auto step = 0; step < 4000; ++step )
+        {
+            const auto action = random() % 10;
+            if ( action < 5 )
+            {
+                const auto offset = random() % ( model.size() + 9000 );
+                const auto length = 1 + random() % ( random() % 4 == 0 ? 20000 : 700 );
+                auto data = std::vector<uint8_t>( length );
+                std::generate( data.begin(), data.end(), [&random] { return static_cast<uint8_t>( random() ); } );
+
+                TEST_ASSERT_EQUAL_INT( SQLITE_OK, handle.file->pMethods->xWrite( handle.file, data.data(), length, offset ) );
+                model.resize( std::max<std::size_t>( model.size(), offset + length ), 0 );
+                std::copy( data.begin(), data.end(), model.begin() + offset );
+            }
+            else if ( action < 8 and not model.empty() )
+            {
+                const auto offset = random() % model.size();
+                const auto length = 1 + random() % std::min<std::size_t>( model.size() - offset, 9000 );
+                auto data = std::vector<uint8_t>( length );
+
+                TEST_ASSERT_EQUAL_INT( SQLITE_OK, handle.file->pMethods->xRead( handle.file, data.data(), length, offset ) );
+                TEST_ASSERT_EQUAL_MEMORY( model.data() + offset, data.data(), length );
+            }
+            else if ( action < 9 )
+            {
+                TEST_ASSERT_EQUAL_INT( SQLITE_OK, handle.file->pMethods->xSync( handle.file, SQLITE_SYNC_NORMAL ) );
+                TEST_ASSERT_TRUE( onDisk( path ) == model );
+            }
+            else
+            {
+                const auto size = random() % ( model.size() + 1 );
+                TEST_ASSERT_EQUAL_INT( SQLITE_OK, handle.file->pMethods->xTruncate( handle.file, size ) );
+                model.resize( size );
+            }
+
+            TEST_ASSERT_EQUAL_INT64( static_cast<sqlite3_int64>( model.size() ), handle.size() );
+        }
+    }
+
+    // O close grava o que restou no bloco
+    TEST_ASSERT_TRUE( onDisk( path ) == model );
+}
+
+// Leitura além do fim devolve zeros e SHORT_READ, como o SQLite espera
+static auto test_short_read_past_end() -> void
+{
+    auto handle = Handle{( ROOT / "short.bin" ).string()};
+    const auto text = std::string( 1000, 'x' );
+    TEST_ASSERT_EQUAL_INT( SQLITE_OK, handle.file->pMethods->xWrite( handle.file, text.data(), text.size(), 0 ) );
+
+    auto data = std::vector<uint8_t>( 100, 0xff );
+    TEST_ASSERT_EQUAL_INT( SQLITE_IOERR_SHORT_READ, handle.file->pMethods->xRead( handle.file, data.data(), data.size(), 950 ) );
+    TEST_ASSERT_TRUE( std::all_of( data.begin(), data.begin() + 50, []( uint8_t c ) { return c == 'x'; } ) );
+    TEST_ASSERT_TRUE( std::all_of( data.begin() + 50, data.end(), []( uint8_t c ) { return c == 0; } ) );
+}
+
+// Banco aberto pelo Vfs::NAME como no firmware e relido pelo VFS padrão
+static auto test_database_round_trip() -> void
+{
+    const auto path = ( ROOT / "sensors.db" ).string();
+
+    sqlite3* db;
+    TEST_ASSERT_EQUAL_INT( SQLITE_OK, sqlite3_open_v2( path.c_str(), &db, SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE, Vfs::NAME ) );
+    TEST_ASSERT_EQUAL_INT( SQLITE_OK, sqlite3_exec( db, "CREATE TABLE DATA ( ID INTEGER PRIMARY KEY, VALUE INTEGER, TEXT BLOB )", nullptr, nullptr, nullptr ) );
+
+    auto random = std::mt19937{4};
+    auto expected = int64_t{0};
+    auto rows = int64_t{0};
+    for ( auto batch = 0; batch < 40; ++batch )
+    {
+        TEST_ASSERT_EQUAL_INT( SQLITE_OK, sqlite3_exec( db, "BEGIN", nullptr, nullptr, nullptr ) );
+        sqlite3_stmt* res;
+        sqlite3_prepare_v2( db, "INSERT INTO DATA ( VALUE, TEXT ) VALUES ( ?, zeroblob( ? ) )", -1, &res, nullptr );
+        for ( auto i = 0; i < 100; ++i )
+        {
+            const auto value = static_cast<int64_t>( random() % 1000 );
+            sqlite3_bind_int64( res, 1, value );
+            sqlite3_bind_int( res, 2, static_cast<int>( random() % 300 ) );
+            TEST_ASSERT_EQUAL_INT( SQLITE_DONE, sqlite3_step( res ) );
+            sqlite3_reset( res );
+            expected += value;
+            rows += 1;
+        }
+        sqlite3_finalize( res );
+        TEST_ASSERT_EQUAL_INT( SQLITE_OK, sqlite3_exec( db, "COMMIT", nullptr, nullptr, nullptr ) );
+
+        // Apaga um trecho de vez em quando para o arquivo encolher no VACUUM
+        if ( batch % 10 == 9 )
+        {
+            expected -= query( db, "SELECT SUM(VALUE) FROM DATA WHERE ID % 3 = 0" );
+            rows -= query( db, "SELECT COUNT(*) FROM DATA WHERE ID % 3 = 0" );
+            TEST_ASSERT_EQUAL_INT( SQLITE_OK, sqlite3_exec( db, "DELETE FROM DATA WHERE ID % 3 = 0; VACUUM", nullptr, nullptr, nullptr ) );
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT64( rows, query( db, "SELECT COUNT(*) FROM DATA" ) );
+    TEST_ASSERT_EQUAL_INT64( expected, query( db, "SELECT SUM(VALUE) FROM DATA" ) );
+    sqlite3_close( db );
+
+    TEST_ASSERT_EQUAL_INT( SQLITE_OK, sqlite3_open_v2( path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr ) );
+    sqlite3_stmt* res;
+    sqlite3_prepare_v2( db, "PRAGMA integrity_check", -1, &res, nullptr );
+    TEST_ASSERT_EQUAL_INT( SQLITE_ROW, sqlite3_step( res ) );
+    TEST_ASSERT_EQUAL_STRING( "ok", reinterpret_cast<const char*>( sqlite3_column_text( res, 0 ) ) );
+    sqlite3_finalize( res );
+    TEST_ASSERT_EQUAL_INT64( rows, query( db, "SELECT COUNT(*) FROM DATA" ) );
+    TEST_ASSERT_EQUAL_INT64( expected, query( db, "SELECT SUM(VALUE) FROM DATA" ) );
+    sqlite3_close( db );
+}
+
+auto main() -> int
+{
+    UNITY_BEGIN();
+    RUN_TEST( test_random_io_matches_model );
+    RUN_TEST( test_short_read_past_end );
+    RUN_TEST( test_database_round_trip );
+    return UNITY_END();
+}
\ No newline at end of file
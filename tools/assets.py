@@ -0,0 +1,269 @@
+#!/usr/bin/env python3
+"""Prepara as páginas de html/ para embutir no firmware.
+
+Minifica HTML, CSS e JS, opcionalmente junta o CSS e o JS locais de cada
+página num documento só, comprime tudo com gzip em html/dist/ e gera o
+include/Files.hpp com os símbolos e a tabela de rotas usada pelo
+configureServer.
+
+Roda antes de cada build pelo extra_scripts do platformio.ini, ou à mão:
+
+Uso: assets.py [--no-inline]
+"""
+
+import argparse
+import gzip
+import os
+import re
+import sys
+
+# No SCons não existe __file__, o diretório vem do env
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__))) if "__file__" in globals() else "."
+SOURCE = "html"
+DIST = "html/dist"
+HEADER = "include/Files.hpp"
+# Página servida em "/"
+INDEX = "infos.html"
+
+TYPES = {
+    ".html": "text/html",
+    ".js": "application/javascript",
+    ".css": "text/css",
+}
+
+
+def minify_js(text):
+    # Conservador: quebras de linha que podem encerrar comando ficam, o ASI continua valendo
+    out = []
+    i, n = 0, len(text)
+
+    def significant():
+        for c in reversed(out):
+            if not c.isspace():
+                return c
+        return ""
+
+    while i < n:
+        c = text[i]
+        if c in "'\"`":
+            end = i + 1
+            while end < n and text[end] != c:
+                end += 2 if text[end] == "\\" else 1
+            out.append(text[i:end + 1])
+            i = end + 1
+        elif text.startswith("//", i):
+            i = text.find("\n", i)
+            i = n if i < 0 else i
+        elif text.startswith("/*", i):
+            end = text.find("*/", i + 2)
+            end = n if end < 0 else end + 2
+            out.append("\n" if "\n" in text[i:end] else " ")
+            i = end
+        elif c == "/" and (significant() in "(,=:[!&|?{};+-*%<>~^" or "".join(out).rstrip().endswith("return")):
+            end, klass = i + 1, False
+            while end < n and (text[end] != "/" or klass):
+                if text[end] == "\\":
+                    end += 1
+                elif text[end] == "[":
+                    klass = True
+                elif text[end] == "]":
+                    klass = False
+                end += 1
+            out.append(text[i:end + 1])
+            i = end + 1
+        elif c.isspace():
+            end = i
+            while end < n and text[end].isspace():
+                end += 1
+            out.append("\n" if "\n" in text[i:end] else " ")
+            i = end
+        else:
+            out.append(c)
+            i += 1
+
+    def word(x):
+        return x.isalnum() or x in "_$\\" or ord(x) > 127
+
+    # Espaço só fica entre identificadores ou entre sinais que se fundiriam (a - -b)
+    result = []
+    for k, chunk in enumerate(out):
+        if chunk not in (" ", "\n"):
+            result.append(chunk)
+            continue
+        before = result[-1][-1] if result else ""
+        after = out[k + 1][0] if k + 1 < len(out) else ""
+        if not before or not after or before.isspace() or after.isspace():
+            continue
+        if chunk == "\n":
+            if before in "{;,([:" or after in ")]},;.":
+                continue
+            result.append("\n")
+        elif (word(before) and word(after)) or (before in "+-" and after == before):
+            result.append(" ")
+    return "".join(result).strip()
+
+
+def minify_css(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    text = re.sub(r"\s+", " ", text)
+    text = re.sub(r"\s*([{};,>])\s*", r"\1", text)
+    text = re.sub(r":\s+", ":", text)
+    return text.replace(";}", "}").strip()
+
+
+def minify_html(text):
+    text = re.sub(r"<!--(?!\[).*?-->", "", text, flags=re.S)
+    # Espaços entre tags viram um só, o navegador renderiza igual
+    parts = re.split(r"(<(?:pre|textarea|script|style)\b.*?</(?:pre|textarea|script|style)>)", text, flags=re.S | re.I)
+    for k in range(0, len(parts), 2):
+        parts[k] = re.sub(r"\s+", " ", parts[k])
+    return "".join(parts).strip()
+
+
+MINIFY = {".html": minify_html, ".js": minify_js, ".css": minify_css}
+
+
+def inline(page, sources, used):
+    def style(match):
+        name = match.group(1)
+        if name not in sources:
+            return match.group(0)
+        used.add(name)
+        return "<style>" + minify_css(sources[name]) + "</style>"
+
+    def script(match):
+        name = match.group(1)
+        # Bibliotecas grandes continuam separadas e em cache entre as páginas
+        if name not in sources or name.endswith(".min.js"):
+            return match.group(0)
+        used.add(name)
+        # "</script" dentro do código fecharia a tag antes da hora
+        code = re.sub(r"</(script)", r"<\\/\1", minify_js(sources[name]), flags=re.I)
+        return "<script>" + code + "</script>"
+
+    page = re.sub(r'<link\s+rel="stylesheet"[^>]*href="([^"/]+)"\s*/?>', style, page)
+    return re.sub(r'<script\s+src="([^"/]+)"\s*>\s*</script>', script, page)
+
+
+def symbol(name):
+    return re.sub(r"[^A-Za-z0-9]", "_", name)
+
+
+def build(inlined):
+    sources = {}
+    for name in sorted(os.listdir(os.path.join(ROOT, SOURCE))):
+        path = os.path.join(ROOT, SOURCE, name)
+        if os.path.isfile(path) and os.path.splitext(name)[1] in TYPES:
+            sources[name] = open(path, encoding="utf-8").read()
+
+    outputs, used = {}, set()
+    for name, text in sources.items():
+        if name.endswith(".html"):
+            page = inline(text, sources, used) if inlined else text
+            outputs[name] = minify_html(page)
+
+    for name, text in sources.items():
+        if name in outputs or name in used:
+            continue
+        # .min.js já vem minificado
+        outputs[name] = text if name.endswith(".min.js") else MINIFY[os.path.splitext(name)[1]](text)
+
+    os.makedirs(os.path.join(ROOT, DIST), exist_ok=True)
+    for stale in os.listdir(os.path.join(ROOT, DIST)):
+        if stale[:-3] not in outputs:
+            os.remove(os.path.join(ROOT, DIST, stale))
+
+    assets, packed = [], 0
+    raw = sum(len(text.encode("utf-8")) for text in sources.values())
+    for name, text in outputs.items():
+        # mtime fixo: mesmas fontes geram os mesmos bytes e não forçam relink
+        data = gzip.compress(text.encode("utf-8"), 9, mtime=0)
+        # Bibliotecas podem vir com .gz pronto (zopfli), melhor que o nível 9 do Python
+        ready = os.path.join(ROOT, SOURCE, name + ".gz")
+        if os.path.exists(ready):
+            prebuilt = open(ready, "rb").read()
+            if len(prebuilt) < len(data) and gzip.decompress(prebuilt).decode("utf-8") == text:
+                data = prebuilt
+        write(os.path.join(DIST, name + ".gz"), data)
+        packed += len(data)
+        assets.append(name)
+
+    write(HEADER, header(assets).encode("utf-8"))
+    print(f"assets: {len(assets)} arquivos, {raw} -> {packed} bytes ({packed / max(raw, 1):.1%})")
+    return [f"{DIST}/{name}.gz" for name in assets]
+
+
+def header(assets):
+    lines = [
+        "#pragma once",
+        "",
+        "// Gerado por tools/assets.py a partir de html/, não editar",
+        "",
+        "#include <array>",
+        "#include <cstdint>",
+        "",
+    ]
+    for name in assets:
+        base = symbol(name + ".gz")
+        label = symbol(f"{DIST}/{name}.gz")
+        lines.append(f'extern const uint8_t {base}_start[] asm( "_binary_{label}_start" );')
+        lines.append(f'extern const uint8_t {base}_end[] asm( "_binary_{label}_end" );')
+        lines.append("")
+
+    routes = [("/", INDEX)] if INDEX in assets else []
+    routes += [("/" + name, name) for name in assets]
+
+    lines += [
+        "namespace Files",
+        "{",
+        "    // Todos os arquivos vão comprimidos, servidos com Content-Encoding: gzip",
+        "    struct Asset",
+        "    {",
+        "        const char* path;",
+        "        const char* route;",
+        "        const char* type;",
+        "        const uint8_t* start;",
+        "        const uint8_t* end;",
+        "    };",
+        "",
+        f"    inline constexpr auto ASSETS = std::array<Asset, {len(routes)}>",
+        "    {{",
+    ]
+    for path, name in routes:
+        base = symbol(name + ".gz")
+        kind = TYPES[os.path.splitext(name)[1]]
+        lines.append(f'        {{"{path}", "GET {path}", "{kind}", {base}_start, {base}_end}},')
+    lines += [
+        "    }};",
+        "} // namespace Files",
+    ]
+    # Os arquivos do repositório terminam sem quebra de linha
+    return "\n".join(lines)
+
+
+def write(relative, data):
+    path = os.path.join(ROOT, relative)
+    if os.path.exists(path) and open(path, "rb").read() == data:
+        return
+    open(path, "wb").write(data)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--no-inline", action="store_true", help="mantém CSS e JS locais em arquivos separados")
+    args = parser.parse_args()
+    build(not args.no_inline)
+
+
+if __name__ == "__main__":
+    main()
+elif "Import" in globals():
+    # Dentro do PlatformIO (SCons), antes de compilar e embutir os arquivos
+    Import("env")  # noqa: F821
+
+    ROOT = env.subst("$PROJECT_DIR")  # noqa: F821
+    embedded = build(env.GetProjectOption("custom_assets_inline", "yes") != "no")  # noqa: F821
+    declared = env.GetProjectOption("board_build.embed_files", "").split()  # noqa: F821
+    if sorted(embedded) != sorted(declared):
+        sys.stderr.write("board_build.embed_files no platformio.ini deve listar:\n    " + "\n    ".join(embedded) + "\n")
+        env.Exit(1)  # noqa: F821
@@ -0,0 +1,154 @@
+#!/usr/bin/env python3
+"""Gera o patch diferencial aceito por POST /firmware.bin (formato WDP1).
+
+Uso: delta.py antigo.bin novo.bin saida.patch.gz [--raw]
+
+O antigo.bin precisa ser exatamente a imagem em execução na estação: o patch
+carrega o SHA-256 dela e é recusado se não bater.
+"""
+
+import argparse
+import gzip
+import hashlib
+import struct
+import sys
+
+MAGIC = b"WDP1"
+KEY = 8
+
+
+def leb128(value):
+    out = bytearray()
+    while True:
+        byte = value & 0x7F
+        value >>= 7
+        if value:
+            out.append(byte | 0x80)
+        else:
+            out.append(byte)
+            return bytes(out)
+
+
+def zigzag(value):
+    return (value << 1) ^ (value >> 63)
+
+
+def index(old):
+    table = {}
+    for n in range(len(old) - KEY + 1):
+        table.setdefault(old[n:n + KEY], n)
+    return table
+
+
+# Estende uma correspondência aproximada, como no bsdiff: ponteiros deslocados
+# mudam poucos bytes e ainda rendem diferenças quase todas zero
+def extend(old, new, o, n):
+    best, score, top = 0, 0, 0
+    length = 0
+    while o + length < len(old) and n + length < len(new):
+        score += 1 if old[o + length] == new[n + length] else -1
+        length += 1
+        if score > top:
+            top, best = score, length
+        elif score < top - 64:
+            break
+    return best
+
+
+def matches(old, new):
+    table = index(old)
+    n = 0
+    while n + KEY <= len(new):
+        o = table.get(new[n:n + KEY])
+        if o is None:
+            n += 1
+            continue
+        length = extend(old, new, o, n)
+        yield o, n, length
+        n += length
+
+
+def diff(old, new):
+    entries = []
+    position = 0
+    cursor = 0
+    pending = None
+    for o, n, length in matches(old, new):
+        if pending is None:
+            entries.append([0, new[:n], o - position])
+        else:
+            po, pn, plen = pending
+            entries.append([bytes((new[pn + i] - old[po + i]) & 0xFF for i in range(plen)), new[pn + plen:n], o - (po + plen)])
+        pending = (o, n, length)
+        cursor = n + length
+
+    if pending is None:
+        entries.append([0, new, 0])
+    else:
+        po, pn, plen = pending
+        entries.append([bytes((new[pn + i] - old[po + i]) & 0xFF for i in range(plen)), new[cursor:], 0])
+    return entries
+
+
+def apply(old, patch):
+    body = patch[4 + 4 + 64:]
+    size = struct.unpack("<I", patch[4:8])[0]
+    out = bytearray()
+    position = 0
+    offset = 0
+
+    def read():
+        nonlocal offset
+        value, shift = 0, 0
+        while True:
+            byte = body[offset]
+            offset += 1
+            value |= (byte & 0x7F) << shift
+            shift += 7
+            if not byte & 0x80:
+                return value
+
+    while len(out) < size:
+        d, e, s = read(), read(), read()
+        out += bytes((body[offset + i] + old[position + i]) & 0xFF for i in range(d))
+        offset += d
+        position += d
+        out += body[offset:offset + e]
+        offset += e
+        position += (s >> 1) ^ -(s & 1)
+    return bytes(out)
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument("old")
+    parser.add_argument("new")
+    parser.add_argument("patch")
+    parser.add_argument("--raw", action="store_true", help="sem gzip, enviar como .patch")
+    args = parser.parse_args()
+
+    old = open(args.old, "rb").read()
+    new = open(args.new, "rb").read()
+
+    # A partição em execução é identificada pelo SHA-256 anexado ao fim da imagem
+    running = hashlib.sha256(old[:-32]).digest()
+    if running != old[-32:]:
+        sys.exit("antigo.bin sem SHA-256 anexado, não é uma imagem de app do ESP32")
+
+    patch = bytearray(MAGIC + struct.pack("<I", len(new)) + running + hashlib.sha256(new).digest())
+    for d, e, s in diff(old, new):
+        d = d or b""
+        patch += leb128(len(d)) + leb128(len(e)) + leb128(zigzag(s))
+        patch += d + e
+
+    if apply(old, bytes(patch)) != new:
+        sys.exit("patch gerado não reproduz novo.bin")
+
+    # As diferenças são quase todas zero, o gzip é que reduz o tamanho de fato
+    data = bytes(patch) if args.raw else gzip.compress(bytes(patch), 9)
+    open(args.patch, "wb").write(data)
+    print(f"{len(new)} -> {len(data)} bytes ({len(data) / max(len(new), 1):.1%})")
+
+
+if __name__ == "__main__":
+    main()